@@ -0,0 +1 @@
+#include "../src/QtSnmpAgentConfig.h"
@@ -0,0 +1 @@
+#include "../src/QtSnmpAwait.h"
@@ -0,0 +1 @@
+#include "../src/QtSnmpFanOut.h"
@@ -0,0 +1 @@
+#include "../src/QtSnmpMetrics.h"
@@ -0,0 +1 @@
+#include "../src/QtSnmpPollScheduler.h"
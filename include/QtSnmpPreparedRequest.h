@@ -0,0 +1 @@
+#include "../src/QtSnmpPreparedRequest.h"
@@ -0,0 +1 @@
+#include "../src/QtSnmpRateEngine.h"
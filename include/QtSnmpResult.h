@@ -0,0 +1 @@
+#include "../src/QtSnmpResult.h"
@@ -4,11 +4,71 @@ CONFIG = ordered
 SUBDIRS *= qtsnmpclient
 qtsnmpclient.file = $${PWD}/qtsnmpclient.pro
 
+SUBDIRS *= qtsnmpsimulator
+qtsnmpsimulator.file = $${PWD}/qtsnmpsimulator.pro
+
+SUBDIRS *= snmp_simulator
+snmp_simulator.file = $${PWD}/snmp_simulator.pro
+
 SUBDIRS *= manual_test
 manual_test.file = $${PWD}/manual_test.pro
 
+SUBDIRS *= startup_benchmark
+startup_benchmark.file = $${PWD}/startup_benchmark.pro
+
+SUBDIRS *= fanout_benchmark
+fanout_benchmark.file = $${PWD}/fanout_benchmark.pro
+
 SUBDIRS *= tsta_qtsnmpclient_data
 tsta_qtsnmpclient_data.file = $${PWD}/tsta_qtsnmpclient_data.pro
 
 SUBDIRS *= tsta_qtsnmpclient_client
 tsta_qtsnmpclient_client.file = $${PWD}/tsta_qtsnmpclient_client.pro
+
+SUBDIRS *= tsta_qtsnmpclient_usm
+tsta_qtsnmpclient_usm.file = $${PWD}/tsta_qtsnmpclient_usm.pro
+
+SUBDIRS *= tsta_qtsnmpclient_simulator
+tsta_qtsnmpclient_simulator.file = $${PWD}/tsta_qtsnmpclient_simulator.pro
+
+SUBDIRS *= tsta_qtsnmpclient_arena
+tsta_qtsnmpclient_arena.file = $${PWD}/tsta_qtsnmpclient_arena.pro
+
+SUBDIRS *= tsta_qtsnmpclient_table
+tsta_qtsnmpclient_table.file = $${PWD}/tsta_qtsnmpclient_table.pro
+
+SUBDIRS *= tsta_qtsnmpclient_rate
+tsta_qtsnmpclient_rate.file = $${PWD}/tsta_qtsnmpclient_rate.pro
+
+SUBDIRS *= tsta_qtsnmpclient_wheel
+tsta_qtsnmpclient_wheel.file = $${PWD}/tsta_qtsnmpclient_wheel.pro
+
+SUBDIRS *= tsta_qtsnmpclient_await
+tsta_qtsnmpclient_await.file = $${PWD}/tsta_qtsnmpclient_await.pro
+
+SUBDIRS *= tsta_qtsnmpclient_walk
+tsta_qtsnmpclient_walk.file = $${PWD}/tsta_qtsnmpclient_walk.pro
+
+SUBDIRS *= tsta_qtsnmpclient_results
+tsta_qtsnmpclient_results.file = $${PWD}/tsta_qtsnmpclient_results.pro
+
+SUBDIRS *= tsta_qtsnmpclient_prepared
+tsta_qtsnmpclient_prepared.file = $${PWD}/tsta_qtsnmpclient_prepared.pro
+
+SUBDIRS *= tsta_qtsnmpclient_pacing
+tsta_qtsnmpclient_pacing.file = $${PWD}/tsta_qtsnmpclient_pacing.pro
+
+SUBDIRS *= tsta_qtsnmpclient_breaker
+tsta_qtsnmpclient_breaker.file = $${PWD}/tsta_qtsnmpclient_breaker.pro
+
+SUBDIRS *= tsta_qtsnmpclient_poll
+tsta_qtsnmpclient_poll.file = $${PWD}/tsta_qtsnmpclient_poll.pro
+
+SUBDIRS *= tsta_qtsnmpclient_subvalues
+tsta_qtsnmpclient_subvalues.file = $${PWD}/tsta_qtsnmpclient_subvalues.pro
+
+SUBDIRS *= tsta_qtsnmpclient_agents
+tsta_qtsnmpclient_agents.file = $${PWD}/tsta_qtsnmpclient_agents.pro
+
+SUBDIRS *= tsta_qtsnmpclient_set
+tsta_qtsnmpclient_set.file = $${PWD}/tsta_qtsnmpclient_set.pro
@@ -0,0 +1,10 @@
+include( $${PWD}/config.pri )
+TEMPLATE=app
+DESTDIR=$${BIN_PATH}
+QT = core network
+SOURCES_PATH = $${PWD}/../test/fanout_benchmark
+SOURCES *= $${SOURCES_PATH}/*.cpp
+INCLUDEPATH *= $${PWD}/../include
+INCLUDEPATH *= $${PWD}/../test/simulator
+LIBS *= -L$${LIB_PATH} -lqtsnmpsimulator -lqtsnmpclient
+PRE_TARGETDEPS *= $${LIB_PATH}/$${QMAKE_PREFIX_STATICLIB}qtsnmpsimulator.$${QMAKE_EXTENSION_STATICLIB}
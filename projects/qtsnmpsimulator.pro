@@ -0,0 +1,9 @@
+include( $${PWD}/config.pri )
+TEMPLATE=lib
+DESTDIR=$${LIB_PATH}
+CONFIG+=static
+QT = core network
+SOURCES_PATH = $${PWD}/../test/simulator
+HEADERS *= $${SOURCES_PATH}/*.h
+SOURCES *= $${SOURCES_PATH}/*.cpp
+INCLUDEPATH *= $${PWD}/../include
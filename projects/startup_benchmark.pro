@@ -0,0 +1,8 @@
+include( $${PWD}/config.pri )
+TEMPLATE=app
+DESTDIR=$${BIN_PATH}
+QT = core network
+SOURCES_PATH = $${PWD}/../test/startup_benchmark
+SOURCES *= $${SOURCES_PATH}/*.cpp
+INCLUDEPATH *= $${PWD}/../include
+LIBS *= -L$${LIB_PATH} -lqtsnmpclient
@@ -0,0 +1,10 @@
+include( $${PWD}/config.pri )
+TEMPLATE=app
+DESTDIR=$${BIN_PATH}
+QT = core network testlib
+SOURCES_PATH = $${PWD}/../test/auto
+SOURCES *= $${PWD}/../test/auto/tsta_qtsnmpclient_arena.cpp
+SOURCES *= $${PWD}/../src/BerArena.cpp
+INCLUDEPATH *= $${PWD}/../include
+INCLUDEPATH *= $${PWD}/../src
+LIBS *= -L$${LIB_PATH} -lqtsnmpclient
@@ -0,0 +1,10 @@
+include( $${PWD}/config.pri )
+TEMPLATE=app
+DESTDIR=$${BIN_PATH}
+QT = core network testlib
+SOURCES_PATH = $${PWD}/../test/auto
+SOURCES *= $${PWD}/../test/auto/tsta_qtsnmpclient_breaker.cpp
+INCLUDEPATH *= $${PWD}/../include
+INCLUDEPATH *= $${PWD}/../test/simulator
+LIBS *= -L$${LIB_PATH} -lqtsnmpsimulator -lqtsnmpclient
+PRE_TARGETDEPS *= $${LIB_PATH}/$${QMAKE_PREFIX_STATICLIB}qtsnmpsimulator.$${QMAKE_EXTENSION_STATICLIB}
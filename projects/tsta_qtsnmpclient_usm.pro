@@ -0,0 +1,12 @@
+include( $${PWD}/config.pri )
+TEMPLATE=app
+DESTDIR=$${BIN_PATH}
+QT = core network testlib
+SOURCES_PATH = $${PWD}/../test/auto
+SOURCES *= $${PWD}/../test/auto/tsta_qtsnmpclient_usm.cpp
+SOURCES *= $${PWD}/../src/Aes128.cpp
+SOURCES *= $${PWD}/../src/BerArena.cpp
+SOURCES *= $${PWD}/../src/Usm.cpp
+INCLUDEPATH *= $${PWD}/../include
+INCLUDEPATH *= $${PWD}/../src
+LIBS *= -L$${LIB_PATH} -lqtsnmpclient
@@ -1,5 +1,6 @@
 #include "AbstractJob.h"
 #include "Session.h"
+#include "Metrics.h"
 
 namespace qtsnmpclient {
 
@@ -7,6 +8,7 @@ AbstractJob::AbstractJob( Session*const session,
                           const qint32 id )
     : m_session( session )
     , m_id( id )
+    , m_enqueue_time( Metrics::now() )
 {
     Q_ASSERT( session );
     Q_ASSERT( m_id > 0 );
@@ -16,14 +18,26 @@ qint32 AbstractJob::id() const {
     return m_id;
 }
 
-void AbstractJob::processData( const QtSnmpDataList& values,
+qint64 AbstractJob::enqueueTime() const {
+    return m_enqueue_time;
+}
+
+void AbstractJob::setCallback( const QtSnmpCallback& callback ) {
+    m_callback = callback;
+}
+
+const QtSnmpCallback& AbstractJob::callback() const {
+    return m_callback;
+}
+
+void AbstractJob::processData( QtSnmpDataList&& values,
                                const QList< ErrorResponse >& error )
 {
     if ( ! error.isEmpty() ) {
         m_session->failWork();
         return;
     }
-    m_session->completeWork( values );
+    m_session->completeWork( std::move( values ) );
 }
 
 } // namespace qtsnmpclient
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "QtSnmpData.h"
+#include "QtSnmpResult.h"
 #include <memory>
 #include <queue>
 
@@ -16,23 +17,31 @@ protected:
 public:
     virtual ~AbstractJob() = default;
     qint32 id() const;
+    qint64 enqueueTime() const;
     virtual void start() = 0;
 
     struct ErrorResponse {
         QString request;
         QString status;
+        int code = 0; // the error status, zero for a report
         int index = 0;
     };
 
-    virtual void processData( const QtSnmpDataList&,
+    virtual void processData( QtSnmpDataList&&,
                               const QList< ErrorResponse >& );
     virtual QString description() const = 0;
 
+    // NOTE: the job with a callback delivers its result only to it
+    void setCallback( const QtSnmpCallback& );
+    const QtSnmpCallback& callback() const;
+
 protected:
     Session*const m_session;
 private:
     const qint32 m_id = 0;
     const qint32 m_padding = 0;
+    const qint64 m_enqueue_time = 0;
+    QtSnmpCallback m_callback;
 };
 
 typedef std::shared_ptr< AbstractJob > JobPointer;
@@ -0,0 +1,140 @@
+#include "Aes128.h"
+#include <string.h>
+
+namespace qtsnmpclient {
+
+namespace {
+    const quint8 sbox[ 256 ] = {
+        0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+        0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+        0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+        0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+        0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+        0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+        0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+        0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+        0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+        0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+        0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+        0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+        0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+        0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+        0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+        0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+    };
+
+    const quint8 round_constants[ 10 ] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36 };
+
+    inline quint8 xtime( const quint8 value ) {
+        return static_cast< quint8 >( ( value << 1 ) ^ ( ( value & 0x80 ) ? 0x1b : 0x00 ) );
+    }
+
+    inline void addRoundKey( quint8*const state, const quint8*const round_key ) {
+        for ( int i = 0; i < Aes128::BLOCK_SIZE; ++i ) {
+            state[ i ] ^= round_key[ i ];
+        }
+    }
+
+    inline void subBytesAndShiftRows( quint8*const state ) {
+        // NOTE: the state is stored column by column (state[ row + 4*column ])
+        quint8 tmp[ Aes128::BLOCK_SIZE ];
+        for ( int column = 0; column < 4; ++column ) {
+            for ( int row = 0; row < 4; ++row ) {
+                tmp[ row + 4*column ] = sbox[ state[ row + 4*( ( column + row ) % 4 ) ] ];
+            }
+        }
+        memcpy( state, tmp, sizeof( tmp ) );
+    }
+
+    inline void mixColumns( quint8*const state ) {
+        for ( int column = 0; column < 4; ++column ) {
+            quint8*const col = state + 4*column;
+            const quint8 a0 = col[ 0 ];
+            const quint8 a1 = col[ 1 ];
+            const quint8 a2 = col[ 2 ];
+            const quint8 a3 = col[ 3 ];
+            const quint8 all = a0 ^ a1 ^ a2 ^ a3;
+            col[ 0 ] = a0 ^ all ^ xtime( a0 ^ a1 );
+            col[ 1 ] = a1 ^ all ^ xtime( a1 ^ a2 );
+            col[ 2 ] = a2 ^ all ^ xtime( a2 ^ a3 );
+            col[ 3 ] = a3 ^ all ^ xtime( a3 ^ a0 );
+        }
+    }
+}
+
+void Aes128::setKey( const quint8*const key ) {
+    memcpy( m_round_keys, key, KEY_SIZE );
+    for ( int i = 4; i < 44; ++i ) {
+        quint8 word[ 4 ];
+        memcpy( word, m_round_keys + 4*( i - 1 ), 4 );
+        if ( 0 == i % 4 ) {
+            const quint8 first = word[ 0 ];
+            word[ 0 ] = sbox[ word[ 1 ] ] ^ round_constants[ i/4 - 1 ];
+            word[ 1 ] = sbox[ word[ 2 ] ];
+            word[ 2 ] = sbox[ word[ 3 ] ];
+            word[ 3 ] = sbox[ first ];
+        }
+        for ( int j = 0; j < 4; ++j ) {
+            m_round_keys[ 4*i + j ] = m_round_keys[ 4*( i - 4 ) + j ] ^ word[ j ];
+        }
+    }
+}
+
+void Aes128::encryptBlock( const quint8*const input,
+                           quint8*const output ) const
+{
+    quint8 state[ BLOCK_SIZE ];
+    memcpy( state, input, BLOCK_SIZE );
+    addRoundKey( state, m_round_keys );
+    for ( int round = 1; round < 10; ++round ) {
+        subBytesAndShiftRows( state );
+        mixColumns( state );
+        addRoundKey( state, m_round_keys + round*BLOCK_SIZE );
+    }
+    subBytesAndShiftRows( state );
+    addRoundKey( state, m_round_keys + 10*BLOCK_SIZE );
+    memcpy( output, state, BLOCK_SIZE );
+}
+
+void Aes128::cfbEncrypt( const quint8*const iv,
+                         const quint8*const input,
+                         const int size,
+                         quint8*const output ) const
+{
+    quint8 feedback[ BLOCK_SIZE ];
+    memcpy( feedback, iv, BLOCK_SIZE );
+    for ( int pos = 0; pos < size; pos += BLOCK_SIZE ) {
+        quint8 key_stream[ BLOCK_SIZE ];
+        encryptBlock( feedback, key_stream );
+        const int chunk = qMin( static_cast< int >( BLOCK_SIZE ), size - pos );
+        for ( int i = 0; i < chunk; ++i ) {
+            output[ pos + i ] = input[ pos + i ] ^ key_stream[ i ];
+        }
+        if ( BLOCK_SIZE == chunk ) {
+            memcpy( feedback, output + pos, BLOCK_SIZE );
+        }
+    }
+}
+
+void Aes128::cfbDecrypt( const quint8*const iv,
+                         const quint8*const input,
+                         const int size,
+                         quint8*const output ) const
+{
+    quint8 feedback[ BLOCK_SIZE ];
+    memcpy( feedback, iv, BLOCK_SIZE );
+    for ( int pos = 0; pos < size; pos += BLOCK_SIZE ) {
+        quint8 key_stream[ BLOCK_SIZE ];
+        encryptBlock( feedback, key_stream );
+        const int chunk = qMin( static_cast< int >( BLOCK_SIZE ), size - pos );
+        if ( BLOCK_SIZE == chunk ) {
+            // NOTE: the input and the output may be the same buffer
+            memcpy( feedback, input + pos, BLOCK_SIZE );
+        }
+        for ( int i = 0; i < chunk; ++i ) {
+            output[ pos + i ] = input[ pos + i ] ^ key_stream[ i ];
+        }
+    }
+}
+
+} // namespace qtsnmpclient
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QtGlobal>
+
+namespace qtsnmpclient {
+
+// NOTE: AES-128 is only needed for the USM privacy (RFC 3826 uses CFB-128 mode),
+//       so only the forward cipher is implemented: CFB decryption
+//       is done by the same forward cipher of the previous cipher block.
+class Aes128 {
+public:
+    enum {
+        BLOCK_SIZE = 16,
+        KEY_SIZE = 16,
+    };
+
+    Aes128() = default;
+
+    void setKey( const quint8*const key );
+    void encryptBlock( const quint8*const input,
+                       quint8*const output ) const;
+
+    void cfbEncrypt( const quint8*const iv,
+                     const quint8*const input,
+                     const int size,
+                     quint8*const output ) const;
+    void cfbDecrypt( const quint8*const iv,
+                     const quint8*const input,
+                     const int size,
+                     quint8*const output ) const;
+
+private:
+    quint8 m_round_keys[ 11 * BLOCK_SIZE ] = {};
+};
+
+} // namespace qtsnmpclient
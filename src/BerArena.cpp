@@ -0,0 +1,154 @@
+#include "BerArena.h"
+
+namespace qtsnmpclient {
+
+namespace {
+    const int max_depth = 16;
+    const int constructed_flag = 0x20;
+}
+
+bool BerArena::parse( const QByteArray& datagram ) {
+    m_datagram = datagram;
+    m_nodes.clear();
+    if ( m_datagram.isEmpty() || ( parseRange( 0, m_datagram.size(), 0 ) < 0 ) ) {
+        m_nodes.clear();
+        return false;
+    }
+    return true;
+}
+
+void BerArena::clear() {
+    m_datagram.clear();
+    m_nodes.clear();
+}
+
+int BerArena::first() const {
+    return m_nodes.empty() ? -1 : 0;
+}
+
+int BerArena::next( const int index ) const {
+    return node( index ).next_sibling;
+}
+
+int BerArena::firstChild( const int index ) const {
+    return node( index ).first_child;
+}
+
+int BerArena::child( const int index,
+                     const int child_index ) const
+{
+    int result = firstChild( index );
+    for ( int i = 0; ( i < child_index ) && ( result >= 0 ); ++i ) {
+        result = next( result );
+    }
+    return result;
+}
+
+int BerArena::childCount( const int index ) const {
+    return node( index ).child_count;
+}
+
+int BerArena::type( const int index ) const {
+    return node( index ).type;
+}
+
+int BerArena::size( const int index ) const {
+    return node( index ).length;
+}
+
+QByteArray BerArena::rawData( const int index ) const {
+    const auto& item = node( index );
+    return QByteArray::fromRawData( m_datagram.constData() + item.offset, item.length );
+}
+
+qint64 BerArena::integerValue( const int index ) const {
+    const auto& item = node( index );
+    if ( ( item.length <= 0 ) || ( item.length > 9 ) ) {
+        return 0;
+    }
+
+    const auto data = reinterpret_cast< const quint8* >( m_datagram.constData() + item.offset );
+    const bool is_signed = ( QtSnmpData::INTEGER_TYPE == item.type );
+    quint64 value = ( is_signed && ( data[ 0 ] & 0x80 ) ) ? ~quint64( 0 ) : 0;
+    for ( int i = 0; i < item.length; ++i ) {
+        value = ( value << 8 ) | data[ i ];
+    }
+    return static_cast< qint64 >( value );
+}
+
+QtSnmpData BerArena::toData( const int index ) const {
+    const auto& item = node( index );
+    return QtSnmpData( item.type, rawData( index ) );
+}
+
+int BerArena::parseRange( const int begin,
+                          const int end,
+                          const int depth )
+{
+    // NOTE: returns the index of the first node of the range or -1 on error
+    if ( depth > max_depth ) {
+        return -1;
+    }
+
+    const auto data = reinterpret_cast< const quint8* >( m_datagram.constData() );
+    int first_index = -1;
+    int previous_index = -1;
+    int pos = begin;
+    while ( pos < end ) {
+        if ( end - pos < 2 ) {
+            return -1;
+        }
+
+        Node item;
+        item.type = data[ pos++ ];
+        int length = data[ pos++ ];
+        if ( length & 0x80 ) {
+            const int size_length = length & 0x7F;
+            if ( ( 0 == size_length ) || ( size_length > 4 ) || ( end - pos < size_length ) ) {
+                return -1;
+            }
+            length = 0;
+            for ( int i = 0; i < size_length; ++i ) {
+                length = ( length << 8 ) | data[ pos++ ];
+            }
+            if ( length < 0 ) {
+                return -1;
+            }
+        }
+        if ( end - pos < length ) {
+            return -1;
+        }
+
+        item.offset = pos;
+        item.length = length;
+        const int index = static_cast< int >( m_nodes.size() );
+        m_nodes.push_back( item );
+        if ( previous_index >= 0 ) {
+            m_nodes[ static_cast< size_t >( previous_index ) ].next_sibling = index;
+        } else {
+            first_index = index;
+        }
+        previous_index = index;
+
+        if ( ( item.type & constructed_flag ) && ( length > 0 ) ) {
+            const int child_index = parseRange( pos, pos + length, depth + 1 );
+            if ( child_index < 0 ) {
+                return -1;
+            }
+            auto& parent = m_nodes[ static_cast< size_t >( index ) ];
+            parent.first_child = child_index;
+            for ( int i = child_index; i >= 0; i = m_nodes[ static_cast< size_t >( i ) ].next_sibling ) {
+                ++parent.child_count;
+            }
+        }
+        pos += length;
+    }
+    return first_index;
+}
+
+const BerArena::Node& BerArena::node( const int index ) const {
+    Q_ASSERT( ( index >= 0 ) && ( index < static_cast< int >( m_nodes.size() ) ) );
+    return m_nodes[ static_cast< size_t >( index ) ];
+}
+
+} // namespace qtsnmpclient
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "QtSnmpData.h"
+#include <QByteArray>
+#include <vector>
+
+namespace qtsnmpclient {
+
+// NOTE: A flat BER decoding of a datagram. The nodes refer to the bytes
+//       of the datagram and are stored in one vector, which keeps its capacity
+//       between datagrams, so the decoding itself allocates nothing
+//       (but the first datagrams). Only the values copied out by toData()
+//       get their own memory. The views returned by rawData() are valid
+//       till the next call of parse().
+class BerArena {
+    Q_DISABLE_COPY( BerArena )
+public:
+    BerArena() = default;
+
+    bool parse( const QByteArray& datagram );
+    void clear();
+
+    int first() const;
+    int next( const int node ) const;
+    int firstChild( const int node ) const;
+    int child( const int node,
+               const int index ) const;
+    int childCount( const int node ) const;
+
+    int type( const int node ) const;
+    int size( const int node ) const;
+    QByteArray rawData( const int node ) const;
+    qint64 integerValue( const int node ) const;
+    QtSnmpData toData( const int node ) const;
+
+private:
+    struct Node {
+        qint32 type = 0;
+        qint32 offset = 0;
+        qint32 length = 0;
+        qint32 first_child = -1;
+        qint32 next_sibling = -1;
+        qint32 child_count = 0;
+    };
+
+    int parseRange( const int begin,
+                    const int end,
+                    const int depth );
+    const Node& node( const int index ) const;
+
+private:
+    QByteArray m_datagram;
+    std::vector< Node > m_nodes;
+};
+
+} // namespace qtsnmpclient
@@ -0,0 +1,77 @@
+#include "CircuitBreaker.h"
+#include <QMutexLocker>
+
+namespace qtsnmpclient {
+
+int CircuitBreaker::threshold() const {
+    QMutexLocker locker( &m_mutex );
+    return m_threshold;
+}
+
+qint64 CircuitBreaker::probeInterval() const {
+    QMutexLocker locker( &m_mutex );
+    return m_probe_interval;
+}
+
+void CircuitBreaker::setThreshold( const int failures,
+                                   const qint64 probe_interval )
+{
+    QMutexLocker locker( &m_mutex );
+    m_threshold = qMax( 0, failures );
+    m_probe_interval = qBound( qint64( 1 ), probe_interval, qint64( MAX_PROBE_INTERVAL ) );
+    m_state = CLOSED;
+    m_failure_count = 0;
+    m_backoff = 0;
+}
+
+CircuitBreaker::State CircuitBreaker::state() const {
+    QMutexLocker locker( &m_mutex );
+    return m_state;
+}
+
+qint64 CircuitBreaker::nextProbeTime() const {
+    QMutexLocker locker( &m_mutex );
+    return m_next_probe_time;
+}
+
+void CircuitBreaker::addSuccess() {
+    QMutexLocker locker( &m_mutex );
+    m_state = CLOSED;
+    m_failure_count = 0;
+    m_backoff = 0;
+}
+
+bool CircuitBreaker::addFailure( const qint64 now ) {
+    QMutexLocker locker( &m_mutex );
+    if ( 0 == m_threshold ) {
+        return false;
+    }
+
+    switch ( m_state ) {
+    case CLOSED:
+        if ( ++m_failure_count < m_threshold ) {
+            return false;
+        }
+        m_backoff = m_probe_interval;
+        break;
+    case OPEN:
+        return false;
+    case HALF_OPEN:
+        m_backoff = qMin( 2 * m_backoff, qint64( MAX_PROBE_INTERVAL ) );
+        break;
+    }
+    m_state = OPEN;
+    m_next_probe_time = now + m_backoff;
+    return true;
+}
+
+bool CircuitBreaker::startProbe( const qint64 now ) {
+    QMutexLocker locker( &m_mutex );
+    if ( ( OPEN != m_state ) || ( now < m_next_probe_time ) ) {
+        return false;
+    }
+    m_state = HALF_OPEN;
+    return true;
+}
+
+} // namespace qtsnmpclient
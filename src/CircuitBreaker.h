@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QMutex>
+
+namespace qtsnmpclient {
+
+// NOTE: The state of an agent's availability. After 'threshold' requests
+//       in a row are timed out the circuit is open: the agent is taken
+//       as down and its requests are failed at once. Its recovery is
+//       checked by a single probe after the probe interval, which is
+//       doubled after every failed probe up to MAX_PROBE_INTERVAL.
+//       Any response closes the circuit. A zero threshold disables it.
+//       The time is given in microseconds of a steady clock
+//       (see Metrics::now()). The methods are thread safe.
+class CircuitBreaker {
+    Q_DISABLE_COPY( CircuitBreaker )
+public:
+    enum State {
+        CLOSED,
+        OPEN,
+        HALF_OPEN, // the probe is in progress
+    };
+
+    enum : qint64 {
+        MAX_PROBE_INTERVAL = 300000000, // 5 minutes
+    };
+
+    CircuitBreaker() = default;
+
+    int threshold() const;
+    qint64 probeInterval() const;
+    void setThreshold( const int failures,
+                       const qint64 probe_interval );
+
+    State state() const;
+    qint64 nextProbeTime() const;
+
+    void addSuccess();
+    // NOTE: returns true if the circuit has been opened by the failure
+    bool addFailure( const qint64 now );
+    bool startProbe( const qint64 now );
+
+private:
+    mutable QMutex m_mutex;
+    int m_threshold = 3;
+    qint64 m_probe_interval = 10000000;
+    State m_state = CLOSED;
+    int m_failure_count = 0;
+    qint64 m_backoff = 0;
+    qint64 m_next_probe_time = 0;
+};
+
+} // namespace qtsnmpclient
@@ -0,0 +1,106 @@
+#include "ConditionalWalkJob.h"
+#include "Session.h"
+
+namespace qtsnmpclient {
+
+namespace {
+    const QString sys_up_time = ".1.3.6.1.2.1.1.3.0";
+
+    bool isSysUpTime( const QString& oid ) {
+        return ( sys_up_time == oid ) || ( sys_up_time.mid( 1 ) == oid );
+    }
+
+    // NOTE: the exceptions of SNMPv2 in place of a value
+    bool isMissingValue( const QtSnmpData& value ) {
+        const int type = value.type();
+        return ( 0x80 == type ) || ( 0x81 == type ) || ( 0x82 == type );
+    }
+}
+
+ConditionalWalkJob::ConditionalWalkJob( Session*const session,
+                                        const qint32 id,
+                                        const QString& base_oid,
+                                        const QString& guard_oid )
+    : AbstractJob( session, id )
+    , m_base_oid( base_oid )
+    , m_guard_oid( guard_oid )
+    , m_cursor( base_oid.toLatin1() )
+{
+}
+
+void ConditionalWalkJob::start() {
+    m_session->sendRequestGetValues( QStringList( m_guard_oid ) );
+}
+
+void ConditionalWalkJob::processData( QtSnmpDataList&& values,
+                                      const QList< ErrorResponse >& error )
+{
+    if ( ! m_is_walking ) {
+        processGuard( std::move( values ), error );
+        return;
+    }
+
+    if ( 0 == values.size() ) {
+        m_session->completeWork( std::move( values ) );
+        return;
+    }
+
+    auto& value = values.front();
+    const auto step = ( 1 == values.size() ) ? m_cursor.step( value, Metrics::now() ) : WalkCursor::END;
+    switch ( step ) {
+    case WalkCursor::NEXT: {
+        const auto oid = value.address();
+        m_found.push_back( std::move( value ) );
+        m_session->sendRequestGetNextValue( oid );
+        return;
+    }
+    case WalkCursor::END:
+        break;
+    case WalkCursor::NOT_INCREASING:
+        m_session->failWork( QtSnmpResult::OidNotIncreasing );
+        return;
+    case WalkCursor::LIMIT_EXCEEDED:
+        m_session->failWork( QtSnmpResult::WalkLimitExceeded );
+        return;
+    }
+
+    const auto result = std::make_shared< const QtSnmpDataList >( std::move( m_found ) );
+    if ( m_is_guard_valid ) {
+        m_session->storeWalk( m_base_oid, m_guard_oid, m_guard, result );
+    }
+    m_session->completeWork( result );
+}
+
+void ConditionalWalkJob::processGuard( QtSnmpDataList&& values,
+                                       const QList< ErrorResponse >& error )
+{
+    // NOTE: without the guard the OID is walked every time
+    m_is_guard_valid = error.isEmpty() && ( 1 == values.size() ) && ! isMissingValue( values.front() );
+    if ( m_is_guard_valid ) {
+        m_guard = std::move( values.front() );
+        Session::CachedWalk cached;
+        if ( m_session->findWalk( m_base_oid, m_guard_oid, &cached ) && ! isChanged( cached.guard ) ) {
+            // NOTE: sysUpTime is compared with its last value
+            m_session->storeWalk( m_base_oid, m_guard_oid, m_guard, cached.values );
+            m_session->completeWork( cached.values );
+            return;
+        }
+    }
+
+    m_is_walking = true;
+    m_cursor.start( m_session->walkRowLimit(), qint64( m_session->walkTimeLimit() ) * 1000, Metrics::now() );
+    m_session->sendRequestGetNextValue( m_base_oid );
+}
+
+bool ConditionalWalkJob::isChanged( const QtSnmpData& cached ) const {
+    if ( isSysUpTime( m_guard_oid ) && ( cached.type() == m_guard.type() ) ) {
+        return m_guard.longLongValue() < cached.longLongValue();
+    }
+    return !( cached == m_guard );
+}
+
+QString ConditionalWalkJob::description() const {
+    return "requestSubValuesIfChanged: " + m_base_oid + " (" + m_guard_oid + ")";
+}
+
+} // namespace qtsnmpclient
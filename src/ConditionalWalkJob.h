@@ -0,0 +1,38 @@
+#pragma once
+
+#include "AbstractJob.h"
+#include "WalkCursor.h"
+
+namespace qtsnmpclient {
+
+// NOTE: Reads the guard OID and walks the base OID only if the guard has
+//       changed since the last walk, otherwise the cached result of that
+//       walk is delivered. A guard of sysUpTime changes only when it goes
+//       back, i.e. when the agent is restarted.
+class ConditionalWalkJob : public AbstractJob {
+    Q_DISABLE_COPY( ConditionalWalkJob )
+public:
+    explicit ConditionalWalkJob( Session*const,
+                                 const qint32 id,
+                                 const QString& base_oid,
+                                 const QString& guard_oid );
+    virtual void start() override final;
+    virtual void processData( QtSnmpDataList&&, const QList< ErrorResponse >& ) override final;
+    virtual QString description() const override final;
+
+private:
+    void processGuard( QtSnmpDataList&&,
+                       const QList< ErrorResponse >& );
+    bool isChanged( const QtSnmpData& cached ) const;
+
+private:
+    const QString m_base_oid;
+    const QString m_guard_oid;
+    QtSnmpData m_guard;
+    bool m_is_guard_valid = false;
+    bool m_is_walking = false;
+    WalkCursor m_cursor;
+    QtSnmpDataList m_found;
+};
+
+} // namespace qtsnmpclient
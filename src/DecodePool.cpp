@@ -0,0 +1,124 @@
+#include "DecodePool.h"
+#include "BerArena.h"
+#include <QCoreApplication>
+#include <QEvent>
+#include <QMutexLocker>
+#include <QRunnable>
+
+namespace qtsnmpclient {
+
+namespace {
+    class DecodeTask : public QRunnable {
+    public:
+        DecodeTask( const std::shared_ptr< DecodeInbox >& inbox,
+                    const quint64 sequence,
+                    const QByteArray& datagram )
+            : m_inbox( inbox )
+            , m_sequence( sequence )
+            , m_datagram( datagram )
+        {
+        }
+
+        void run() override {
+            // NOTE: the arenas keep their nodes for the next datagrams
+            thread_local BerArena arena;
+            thread_local BerArena scoped_pdu_arena;
+            ResponseDecoder::Result result;
+            ResponseDecoder::decode( m_datagram, &arena, &scoped_pdu_arena, nullptr, &result );
+            m_inbox->put( m_sequence, std::move( result ) );
+        }
+
+    private:
+        const std::shared_ptr< DecodeInbox > m_inbox;
+        const quint64 m_sequence;
+        const QByteArray m_datagram;
+    };
+}
+
+DecodeInbox::DecodeInbox( QObject*const receiver )
+    : m_receiver( receiver )
+{
+}
+
+int DecodeInbox::eventType() { // static
+    static const int type = QEvent::registerEventType();
+    return type;
+}
+
+quint64 DecodeInbox::addDatagram() {
+    QMutexLocker locker( &m_mutex );
+    return m_next_sequence++;
+}
+
+bool DecodeInbox::hasPending() const {
+    QMutexLocker locker( &m_mutex );
+    return m_next_delivery != m_next_sequence;
+}
+
+bool DecodeInbox::take( ResponseDecoder::Result*const result ) {
+    Q_ASSERT( result );
+    QMutexLocker locker( &m_mutex );
+    const auto iter = m_results.find( m_next_delivery );
+    if ( m_results.end() == iter ) {
+        m_is_posted = false;
+        return false;
+    }
+    *result = std::move( iter->second );
+    m_results.erase( iter );
+    ++m_next_delivery;
+    return true;
+}
+
+void DecodeInbox::detach() {
+    QMutexLocker locker( &m_mutex );
+    m_receiver = nullptr;
+    m_results.clear();
+}
+
+void DecodeInbox::put( const quint64 sequence,
+                       ResponseDecoder::Result&& result )
+{
+    QMutexLocker locker( &m_mutex );
+    if ( ! m_receiver ) {
+        return;
+    }
+    m_results.emplace( sequence, std::move( result ) );
+    // NOTE: the session is woken up only by the response it waits for
+    if ( ! m_is_posted && ( sequence == m_next_delivery ) ) {
+        m_is_posted = true;
+        QCoreApplication::postEvent( m_receiver, new QEvent( static_cast< QEvent::Type >( eventType() ) ) );
+    }
+}
+
+DecodePool& DecodePool::instance() { // static
+    static DecodePool pool;
+    return pool;
+}
+
+DecodePool::DecodePool() {
+    m_pool.setMaxThreadCount( 1 );
+}
+
+int DecodePool::threadCount() const {
+    return m_thread_count;
+}
+
+void DecodePool::setThreadCount( const int value ) {
+    // NOTE: the pool keeps a thread for the datagrams still being decoded
+    //       after it is disabled
+    m_thread_count.exchange( qMax( 0, value ) );
+    m_pool.setMaxThreadCount( qMax( 1, value ) );
+}
+
+bool DecodePool::isEnabled() const {
+    return m_thread_count > 0;
+}
+
+void DecodePool::decode( const std::shared_ptr< DecodeInbox >& inbox,
+                         const QByteArray& datagram )
+{
+    Q_ASSERT( inbox );
+    m_pool.start( new DecodeTask( inbox, inbox->addDatagram(), datagram ) );
+}
+
+} // namespace qtsnmpclient
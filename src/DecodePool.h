@@ -0,0 +1,69 @@
+#pragma once
+
+#include "ResponseDecoder.h"
+#include <QByteArray>
+#include <QMutex>
+#include <QObject>
+#include <QThreadPool>
+#include <atomic>
+#include <map>
+#include <memory>
+
+namespace qtsnmpclient {
+
+// NOTE: The decoded responses of a session. They are decoded by any thread
+//       of the pool in any order, but they are taken by the session in
+//       the order of the datagrams, so its jobs get them in that order too.
+//       The session is notified by an event, only one is posted at a time.
+class DecodeInbox {
+    Q_DISABLE_COPY( DecodeInbox )
+public:
+    explicit DecodeInbox( QObject*const receiver );
+
+    static int eventType();
+
+    // NOTE: called by the thread of the session
+    quint64 addDatagram();
+    bool hasPending() const;
+    bool take( ResponseDecoder::Result*const );
+    void detach();
+
+    // NOTE: called by the decoding thread
+    void put( const quint64 sequence,
+              ResponseDecoder::Result&& );
+
+private:
+    mutable QMutex m_mutex;
+    QObject* m_receiver = nullptr;
+    std::map< quint64, ResponseDecoder::Result > m_results;
+    quint64 m_next_sequence = 0;
+    quint64 m_next_delivery = 0;
+    bool m_is_posted = false;
+};
+
+// NOTE: The optional stage which decodes the responses of SNMPv1/v2c by
+//       a pool of threads, while the thread of the socket only reads
+//       the datagrams and routes them by the peeked request id. The messages
+//       of SNMPv3 are still decoded by the session, the USM state is its own.
+//       It is disabled by default (zero threads).
+class DecodePool {
+    Q_DISABLE_COPY( DecodePool )
+public:
+    static DecodePool& instance();
+
+    int threadCount() const;
+    void setThreadCount( const int );
+    bool isEnabled() const;
+
+    void decode( const std::shared_ptr< DecodeInbox >&,
+                 const QByteArray& datagram );
+
+private:
+    DecodePool();
+
+private:
+    QThreadPool m_pool;
+    std::atomic_int m_thread_count{ 0 };
+};
+
+} // namespace qtsnmpclient
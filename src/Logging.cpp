@@ -0,0 +1,31 @@
+#include "Logging.h"
+
+namespace qtsnmpclient {
+
+Q_LOGGING_CATEGORY( lcSession, "qtsnmpclient.session", QtWarningMsg )
+Q_LOGGING_CATEGORY( lcData, "qtsnmpclient.data", QtWarningMsg )
+
+bool LogThrottle::allow( const Kind kind,
+                         const qint64 now,
+                         int*const suppressed )
+{
+    Q_ASSERT( kind < KIND_COUNT );
+    Q_ASSERT( suppressed );
+    auto& state = m_states[ static_cast< size_t >( kind ) ];
+    if ( ( now - state.period_start ) >= PERIOD_USECS ) {
+        state.period_start = now;
+        state.message_count = 0;
+    }
+
+    if ( state.message_count >= MESSAGE_LIMIT ) {
+        ++state.suppressed_count;
+        return false;
+    }
+
+    ++state.message_count;
+    *suppressed = state.suppressed_count;
+    state.suppressed_count = 0;
+    return true;
+}
+
+} // namespace qtsnmpclient
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QLoggingCategory>
+#include <array>
+
+namespace qtsnmpclient {
+
+Q_DECLARE_LOGGING_CATEGORY( lcSession )
+Q_DECLARE_LOGGING_CATEGORY( lcData )
+
+// NOTE: Limits the count of similar diagnostic messages of one session.
+//       A message is reported only if there were less then MESSAGE_LIMIT
+//       messages of the same kind during the last PERIOD_USECS,
+//       the rest ones are only counted and the count is reported
+//       together with the next allowed message.
+class LogThrottle {
+public:
+    enum Kind {
+        INVALID_RESPONSE,
+        UNEXPECTED_REQUEST_ID,
+        ERROR_RESPONSE,
+        TIMEOUT,
+        DROPPED_WORK,
+        IO_ERROR,
+        KIND_COUNT
+    };
+
+    enum {
+        MESSAGE_LIMIT = 5,
+        PERIOD_USECS = 1000000,
+    };
+
+    // NOTE: returns false if the message has to be suppressed,
+    //       otherwise sets the count of the suppressed messages
+    //       (since the previous allowed one) and resets it.
+    bool allow( const Kind,
+                const qint64 now,
+                int*const suppressed );
+
+private:
+    struct State {
+        qint64 period_start = 0;
+        int message_count = 0;
+        int suppressed_count = 0;
+    };
+    std::array< State, KIND_COUNT > m_states;
+};
+
+} // namespace qtsnmpclient
@@ -0,0 +1,138 @@
+#include "Metrics.h"
+#include <QtAlgorithms>
+#include <chrono>
+
+namespace qtsnmpclient {
+
+Metrics::Metrics( Metrics*const parent )
+    : m_parent( parent )
+{
+    if ( m_parent ) {
+        QMutexLocker locker( &m_parent->m_children_mutex );
+        m_parent->m_children.insert( this );
+    }
+}
+
+Metrics::~Metrics() {
+    if ( ! m_parent ) {
+        return;
+    }
+
+    // NOTE: the counters are folded under the lock of the snapshots,
+    //       so a snapshot never counts them twice or misses them
+    QMutexLocker locker( &m_parent->m_children_mutex );
+    m_parent->m_children.remove( this );
+    for ( int i = 0; i < COUNTER_COUNT; ++i ) {
+        m_parent->m_counters[ i ].fetch_add( m_counters[ i ].load( std::memory_order_relaxed ),
+                                             std::memory_order_relaxed );
+    }
+    m_parent->m_rtt.merge( m_rtt );
+    m_parent->m_job_latency.merge( m_job_latency );
+}
+
+void Metrics::add( const Counter counter,
+                   const quint64 value )
+{
+    Q_ASSERT( counter < COUNTER_COUNT );
+    m_counters[ counter ].fetch_add( value, std::memory_order_relaxed );
+}
+
+void Metrics::addRtt( const qint64 usecs ) {
+    m_rtt.add( static_cast< quint64 >( qMax( qint64( 0 ), usecs ) ) );
+}
+
+void Metrics::addJobLatency( const qint64 usecs ) {
+    m_job_latency.add( static_cast< quint64 >( qMax( qint64( 0 ), usecs ) ) );
+}
+
+QtSnmpMetrics Metrics::snapshot() const {
+    quint64 counters[ COUNTER_COUNT ] = {};
+    QtSnmpMetrics result;
+    {
+        QMutexLocker locker( &m_children_mutex );
+        addTo( counters, &result.rtt, &result.job_latency );
+        for ( const auto child : m_children ) {
+            child->addTo( counters, &result.rtt, &result.job_latency );
+        }
+    }
+
+    result.pdus_sent = counters[ PDUS_SENT ];
+    result.pdus_received = counters[ PDUS_RECEIVED ];
+    result.retransmits = counters[ RETRANSMITS ];
+    result.timeouts = counters[ TIMEOUTS ];
+    result.drops = counters[ DROPS ];
+    result.too_big = counters[ TOO_BIG ];
+    result.unexpected_request_ids = counters[ UNEXPECTED_REQUEST_IDS ];
+    result.duplicates = counters[ DUPLICATES ];
+    result.bytes_sent = counters[ BYTES_SENT ];
+    result.bytes_received = counters[ BYTES_RECEIVED ];
+    result.suppressed_messages = counters[ SUPPRESSED_MESSAGES ];
+    result.paced_pdus = counters[ PACED_PDUS ];
+    result.rejects = counters[ REJECTS ];
+    result.aborted_walks = counters[ ABORTED_WALKS ];
+    return result;
+}
+
+void Metrics::addTo( quint64*const counters,
+                     QtSnmpHistogram*const rtt,
+                     QtSnmpHistogram*const job_latency ) const
+{
+    Q_ASSERT( counters && rtt && job_latency );
+    for ( int i = 0; i < COUNTER_COUNT; ++i ) {
+        counters[ i ] += m_counters[ i ].load( std::memory_order_relaxed );
+    }
+    m_rtt.addTo( rtt );
+    m_job_latency.addTo( job_latency );
+}
+
+Metrics& Metrics::global() { // static
+    static Metrics metrics;
+    return metrics;
+}
+
+qint64 Metrics::now() { // static
+    using namespace std::chrono;
+    return duration_cast< microseconds >( steady_clock::now().time_since_epoch() ).count();
+}
+
+void Metrics::Histogram::add( const quint64 value ) {
+    const int bucket = qMin( static_cast< int >( 64 - qCountLeadingZeroBits( value ) ),
+                             static_cast< int >( QtSnmpHistogram::BUCKET_COUNT - 1 ) );
+    m_buckets[ bucket ].fetch_add( 1, std::memory_order_relaxed );
+    m_count.fetch_add( 1, std::memory_order_relaxed );
+    m_sum.fetch_add( value, std::memory_order_relaxed );
+
+    quint64 max = m_max.load( std::memory_order_relaxed );
+    while ( ( value > max ) &&
+            ! m_max.compare_exchange_weak( max, value, std::memory_order_relaxed ) )
+    {
+    }
+}
+
+void Metrics::Histogram::merge( const Histogram& other ) {
+    for ( int i = 0; i < QtSnmpHistogram::BUCKET_COUNT; ++i ) {
+        m_buckets[ i ].fetch_add( other.m_buckets[ i ].load( std::memory_order_relaxed ),
+                                  std::memory_order_relaxed );
+    }
+    m_count.fetch_add( other.m_count.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+    m_sum.fetch_add( other.m_sum.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+
+    const quint64 value = other.m_max.load( std::memory_order_relaxed );
+    quint64 max = m_max.load( std::memory_order_relaxed );
+    while ( ( value > max ) &&
+            ! m_max.compare_exchange_weak( max, value, std::memory_order_relaxed ) )
+    {
+    }
+}
+
+void Metrics::Histogram::addTo( QtSnmpHistogram*const histogram ) const {
+    Q_ASSERT( histogram );
+    histogram->count += m_count.load( std::memory_order_relaxed );
+    histogram->sum += m_sum.load( std::memory_order_relaxed );
+    histogram->max = qMax( histogram->max, m_max.load( std::memory_order_relaxed ) );
+    for ( int i = 0; i < QtSnmpHistogram::BUCKET_COUNT; ++i ) {
+        histogram->buckets[ static_cast< size_t >( i ) ] += m_buckets[ i ].load( std::memory_order_relaxed );
+    }
+}
+
+} // namespace qtsnmpclient
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "QtSnmpMetrics.h"
+#include <QMutex>
+#include <QSet>
+#include <atomic>
+
+namespace qtsnmpclient {
+
+// NOTE: The counters are updated by relaxed atomic operations only,
+//       so they may be left enabled in production and may be read
+//       from any thread at any time. A session updates only its own
+//       counters; the snapshot of the parent (global) metrics sums
+//       the live children, and a child is folded into its parent
+//       when it is destroyed.
+class Metrics {
+    Q_DISABLE_COPY( Metrics )
+public:
+    enum Counter {
+        PDUS_SENT,
+        PDUS_RECEIVED,
+        RETRANSMITS,
+        TIMEOUTS,
+        DROPS,
+        TOO_BIG,
+        UNEXPECTED_REQUEST_IDS,
+        DUPLICATES,
+        BYTES_SENT,
+        BYTES_RECEIVED,
+        SUPPRESSED_MESSAGES,
+        PACED_PDUS,
+        REJECTS,
+        ABORTED_WALKS,
+        COUNTER_COUNT
+    };
+
+    explicit Metrics( Metrics*const parent = nullptr );
+    ~Metrics();
+
+    void add( const Counter,
+              const quint64 value = 1 );
+    void addRtt( const qint64 usecs );
+    void addJobLatency( const qint64 usecs );
+    QtSnmpMetrics snapshot() const;
+
+    static Metrics& global();
+    static qint64 now();
+
+private:
+    class Histogram {
+    public:
+        void add( const quint64 value );
+        void merge( const Histogram& );
+        void addTo( QtSnmpHistogram*const ) const;
+    private:
+        std::atomic< quint64 > m_count{ 0 };
+        std::atomic< quint64 > m_sum{ 0 };
+        std::atomic< quint64 > m_max{ 0 };
+        std::atomic< quint64 > m_buckets[ QtSnmpHistogram::BUCKET_COUNT ] = {};
+    };
+
+    void addTo( quint64*const counters,
+                QtSnmpHistogram*const rtt,
+                QtSnmpHistogram*const job_latency ) const;
+
+private:
+    Metrics*const m_parent;
+    mutable QMutex m_children_mutex;
+    QSet< const Metrics* > m_children;
+    std::atomic< quint64 > m_counters[ COUNTER_COUNT ] = {};
+    Histogram m_rtt;
+    Histogram m_job_latency;
+};
+
+} // namespace qtsnmpclient
@@ -0,0 +1,207 @@
+#include "QtSnmpAgentConfig.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+
+namespace {
+
+    bool parseVersion( const QString& text,
+                       int*const version )
+    {
+        const auto value = text.trimmed().toLower();
+        if ( ( "1" == value ) || ( "v1" == value ) ) {
+            *version = 0;
+        } else if ( ( "2" == value ) || ( "2c" == value ) || ( "v2c" == value ) ) {
+            *version = 1;
+        } else if ( ( "3" == value ) || ( "v3" == value ) ) {
+            *version = 3;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    bool parseSecurityLevel( const QString& text,
+                             int*const level )
+    {
+        const auto value = text.trimmed().toLower();
+        if ( "noauthnopriv" == value ) {
+            *level = 0;
+        } else if ( "authnopriv" == value ) {
+            *level = 1;
+        } else if ( "authpriv" == value ) {
+            *level = 3;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    bool readInt( const QVariantMap& map,
+                  const QString& key,
+                  const int min_value,
+                  int*const value,
+                  QString*const error )
+    {
+        const auto iter = map.constFind( key );
+        if ( map.constEnd() == iter ) {
+            return true;
+        }
+        bool ok = false;
+        const int result = iter.value().toInt( &ok );
+        if ( ! ok || ( result < min_value ) ) {
+            *error = QString( "invalid %1 \"%2\"" ).arg( key, iter.value().toString() );
+            return false;
+        }
+        *value = result;
+        return true;
+    }
+
+} // anonymous namespace
+
+bool QtSnmpAgentConfig::isValid() const {
+    bool ok = ! address.isNull();
+    ok = ok && ( QHostAddress( QHostAddress::Any ) != address );
+    ok = ok && ( QHostAddress( QHostAddress::AnyIPv4 ) != address );
+    ok = ok && ( QHostAddress( QHostAddress::AnyIPv6 ) != address );
+    ok = ok && ( 0 != port );
+    return ok;
+}
+
+bool QtSnmpAgentConfig::fromVariantMap( const QVariantMap& map,
+                                        QtSnmpAgentConfig*const config,
+                                        QString*const error ) // static
+{
+    Q_ASSERT( config );
+    QString reason;
+    QtSnmpAgentConfig result;
+
+    // NOTE: setAddress accepts numeric addresses only, it never does a lookup
+    const auto address = map.value( "address" ).toString().trimmed();
+    if ( ! result.address.setAddress( address ) ) {
+        reason = QString( "invalid address \"%1\" (host names are not resolved)" ).arg( address );
+    }
+
+    int port = result.port;
+    if ( reason.isEmpty() && readInt( map, "port", 1, &port, &reason ) ) {
+        if ( port > 0xFFFF ) {
+            reason = QString( "invalid port \"%1\"" ).arg( port );
+        }
+        result.port = static_cast< quint16 >( port );
+    }
+
+    if ( reason.isEmpty() && map.contains( "version" ) ) {
+        const auto version = map.value( "version" ).toString();
+        if ( ! parseVersion( version, &result.protocol_version ) ) {
+            reason = QString( "invalid version \"%1\"" ).arg( version );
+        }
+    }
+
+    if ( reason.isEmpty() && map.contains( "security" ) ) {
+        const auto level = map.value( "security" ).toString();
+        if ( ! parseSecurityLevel( level, &result.security_level ) ) {
+            reason = QString( "invalid security \"%1\"" ).arg( level );
+        }
+    }
+
+    if ( reason.isEmpty() ) {
+        readInt( map, "timeout", 1, &result.response_timeout, &reason );
+    }
+    if ( reason.isEmpty() ) {
+        readInt( map, "get_limit", 0, &result.get_request_limit, &reason );
+    }
+    if ( reason.isEmpty() ) {
+        readInt( map, "set_limit", 0, &result.set_request_limit, &reason );
+    }
+    if ( reason.isEmpty() ) {
+        readInt( map, "rate_burst", 1, &result.rate_burst, &reason );
+    }
+    if ( reason.isEmpty() && map.contains( "rate_limit" ) ) {
+        bool ok = false;
+        result.rate_limit = map.value( "rate_limit" ).toDouble( &ok );
+        if ( ! ok || ( result.rate_limit < 0 ) ) {
+            reason = QString( "invalid rate_limit \"%1\"" ).arg( map.value( "rate_limit" ).toString() );
+        }
+    }
+
+    if ( ! reason.isEmpty() ) {
+        if ( error ) {
+            *error = reason;
+        }
+        return false;
+    }
+
+    if ( map.contains( "community" ) ) {
+        result.community = map.value( "community" ).toString().toLatin1();
+    }
+    result.user_name = map.value( "user" ).toString().toUtf8();
+    result.auth_password = map.value( "auth_password" ).toString().toUtf8();
+    result.priv_password = map.value( "priv_password" ).toString().toUtf8();
+    *config = result;
+    return true;
+}
+
+QList< QtSnmpAgentConfig > QtSnmpAgentConfig::fromVariantList( const QVariantList& list,
+                                                               QStringList*const errors ) // static
+{
+    QList< QtSnmpAgentConfig > result;
+    result.reserve( list.size() );
+    for ( int i = 0; i < list.size(); ++i ) {
+        QtSnmpAgentConfig config;
+        QString error;
+        if ( fromVariantMap( list.at( i ).toMap(), &config, &error ) ) {
+            result << config;
+        } else if ( errors ) {
+            *errors << QString( "#%1: %2" ).arg( i ).arg( error );
+        }
+    }
+    return result;
+}
+
+QList< QtSnmpAgentConfig > QtSnmpAgentConfig::fromJson( const QByteArray& json,
+                                                        QStringList*const errors ) // static
+{
+    QJsonParseError parse_error;
+    const auto document = QJsonDocument::fromJson( json, &parse_error );
+    if ( QJsonParseError::NoError != parse_error.error ) {
+        if ( errors ) {
+            *errors << QString( "offset %1: %2" ).arg( parse_error.offset ).arg( parse_error.errorString() );
+        }
+        return {};
+    }
+    if ( ! document.isArray() ) {
+        if ( errors ) {
+            *errors << QString( "an array of agents is expected" );
+        }
+        return {};
+    }
+
+    const auto array = document.array();
+    QList< QtSnmpAgentConfig > result;
+    result.reserve( array.size() );
+    for ( int i = 0; i < array.size(); ++i ) {
+        QtSnmpAgentConfig config;
+        QString error;
+        if ( fromVariantMap( array.at( i ).toObject().toVariantMap(), &config, &error ) ) {
+            result << config;
+        } else if ( errors ) {
+            *errors << QString( "#%1: %2" ).arg( i ).arg( error );
+        }
+    }
+    return result;
+}
+
+QList< QtSnmpAgentConfig > QtSnmpAgentConfig::loadFile( const QString& file_name,
+                                                        QStringList*const errors ) // static
+{
+    QFile file( file_name );
+    if ( ! file.open( QIODevice::ReadOnly ) ) {
+        if ( errors ) {
+            *errors << file.errorString();
+        }
+        return {};
+    }
+    return fromJson( file.readAll(), errors );
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QList>
+#include <QMetaType>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include "win_export.h"
+
+// NOTE: The settings of one agent for configuring a client in one call.
+//       The address has to be numeric, the host names are never resolved,
+//       so loading thousands of agents does not wait for DNS.
+//       An agent is described by a JSON object (or a variant map) with
+//       the keys:
+//         "address" (required), "port",
+//         "version" ("1", "2c", "3" or "v1", "v2c", "v3"),
+//         "community", "user",
+//         "security" ("noAuthNoPriv", "authNoPriv", "authPriv"),
+//         "auth_password", "priv_password",
+//         "timeout" (ms), "get_limit", "set_limit", "rate_limit" (PDU/s),
+//         "rate_burst".
+//       The missing keys get the defaults of QtSnmpClient.
+struct WIN_EXPORT QtSnmpAgentConfig {
+    QHostAddress address;
+    quint16 port = 161;
+    int protocol_version = 1; // QtSnmpClient::SNMPv2c
+    QByteArray community = "public";
+    QByteArray user_name;
+    int security_level = 0; // QtSnmpClient::NoAuthNoPriv
+    QByteArray auth_password;
+    QByteArray priv_password;
+    int response_timeout = 10000;
+    int get_request_limit = 0;
+    int set_request_limit = 0;
+    double rate_limit = 0;
+    int rate_burst = 1;
+
+    bool isValid() const;
+
+    static bool fromVariantMap( const QVariantMap&,
+                                QtSnmpAgentConfig*const,
+                                QString*const error = nullptr );
+
+    // NOTE: the invalid items are skipped and reported by the errors
+    //       as "#<index>: <reason>"
+    static QList< QtSnmpAgentConfig > fromVariantList( const QVariantList&,
+                                                       QStringList*const errors = nullptr );
+
+    // NOTE: reads a JSON array of agents
+    static QList< QtSnmpAgentConfig > fromJson( const QByteArray&,
+                                                QStringList*const errors = nullptr );
+    static QList< QtSnmpAgentConfig > loadFile( const QString& file_name,
+                                                QStringList*const errors = nullptr );
+};
+
+typedef QList< QtSnmpAgentConfig > QtSnmpAgentConfigList;
+
+Q_DECLARE_METATYPE( QtSnmpAgentConfig )
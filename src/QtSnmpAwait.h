@@ -0,0 +1,194 @@
+#pragma once
+
+#include "QtSnmpClient.h"
+
+// NOTE: The awaitable operations of QtSnmpClient for C++20 coroutines.
+//       The header is compiled only with the coroutine support of
+//       the compiler, the library itself does not need it.
+//
+//       QtSnmpTask collect( QtSnmpClient* client ) {
+//           const auto count = co_await QtSnmpOperation::requestValue( client, ifNumber );
+//           const auto results = co_await whenAll( QtSnmpOperation::requestTable( client, ifEntry ),
+//                                                  QtSnmpOperation::requestTable( client, ifXEntry ) );
+//           ...
+//       }
+//
+//       A coroutine is resumed in the thread of the client by its event
+//       loop, so it has to be started in that thread. A coroutine waiting
+//       for a client which is deleted is never resumed.
+#if defined( __cpp_impl_coroutine )
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <vector>
+
+// NOTE: A coroutine which is started at once and destroys itself
+//       when finished, nobody waits for it.
+class QtSnmpTask {
+public:
+    struct promise_type {
+        QtSnmpTask get_return_object() noexcept {
+            return QtSnmpTask();
+        }
+        std::suspend_never initial_suspend() const noexcept {
+            return {};
+        }
+        std::suspend_never final_suspend() const noexcept {
+            return {};
+        }
+        void return_void() const noexcept {
+        }
+        void unhandled_exception() const noexcept {
+            std::terminate();
+        }
+    };
+};
+
+// NOTE: One request, it is sent when it is awaited.
+class QtSnmpOperation {
+public:
+    typedef std::function< qint32( const QtSnmpCallback& ) > Starter;
+
+    explicit QtSnmpOperation( const Starter& starter )
+        : m_starter( starter )
+    {
+    }
+
+    QtSnmpOperation( QtSnmpOperation&& other ) noexcept
+        : m_starter( std::move( other.m_starter ) )
+    {
+    }
+
+    static QtSnmpOperation requestValue( QtSnmpClient*const client,
+                                         const QString& oid )
+    {
+        return requestValues( client, QStringList( oid ) );
+    }
+
+    static QtSnmpOperation requestValues( QtSnmpClient*const client,
+                                          const QStringList& oid_list )
+    {
+        return QtSnmpOperation( [client, oid_list]( const QtSnmpCallback& callback ) {
+            return client->requestValues( oid_list, nullptr, callback );
+        } );
+    }
+
+    static QtSnmpOperation requestSubValues( QtSnmpClient*const client,
+                                             const QString& oid )
+    {
+        return QtSnmpOperation( [client, oid]( const QtSnmpCallback& callback ) {
+            return client->requestSubValues( oid, nullptr, callback );
+        } );
+    }
+
+    static QtSnmpOperation requestTable( QtSnmpClient*const client,
+                                         const QString& entry_oid )
+    {
+        return QtSnmpOperation( [client, entry_oid]( const QtSnmpCallback& callback ) {
+            return client->requestTable( entry_oid, nullptr, callback );
+        } );
+    }
+
+    static QtSnmpOperation setValue( QtSnmpClient*const client,
+                                     const QByteArray& community,
+                                     const QString& oid,
+                                     const int type,
+                                     const QByteArray& value )
+    {
+        return QtSnmpOperation( [=]( const QtSnmpCallback& callback ) {
+            return client->setValue( community, oid, type, value, nullptr, callback );
+        } );
+    }
+
+    // NOTE: the callback may be called before start() returns
+    //       (e.g. the request is dropped by the full queue)
+    void start( const QtSnmpCallback& callback ) {
+        Q_ASSERT( m_starter );
+        m_starter( callback );
+    }
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    // NOTE: the operation lives in the frame of the suspended coroutine,
+    //       so the callback refers to it without any other allocation;
+    //       the one of the callback and the suspension which is the second
+    //       continues the coroutine
+    bool await_suspend( std::coroutine_handle<> handle ) {
+        m_handle = handle;
+        start( [this]( const QtSnmpResult& result ) {
+            m_result = result;
+            if ( m_is_done.exchange( true ) ) {
+                m_handle.resume();
+            }
+        } );
+        return ! m_is_done.exchange( true );
+    }
+
+    QtSnmpResult await_resume() {
+        return std::move( m_result );
+    }
+
+private:
+    Starter m_starter;
+    std::coroutine_handle<> m_handle;
+    std::atomic_bool m_is_done{ false };
+    QtSnmpResult m_result;
+};
+
+// NOTE: Sends all the requests at once and continues when all of them
+//       are finished, the results are in the order of the operations.
+class QtSnmpWhenAll {
+public:
+    explicit QtSnmpWhenAll( std::vector< QtSnmpOperation >&& operations )
+        : m_operations( std::move( operations ) )
+        , m_results( m_operations.size() )
+    {
+    }
+
+    bool await_ready() const noexcept {
+        return m_operations.empty();
+    }
+
+    bool await_suspend( std::coroutine_handle<> handle ) {
+        m_handle = handle;
+        // NOTE: the extra count is released after all the requests are sent
+        m_pending = static_cast< int >( m_operations.size() ) + 1;
+        for ( size_t i = 0; i < m_operations.size(); ++i ) {
+            m_operations[ i ].start( [this, i]( const QtSnmpResult& result ) {
+                m_results[ i ] = result;
+                if ( 1 == m_pending.fetch_sub( 1 ) ) {
+                    m_handle.resume();
+                }
+            } );
+        }
+        return 1 != m_pending.fetch_sub( 1 );
+    }
+
+    std::vector< QtSnmpResult > await_resume() {
+        return std::move( m_results );
+    }
+
+private:
+    std::vector< QtSnmpOperation > m_operations;
+    std::vector< QtSnmpResult > m_results;
+    std::coroutine_handle<> m_handle;
+    std::atomic_int m_pending{ 0 };
+};
+
+inline QtSnmpWhenAll whenAll( std::vector< QtSnmpOperation >&& operations ) {
+    return QtSnmpWhenAll( std::move( operations ) );
+}
+
+template< class... Operations >
+QtSnmpWhenAll whenAll( Operations&&... operations ) {
+    std::vector< QtSnmpOperation > list;
+    list.reserve( sizeof...( operations ) );
+    ( list.push_back( std::move( operations ) ), ... );
+    return QtSnmpWhenAll( std::move( list ) );
+}
+
+#endif // __cpp_impl_coroutine
@@ -1,9 +1,33 @@
 #include "QtSnmpClient.h"
 #include "Session.h"
+#include "Logging.h"
+#include "TokenBucket.h"
+#include "DecodePool.h"
+#include <QMetaMethod>
+#include <QPointer>
 #include <QThread>
 
 Q_DECLARE_METATYPE( QHostAddress )
 
+namespace {
+
+    QtSnmpCallback guardedCallback( QObject*const context,
+                                    const QtSnmpCallback& callback )
+    {
+        Q_ASSERT( callback );
+        if ( ! context ) {
+            return callback;
+        }
+        const QPointer< QObject > guard( context );
+        return [guard, callback]( const QtSnmpResult& result ) {
+            if ( ! guard.isNull() ) {
+                callback( result );
+            }
+        };
+    }
+
+} // anonymous namespace
+
 QtSnmpClient::QtSnmpClient( QObject*const parent )
     : QObject( parent )
     , m_session( new qtsnmpclient::Session( this ) )
@@ -11,13 +35,24 @@ QtSnmpClient::QtSnmpClient( QObject*const parent )
     static std::atomic_bool once{true};
     if ( once.exchange( false ) ) {
         qRegisterMetaType< QtSnmpDataList >();
+        qRegisterMetaType< QtSnmpDataListPtr >();
+        qRegisterMetaType< QtSnmpTablePtr >();
+        qRegisterMetaType< QtSnmpMetrics >();
+        qRegisterMetaType< QtSnmpAgentConfig >();
+        qRegisterMetaType< QtSnmpPreparedRequest >();
     }
 
-    connect( m_session, SIGNAL(responseReceived(qint32,QtSnmpDataList)),
-             this, SIGNAL(responseReceived(qint32,QtSnmpDataList)) );
+    connect( m_session, SIGNAL(responseReceived(qint32,QtSnmpDataListPtr)),
+             this, SLOT(onResponseReceived(qint32,QtSnmpDataListPtr)) );
+
+    connect( m_session, SIGNAL(tableReceived(qint32,QtSnmpTablePtr)),
+             this, SIGNAL(tableReceived(qint32,QtSnmpTablePtr)) );
 
     connect( m_session, SIGNAL(requestFailed(qint32)),
              this, SIGNAL(requestFailed(qint32)) );
+
+    connect( m_session, SIGNAL(walkAborted(qint32,int)),
+             this, SIGNAL(walkAborted(qint32,int)) );
 }
 
 QHostAddress QtSnmpClient::agentAddress() const {
@@ -26,7 +61,7 @@ QHostAddress QtSnmpClient::agentAddress() const {
 
 void QtSnmpClient::setAgentAddress( const QHostAddress& value ) {
     if ( value.isNull() || (QHostAddress( "0.0.0.0" ) == value) ) {
-        qDebug() << tr( "invalid address %1 will be ignored." ).arg( value.toString() );
+        qCDebug( qtsnmpclient::lcSession ) << tr( "invalid address %1 will be ignored." ).arg( value.toString() );
         return;
     }
 
@@ -98,6 +133,70 @@ void QtSnmpClient::setCommunity( const QByteArray& value ) {
     m_session->setCommunity( value );
 }
 
+QByteArray QtSnmpClient::userName() const {
+    return m_session->userName();
+}
+
+void QtSnmpClient::setUserName( const QByteArray& value ) {
+    if ( thread() != QThread::currentThread() ) {
+        QMetaObject::invokeMethod( this,
+                                   "setUserName",
+                                   Qt::QueuedConnection,
+                                   QGenericReturnArgument(),
+                                   Q_ARG( QByteArray, value ) );
+        return;
+    }
+    Q_ASSERT( thread() == QThread::currentThread() );
+
+    m_session->setUserName( value );
+}
+
+int QtSnmpClient::securityLevel() const {
+    return m_session->securityLevel();
+}
+
+void QtSnmpClient::setSecurityLevel( const int value ) {
+    if ( thread() != QThread::currentThread() ) {
+        QMetaObject::invokeMethod( this,
+                                   "setSecurityLevel",
+                                   Qt::QueuedConnection,
+                                   QGenericReturnArgument(),
+                                   Q_ARG( int, value ) );
+        return;
+    }
+    Q_ASSERT( thread() == QThread::currentThread() );
+
+    m_session->setSecurityLevel( value );
+}
+
+void QtSnmpClient::setAuthPassword( const QByteArray& value ) {
+    if ( thread() != QThread::currentThread() ) {
+        QMetaObject::invokeMethod( this,
+                                   "setAuthPassword",
+                                   Qt::QueuedConnection,
+                                   QGenericReturnArgument(),
+                                   Q_ARG( QByteArray, value ) );
+        return;
+    }
+    Q_ASSERT( thread() == QThread::currentThread() );
+
+    m_session->setAuthPassword( value );
+}
+
+void QtSnmpClient::setPrivPassword( const QByteArray& value ) {
+    if ( thread() != QThread::currentThread() ) {
+        QMetaObject::invokeMethod( this,
+                                   "setPrivPassword",
+                                   Qt::QueuedConnection,
+                                   QGenericReturnArgument(),
+                                   Q_ARG( QByteArray, value ) );
+        return;
+    }
+    Q_ASSERT( thread() == QThread::currentThread() );
+
+    m_session->setPrivPassword( value );
+}
+
 int QtSnmpClient::responseTimeout() const {
     return m_session->responseTimeout();
 }
@@ -124,10 +223,142 @@ void QtSnmpClient::setGetRequestLimit( const int value ) {
     m_session->setGetRequestLimit( value );
 }
 
+int QtSnmpClient::setRequestLimit() const {
+    return m_session->setRequestLimit();
+}
+
+void QtSnmpClient::setSetRequestLimit( const int value ) {
+    m_session->setSetRequestLimit( value );
+}
+
+double QtSnmpClient::rateLimit() const {
+    return m_session->rateLimit();
+}
+
+int QtSnmpClient::rateBurst() const {
+    return m_session->rateBurst();
+}
+
+void QtSnmpClient::setRateLimit( const double pdus_per_second,
+                                 const int burst )
+{
+    m_session->setRateLimit( pdus_per_second, burst );
+}
+
+double QtSnmpClient::globalRateLimit() { // static
+    return qtsnmpclient::TokenBucket::global().rate();
+}
+
+int QtSnmpClient::globalRateBurst() { // static
+    return qtsnmpclient::TokenBucket::global().burst();
+}
+
+void QtSnmpClient::setGlobalRateLimit( const double pdus_per_second,
+                                       const int burst ) // static
+{
+    qtsnmpclient::TokenBucket::global().setRate( pdus_per_second, burst );
+}
+
+int QtSnmpClient::circuitBreakerThreshold() const {
+    return m_session->circuitBreakerThreshold();
+}
+
+int QtSnmpClient::circuitBreakerProbeInterval() const {
+    return m_session->circuitBreakerProbeInterval();
+}
+
+void QtSnmpClient::setCircuitBreaker( const int threshold,
+                                      const int probe_interval_ms )
+{
+    if ( thread() != QThread::currentThread() ) {
+        QMetaObject::invokeMethod( this,
+                                   "setCircuitBreaker",
+                                   Qt::QueuedConnection,
+                                   QGenericReturnArgument(),
+                                   Q_ARG( int, threshold ),
+                                   Q_ARG( int, probe_interval_ms ) );
+        return;
+    }
+    Q_ASSERT( thread() == QThread::currentThread() );
+
+    m_session->setCircuitBreaker( threshold, probe_interval_ms );
+}
+
+bool QtSnmpClient::isAgentAvailable() const {
+    return m_session->isAgentAvailable();
+}
+
+int QtSnmpClient::walkRowLimit() const {
+    return m_session->walkRowLimit();
+}
+
+int QtSnmpClient::walkTimeLimit() const {
+    return m_session->walkTimeLimit();
+}
+
+void QtSnmpClient::setWalkLimits( const int max_rows,
+                                  const int max_duration_ms )
+{
+    m_session->setWalkLimits( max_rows, max_duration_ms );
+}
+
+int QtSnmpClient::decodeThreadCount() { // static
+    return qtsnmpclient::DecodePool::instance().threadCount();
+}
+
+void QtSnmpClient::setDecodeThreadCount( const int value ) { // static
+    qtsnmpclient::DecodePool::instance().setThreadCount( value );
+}
+
+void QtSnmpClient::setConfig( const QtSnmpAgentConfig& config ) {
+    if ( ! config.isValid() ) {
+        qCDebug( qtsnmpclient::lcSession ) << tr( "invalid address %1 will be ignored." ).arg( config.address.toString() );
+        return;
+    }
+
+    if ( thread() != QThread::currentThread() ) {
+        QMetaObject::invokeMethod( this,
+                                   "setConfig",
+                                   Qt::QueuedConnection,
+                                   QGenericReturnArgument(),
+                                   Q_ARG( QtSnmpAgentConfig, config ) );
+        return;
+    }
+    Q_ASSERT( thread() == QThread::currentThread() );
+
+    m_session->setConfig( config );
+}
+
+QList< QtSnmpClient* > QtSnmpClient::createClients( const QtSnmpAgentConfigList& configs,
+                                                    QObject*const parent ) // static
+{
+    Q_ASSERT( ! parent || ( parent->thread() == QThread::currentThread() ) );
+    QList< QtSnmpClient* > result;
+    result.reserve( configs.size() );
+    for ( const auto& config : configs ) {
+        if ( ! config.isValid() ) {
+            qCDebug( qtsnmpclient::lcSession ) << tr( "invalid address %1 will be ignored." ).arg( config.address.toString() );
+            continue;
+        }
+        auto*const client = new QtSnmpClient( parent );
+        client->m_session->setConfig( config );
+        result << client;
+    }
+    return result;
+}
+
 bool QtSnmpClient::isBusy() const {
     return m_session->isBusy();
 }
 
+QtSnmpMetrics QtSnmpClient::metrics() const {
+    return m_session->metrics();
+}
+
+QtSnmpMetrics QtSnmpClient::globalMetrics() { // static
+    return qtsnmpclient::Metrics::global().snapshot();
+}
+
 qint32 QtSnmpClient::requestValue( const QString& oid ) {
     return requestValues( QStringList( oid ) );
 }
@@ -136,10 +367,24 @@ qint32 QtSnmpClient::requestValues( const QStringList& oid_list ) {
     return m_session->requestValues( oid_list );
 }
 
+qint32 QtSnmpClient::requestValues( const QtSnmpPreparedRequest& prepared ) {
+    return m_session->requestValues( prepared );
+}
+
 qint32 QtSnmpClient::requestSubValues( const QString& oid ) {
     return m_session->requestSubValues( oid );
 }
 
+qint32 QtSnmpClient::requestSubValuesIfChanged( const QString& oid,
+                                                const QString& guard_oid )
+{
+    return m_session->requestSubValuesIfChanged( oid, guard_oid );
+}
+
+qint32 QtSnmpClient::requestTable( const QString& entry_oid ) {
+    return m_session->requestTable( entry_oid );
+}
+
 qint32 QtSnmpClient::setValue( const QByteArray& community,
                                const QString& oid,
                                const int type,
@@ -147,3 +392,82 @@ qint32 QtSnmpClient::setValue( const QByteArray& community,
 {
     return m_session->setValue( community, oid, type, value );
 }
+
+qint32 QtSnmpClient::setValues( const QByteArray& community,
+                                const QtSnmpDataList& values )
+{
+    return m_session->setValues( community, values );
+}
+
+qint32 QtSnmpClient::requestValue( const QString& oid,
+                                   QObject*const context,
+                                   const QtSnmpCallback& callback )
+{
+    return requestValues( QStringList( oid ), context, callback );
+}
+
+qint32 QtSnmpClient::requestValues( const QStringList& oid_list,
+                                    QObject*const context,
+                                    const QtSnmpCallback& callback )
+{
+    return m_session->requestValues( oid_list, guardedCallback( context, callback ) );
+}
+
+qint32 QtSnmpClient::requestValues( const QtSnmpPreparedRequest& prepared,
+                                    QObject*const context,
+                                    const QtSnmpCallback& callback )
+{
+    return m_session->requestValues( prepared, guardedCallback( context, callback ) );
+}
+
+qint32 QtSnmpClient::requestSubValues( const QString& oid,
+                                       QObject*const context,
+                                       const QtSnmpCallback& callback )
+{
+    return m_session->requestSubValues( oid, guardedCallback( context, callback ) );
+}
+
+qint32 QtSnmpClient::requestSubValuesIfChanged( const QString& oid,
+                                                const QString& guard_oid,
+                                                QObject*const context,
+                                                const QtSnmpCallback& callback )
+{
+    return m_session->requestSubValuesIfChanged( oid, guard_oid, guardedCallback( context, callback ) );
+}
+
+qint32 QtSnmpClient::requestTable( const QString& entry_oid,
+                                   QObject*const context,
+                                   const QtSnmpCallback& callback )
+{
+    return m_session->requestTable( entry_oid, guardedCallback( context, callback ) );
+}
+
+qint32 QtSnmpClient::setValue( const QByteArray& community,
+                               const QString& oid,
+                               const int type,
+                               const QByteArray& value,
+                               QObject*const context,
+                               const QtSnmpCallback& callback )
+{
+    return m_session->setValue( community, oid, type, value, guardedCallback( context, callback ) );
+}
+
+qint32 QtSnmpClient::setValues( const QByteArray& community,
+                                const QtSnmpDataList& values,
+                                QObject*const context,
+                                const QtSnmpCallback& callback )
+{
+    return m_session->setValues( community, values, guardedCallback( context, callback ) );
+}
+
+void QtSnmpClient::onResponseReceived( const qint32 request_id,
+                                       const QtSnmpDataListPtr& values )
+{
+    Q_ASSERT( values );
+    emit resultReady( request_id, values );
+
+    static const auto legacy_signal = QMetaMethod::fromSignal( &QtSnmpClient::responseReceived );
+    if ( isSignalConnected( legacy_signal ) ) {
+        emit responseReceived( request_id, *values );
+    }
+}
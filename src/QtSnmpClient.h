@@ -1,6 +1,11 @@
 #pragma once
 
 #include "QtSnmpData.h"
+#include "QtSnmpAgentConfig.h"
+#include "QtSnmpMetrics.h"
+#include "QtSnmpPreparedRequest.h"
+#include "QtSnmpResult.h"
+#include "QtSnmpTable.h"
 #include <QObject>
 #include <QHostAddress>
 #include "win_export.h"
@@ -14,6 +19,13 @@ public:
     enum ProtocolVersion {
         SNMPv1 = 0,
         SNMPv2c = 1,
+        SNMPv3 = 3,
+    };
+
+    enum SecurityLevel {
+        NoAuthNoPriv = 0,
+        AuthNoPriv = 1,
+        AuthPriv = 3,
     };
 
 public:
@@ -31,29 +43,184 @@ public:
     QByteArray community() const;
     Q_SLOT void setCommunity( const QByteArray& );
 
+    QByteArray userName() const;
+    Q_SLOT void setUserName( const QByteArray& );
+
+    int securityLevel() const;
+    Q_SLOT void setSecurityLevel( const int );
+
+    Q_SLOT void setAuthPassword( const QByteArray& );
+    Q_SLOT void setPrivPassword( const QByteArray& );
+
     int responseTimeout() const;
     Q_SLOT void setReponseTimeout( const int );
 
     int getRequestLimit() const;
     Q_SLOT void setGetRequestLimit( const int );
 
+    // NOTE: the limits of PDUs sent per second (including retransmissions)
+    //       to the agent and to all agents of the process; a PDU over
+    //       the limit is delayed. Zero means no limit (default).
+    //       All methods are thread safe.
+    double rateLimit() const;
+    int rateBurst() const;
+    void setRateLimit( const double pdus_per_second,
+                       const int burst = 1 );
+    static double globalRateLimit();
+    static int globalRateBurst();
+    static void setGlobalRateLimit( const double pdus_per_second,
+                                    const int burst = 1 );
+
+    // NOTE: after the threshold of requests in a row are timed out,
+    //       the agent is taken as down: its requests fail at once (and are
+    //       counted as rejects) till it responds to a probe (a GET request
+    //       of sysUpTime.0). The first probe is sent after the interval,
+    //       which is doubled after every failed probe up to 5 minutes.
+    //       A zero threshold disables it. By default it is 3 requests
+    //       and 10 seconds.
+    int circuitBreakerThreshold() const;
+    int circuitBreakerProbeInterval() const;
+    Q_SLOT void setCircuitBreaker( const int threshold,
+                                   const int probe_interval_ms );
+    bool isAgentAvailable() const;
+
+    // NOTE: a walk (requestSubValues, requestTable) is aborted with
+    //       QtSnmpResult::WalkLimitExceeded after the count of values or
+    //       the duration in milliseconds, and with OidNotIncreasing if
+    //       the agent returns an OID which is not after the previous one
+    //       (it would loop the walk forever). Zero means no limit (default).
+    //       Both methods are thread safe, the walk in progress keeps
+    //       its limits.
+    int walkRowLimit() const;
+    int walkTimeLimit() const;
+    void setWalkLimits( const int max_rows,
+                        const int max_duration_ms );
+
+    // NOTE: the count of threads which decode the responses of SNMPv1/v2c
+    //       for all clients of the process, so the thread of the clients
+    //       only reads the datagrams and runs the requests; the results of
+    //       a client are still delivered in the order of its responses.
+    //       Zero (default) decodes them in the thread of the client.
+    static int decodeThreadCount();
+    static void setDecodeThreadCount( const int );
+
+    // NOTE: sets all the settings of the agent at once; the socket is shared
+    //       by all clients of a thread, so nothing is bound or rebound
+    Q_SLOT void setConfig( const QtSnmpAgentConfig& );
+
+    // NOTE: creates the clients of the valid configurations in the current
+    //       thread (the invalid ones are skipped), e.g. for thousands of
+    //       agents loaded by QtSnmpAgentConfig::loadFile at startup
+    static QList< QtSnmpClient* > createClients( const QtSnmpAgentConfigList&,
+                                                 QObject*const parent = nullptr );
+
     bool isBusy() const;
 
+    // NOTE: both methods are thread safe and may be called at any time
+    QtSnmpMetrics metrics() const;
+    static QtSnmpMetrics globalMetrics();
+
     qint32 requestValue( const QString& );
 
     qint32 requestValues( const QStringList& oid_list );
 
+    // NOTE: sends the PDUs encoded by the prepared request
+    qint32 requestValues( const QtSnmpPreparedRequest& );
+
     qint32 requestSubValues( const QString& oid );
 
+    // NOTE: reads the guard OID (e.g. entLastChangeTime.0 or ifTableLastChange.0)
+    //       and walks the OID only if the guard has changed since the last walk,
+    //       otherwise the same result of that walk is delivered again.
+    //       A guard of sysUpTime.0 triggers the walk after a restart of the agent.
+    qint32 requestSubValuesIfChanged( const QString& oid,
+                                      const QString& guard_oid );
+
+    // NOTE: walks the columns of a table entry (e.g. ifEntry, not ifTable),
+    //       the result is delivered by tableReceived
+    qint32 requestTable( const QString& entry_oid );
+
     qint32 setValue( const QByteArray& community,
                      const QString& oid,
                      const int type,
                      const QByteArray& value );
 
+    // NOTE: the limit of values in one PDU of setValues, it is separate
+    //       from the GET request limit since an agent may accept fewer
+    //       values in a SET. Zero means no limit (default).
+    int setRequestLimit() const;
+    Q_SLOT void setSetRequestLimit( const int );
+
+    // NOTE: sets many values at once, the OID of a value is its address
+    //       (QtSnmpData::setAddress). The values are packed into as few
+    //       PDUs as the set request limit and the datagram size allow, a PDU
+    //       answered by tooBig is split. The result is delivered by resultReady
+    //       if all the values are set, otherwise by requestFailed; the callback
+    //       gets the error status of every value in QtSnmpResult::set_status.
+    qint32 setValues( const QByteArray& community,
+                      const QtSnmpDataList& values );
+
+    // NOTE: the result of a request with a callback is passed only
+    //       to the callback (in the thread of the client), no signal
+    //       is emitted for it. The callback is not called after
+    //       the context is destroyed, a null context is no guard.
+    //       The context has to live in the thread of the client.
+    qint32 requestValue( const QString&,
+                         QObject*const context,
+                         const QtSnmpCallback& );
+
+    qint32 requestValues( const QStringList& oid_list,
+                          QObject*const context,
+                          const QtSnmpCallback& );
+
+    qint32 requestValues( const QtSnmpPreparedRequest&,
+                          QObject*const context,
+                          const QtSnmpCallback& );
+
+    qint32 requestSubValues( const QString& oid,
+                             QObject*const context,
+                             const QtSnmpCallback& );
+
+    qint32 requestSubValuesIfChanged( const QString& oid,
+                                      const QString& guard_oid,
+                                      QObject*const context,
+                                      const QtSnmpCallback& );
+
+    qint32 requestTable( const QString& entry_oid,
+                         QObject*const context,
+                         const QtSnmpCallback& );
+
+    qint32 setValue( const QByteArray& community,
+                     const QString& oid,
+                     const int type,
+                     const QByteArray& value,
+                     QObject*const context,
+                     const QtSnmpCallback& );
+
+    qint32 setValues( const QByteArray& community,
+                      const QtSnmpDataList& values,
+                      QObject*const context,
+                      const QtSnmpCallback& );
+
 public:
+    // NOTE: resultReady shares one immutable list with every receiver;
+    //       responseReceived is kept for compatibility and copies the list
+    //       only when something is connected to it.
+    Q_SIGNAL void resultReady( const qint32 request_id,
+                               const QtSnmpDataListPtr& );
     Q_SIGNAL void responseReceived( const qint32 request_id,
                                     const QtSnmpDataList& );
+    Q_SIGNAL void tableReceived( const qint32 request_id,
+                                 const QtSnmpTablePtr& );
     Q_SIGNAL void requestFailed( const qint32 request_id );
+    // NOTE: the error (QtSnmpResult::Error) of an aborted walk,
+    //       it is emitted just before requestFailed
+    Q_SIGNAL void walkAborted( const qint32 request_id,
+                               const int error );
+
+private:
+    Q_SLOT void onResponseReceived( const qint32 request_id,
+                                    const QtSnmpDataListPtr& );
 
 private:
     qtsnmpclient::Session*const m_session;
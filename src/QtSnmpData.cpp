@@ -1,4 +1,5 @@
 #include "QtSnmpData.h"
+#include "Logging.h"
 #include <QHostAddress>
 #include <math.h>
 #include <inttypes.h>
@@ -134,6 +135,7 @@ QtSnmpData::QtSnmpData( const int type, const QByteArray data )
     case GET_NEXT_REQUEST_TYPE:
     case GET_RESPONSE_TYPE:
     case SET_REQUEST_TYPE:
+    case REPORT_TYPE:
         parseData( data, &m_children );
         return;
     case TIME_TICKS_TYPE:
@@ -184,6 +186,7 @@ bool QtSnmpData::isValid() const {
     case GET_NEXT_REQUEST_TYPE:
     case GET_RESPONSE_TYPE:
     case SET_REQUEST_TYPE:
+    case REPORT_TYPE:
         return 0 == m_data.size();
     case OBJECT_TYPE:
     case STRING_TYPE:
@@ -219,6 +222,8 @@ QString QtSnmpData::typeDescription() const {
         return "GAUGE_TYPE";
     case TIME_TICKS_TYPE:
         return "TIME_TICKS_TYPE";
+    case COUNTER64_TYPE:
+        return "COUNTER64_TYPE";
     case GET_REQUEST_TYPE:
         return "GET_REQUEST_TYPE";
     case GET_NEXT_REQUEST_TYPE:
@@ -227,6 +232,8 @@ QString QtSnmpData::typeDescription() const {
         return "GET_RESPONSE_TYPE";
     case SET_REQUEST_TYPE:
         return "SET_REQUEST_TYPE";
+    case REPORT_TYPE:
+        return "REPORT_TYPE";
     default: break;
     }
     return QString( "Unsupported Type (%1)" ).arg( m_type );
@@ -258,6 +265,7 @@ qint64 QtSnmpData::longLongValue() const {
         }
     case GAUGE_TYPE:
     case COUNTER_TYPE:
+    case COUNTER64_TYPE:
     case INTEGER_TYPE: {
 
         // NOTE: According to BER (Basic Encoding Rules for ASN.1)
@@ -298,14 +306,8 @@ QByteArray QtSnmpData::address() const {
 }
 
 void QtSnmpData::setAddress( const QByteArray& value ) {
+    // NOTE: the address is shared with the value, not copied
     m_address = value;
-    int capacity = 2;
-    while ( capacity < m_address.size() ) {
-        capacity *= 2;
-    }
-    if ( capacity > m_address.size() ) {
-        m_address.reserve( capacity );
-    }
 }
 
 const std::vector< QtSnmpData >& QtSnmpData::children() const {
@@ -313,14 +315,13 @@ const std::vector< QtSnmpData >& QtSnmpData::children() const {
 }
 
 void QtSnmpData::addChild( const QtSnmpData& child ) {
-    if ( 0 == m_children.capacity() ) {
-        m_children.reserve( 2 );
-    } else if ( m_children.capacity() == m_children.size() ) {
-        m_children.reserve( 2*m_children.capacity() );
-    }
     m_children.push_back( child );
 }
 
+void QtSnmpData::addChild( QtSnmpData&& child ) {
+    m_children.push_back( std::move( child ) );
+}
+
 QByteArray QtSnmpData::makeSnmpChunk() const {
     switch ( m_type ) {
     case OBJECT_TYPE:
@@ -355,6 +356,7 @@ QByteArray QtSnmpData::makeSnmpChunk() const {
     case GET_NEXT_REQUEST_TYPE:
     case GET_RESPONSE_TYPE:
     case SET_REQUEST_TYPE:
+    case REPORT_TYPE:
         {
             QByteArray chunk;
             // NOTE: we don't know how much is needed exactly, but is
@@ -378,6 +380,8 @@ QVariant QtSnmpData::toVariant() const {
     case COUNTER_TYPE:
     case TIME_TICKS_TYPE:
         return intValue();
+    case COUNTER64_TYPE:
+        return static_cast< qulonglong >( longLongValue() );
     case STRING_TYPE:
         return QString::fromLocal8Bit( m_data );
     case IP_ADDR_TYPE:
@@ -450,7 +454,7 @@ void QtSnmpData::parseData( const QByteArray& data_for_parsing,
 
     while ( read_bytes < total_size ) {
         if ( (total_size - read_bytes) < 2 ) {
-            qWarning() << "Invalid size of a chunk: " << (total_size - read_bytes);
+            qCWarning( qtsnmpclient::lcData ) << "Invalid size of a chunk: " << (total_size - read_bytes);
             break;
         }
 
@@ -460,7 +464,7 @@ void QtSnmpData::parseData( const QByteArray& data_for_parsing,
         const int size_length = 1 + std::max( 0, data_length - 0x80);
         if ( size_length > 1 ) {
             if ( (total_size - read_bytes) <= size_length ) {
-                qWarning() << "Invalid packet's size";
+                qCWarning( qtsnmpclient::lcData ) << "Invalid packet's size";
                 break;
             }
             data_length = 0;
@@ -472,7 +476,7 @@ void QtSnmpData::parseData( const QByteArray& data_for_parsing,
         read_bytes += size_length;
 
         if ( (total_size - read_bytes) < data_length ) {
-            qWarning() << "Error #2 during parsing a packet";
+            qCWarning( qtsnmpclient::lcData ) << "Error #2 during parsing a packet";
             break;
         }
 
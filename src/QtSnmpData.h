@@ -6,6 +6,8 @@
 #include <QMetaType>
 #include <QDataStream>
 #include <QDebug>
+#include <memory>
+#include <utility>
 #include <vector>
 #include "win_export.h"
 
@@ -34,16 +36,20 @@ public:
         COUNTER_TYPE = 0x41,
         GAUGE_TYPE = 0x42,
         TIME_TICKS_TYPE = 0x43,
+        COUNTER64_TYPE = 0x46,
         GET_REQUEST_TYPE = 0xA0,
         GET_NEXT_REQUEST_TYPE = 0xA1,
         GET_RESPONSE_TYPE = 0xA2,
         SET_REQUEST_TYPE = 0xA3,
+        REPORT_TYPE = 0xA8,
     };
 
 public:
     QtSnmpData() = default;
     QtSnmpData( const QtSnmpData& ) = default;
     QtSnmpData& operator=( const QtSnmpData& ) = default;
+    QtSnmpData( QtSnmpData&& ) = default;
+    QtSnmpData& operator=( QtSnmpData&& ) = default;
     QtSnmpData( const int type, const QByteArray data = {} );
 
     int type() const;
@@ -60,6 +66,12 @@ public:
 
     const std::vector< QtSnmpData >& children() const;
     void addChild( const QtSnmpData& );
+    void addChild( QtSnmpData&& );
+    template< typename... Args >
+    QtSnmpData& emplaceChild( Args&&... args ) {
+        m_children.emplace_back( std::forward< Args >( args )... );
+        return m_children.back();
+    }
 
     bool isValid() const;
 
@@ -86,6 +98,11 @@ private:
 typedef std::vector< QtSnmpData > QtSnmpDataList;
 typedef QHash< QByteArray, QtSnmpData > QtSnmpDataMap;
 
+// NOTE: An immutable result shared by all receivers, so it is never deep-copied
+//       even by the queued connections.
+typedef std::shared_ptr< const QtSnmpDataList > QtSnmpDataListPtr;
+
 Q_DECLARE_METATYPE( QtSnmpData )
 Q_DECLARE_METATYPE( QtSnmpDataList )
 Q_DECLARE_METATYPE( QtSnmpDataMap )
+Q_DECLARE_METATYPE( QtSnmpDataListPtr )
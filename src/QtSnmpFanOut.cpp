@@ -0,0 +1,192 @@
+#include "QtSnmpFanOut.h"
+#include "Session.h"
+#include "Logging.h"
+#include <QThread>
+#include <algorithm>
+
+QtSnmpFanOut::QtSnmpFanOut( QObject*const parent )
+    : QObject( parent )
+{
+}
+
+QtSnmpFanOut::~QtSnmpFanOut() {
+    // NOTE: the sessions never call the callbacks when they are deleted
+    for ( auto*const session : m_sessions ) {
+        delete session;
+    }
+}
+
+int QtSnmpFanOut::setAgents( const QtSnmpAgentConfigList& configs ) {
+    Q_ASSERT( thread() == QThread::currentThread() );
+    cancel();
+    for ( auto*const session : m_sessions ) {
+        delete session;
+    }
+    m_sessions.clear();
+    m_agent_indexes.clear();
+    m_sessions.reserve( static_cast< size_t >( configs.size() ) );
+    m_agent_indexes.reserve( static_cast< size_t >( configs.size() ) );
+    for ( int i = 0; i < configs.size(); ++i ) {
+        const auto& config = configs.at( i );
+        if ( ! config.isValid() ) {
+            qCDebug( qtsnmpclient::lcSession ) << tr( "invalid address %1 will be ignored." ).arg( config.address.toString() );
+            continue;
+        }
+        auto*const session = new qtsnmpclient::Session( this );
+        session->setConfig( config );
+        m_sessions.push_back( session );
+        m_agent_indexes.push_back( i );
+    }
+    return agentCount();
+}
+
+int QtSnmpFanOut::agentCount() const {
+    return static_cast< int >( m_sessions.size() );
+}
+
+int QtSnmpFanOut::concurrency() const {
+    return m_concurrency;
+}
+
+void QtSnmpFanOut::setConcurrency( const int value ) {
+    m_concurrency = qMax( 1, value );
+    if ( m_is_running ) {
+        startNextAgents();
+    }
+}
+
+int QtSnmpFanOut::batchSize() const {
+    return m_batch_size;
+}
+
+void QtSnmpFanOut::setBatchSize( const int value ) {
+    m_batch_size = qMax( 1, value );
+}
+
+bool QtSnmpFanOut::requestValues( const QStringList& oid_list,
+                                  const ProgressCallback& progress,
+                                  const FinishedCallback& finished )
+{
+    return requestValues( QtSnmpPreparedRequest( oid_list ), progress, finished );
+}
+
+bool QtSnmpFanOut::requestValues( const QtSnmpPreparedRequest& request,
+                                  const ProgressCallback& progress,
+                                  const FinishedCallback& finished )
+{
+    Q_ASSERT( thread() == QThread::currentThread() );
+    Q_ASSERT( progress );
+    if ( m_is_running || request.isNull() ) {
+        return false;
+    }
+
+    m_request = request;
+    m_progress = progress;
+    m_finished = finished;
+    m_is_running = true;
+    m_next_agent = 0;
+    m_in_flight = 0;
+    m_finished_count = 0;
+    m_failed_count = 0;
+    m_delivered_count = 0;
+    m_replies.clear();
+    m_replies.reserve( static_cast< size_t >( qMin( m_batch_size, agentCount() ) ) );
+    if ( m_sessions.empty() ) {
+        m_is_delivery_posted = true;
+        QMetaObject::invokeMethod( this, "deliverBatch", Qt::QueuedConnection );
+        return true;
+    }
+    startNextAgents();
+    return true;
+}
+
+void QtSnmpFanOut::cancel() {
+    // NOTE: the replies of the cancelled request are ignored by the generation
+    ++m_generation;
+    m_is_running = false;
+    m_progress = ProgressCallback();
+    m_finished = FinishedCallback();
+    m_replies.clear();
+}
+
+bool QtSnmpFanOut::isRunning() const {
+    return m_is_running;
+}
+
+void QtSnmpFanOut::startNextAgents() {
+    const auto generation = m_generation;
+    while ( ( m_in_flight < m_concurrency ) && ( m_next_agent < m_sessions.size() ) ) {
+        const int agent = m_agent_indexes.at( m_next_agent );
+        auto*const session = m_sessions.at( m_next_agent );
+        ++m_next_agent;
+        ++m_in_flight;
+        session->requestValues( m_request, [this, generation, agent]( const QtSnmpResult& result ) {
+            if ( generation == m_generation ) {
+                addReply( agent, result );
+            }
+        } );
+        if ( generation != m_generation ) {
+            return; // NOTE: a failure at once has finished the request
+        }
+    }
+}
+
+void QtSnmpFanOut::addReply( const int agent,
+                             const QtSnmpResult& result )
+{
+    Reply reply;
+    reply.agent = agent;
+    reply.result = result;
+    m_replies.push_back( std::move( reply ) );
+    --m_in_flight;
+    ++m_finished_count;
+    if ( ! result.is_ok ) {
+        ++m_failed_count;
+    }
+
+    // NOTE: the replies received by one pass of the event loop
+    //       are delivered together
+    if ( ! m_is_delivery_posted ) {
+        m_is_delivery_posted = true;
+        QMetaObject::invokeMethod( this, "deliverBatch", Qt::QueuedConnection );
+    }
+    startNextAgents();
+}
+
+void QtSnmpFanOut::deliverBatch() {
+    m_is_delivery_posted = false;
+    if ( ! m_is_running ) {
+        return;
+    }
+
+    const auto generation = m_generation;
+    const auto progress = m_progress;
+    ReplyList replies;
+    replies.swap( m_replies );
+    const auto batch_size = static_cast< size_t >( m_batch_size );
+    for ( size_t first = 0; first < replies.size(); first += batch_size ) {
+        const auto last = std::min( replies.size(), first + batch_size );
+        m_delivered_count += static_cast< int >( last - first );
+        if ( ( 0 == first ) && ( replies.size() == last ) ) {
+            progress( replies, m_delivered_count, agentCount() );
+        } else {
+            const ReplyList batch( replies.begin() + static_cast< std::ptrdiff_t >( first ),
+                                   replies.begin() + static_cast< std::ptrdiff_t >( last ) );
+            progress( batch, m_delivered_count, agentCount() );
+        }
+        if ( generation != m_generation ) {
+            return; // NOTE: cancelled by the callback
+        }
+    }
+
+    if ( m_delivered_count < agentCount() ) {
+        return;
+    }
+    m_is_running = false;
+    const auto finished = m_finished;
+    m_progress = ProgressCallback();
+    m_finished = FinishedCallback();
+    if ( finished ) {
+        finished( m_finished_count - m_failed_count, m_failed_count );
+    }
+}
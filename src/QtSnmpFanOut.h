@@ -0,0 +1,97 @@
+#pragma once
+
+#include "QtSnmpAgentConfig.h"
+#include "QtSnmpPreparedRequest.h"
+#include "QtSnmpResult.h"
+#include <QObject>
+#include <QStringList>
+#include <functional>
+#include <vector>
+#include "win_export.h"
+
+namespace qtsnmpclient { class Session; }
+
+// NOTE: Sends the same GET request to many agents in one call, e.g. sysUpTime.0
+//       of all devices. Every agent has a session of its own (no QtSnmpClient,
+//       no signal per agent), all of them share the socket of the thread.
+//       The request is encoded once for all agents of the same version and
+//       community. Up to the concurrency of agents have the request in flight
+//       at once, the next agent is started as soon as one is finished; the
+//       PDUs are also paced by the rate limits of the agents and by the global
+//       one (QtSnmpClient::setGlobalRateLimit).
+//
+//       The results are delivered in batches to the progress callback by
+//       the event loop, the finished callback is called after the last batch.
+//       The fan-out must live in the thread of its use and must not be
+//       deleted by its callbacks (deleteLater may be used).
+class WIN_EXPORT QtSnmpFanOut : public QObject {
+    Q_OBJECT
+    Q_DISABLE_COPY( QtSnmpFanOut )
+public:
+    struct Reply {
+        int agent = -1; // the index of the agent in the list of setAgents
+        QtSnmpResult result;
+    };
+    typedef std::vector< Reply > ReplyList;
+
+    typedef std::function< void( const ReplyList& batch,
+                                 const int finished_count,
+                                 const int agent_count ) > ProgressCallback;
+    typedef std::function< void( const int succeeded_count,
+                                 const int failed_count ) > FinishedCallback;
+
+public:
+    explicit QtSnmpFanOut( QObject*const parent = nullptr );
+    ~QtSnmpFanOut() override;
+
+    // NOTE: the invalid agents are skipped (but keep their indexes),
+    //       a running request is cancelled; returns the count of agents
+    int setAgents( const QtSnmpAgentConfigList& );
+    int agentCount() const;
+
+    // NOTE: how many agents may have the request in flight at once
+    int concurrency() const;
+    void setConcurrency( const int );
+
+    // NOTE: how many results are delivered by one progress callback at most
+    int batchSize() const;
+    void setBatchSize( const int );
+
+    // NOTE: returns false if a request is running
+    bool requestValues( const QStringList& oid_list,
+                        const ProgressCallback&,
+                        const FinishedCallback& = FinishedCallback() );
+    bool requestValues( const QtSnmpPreparedRequest&,
+                        const ProgressCallback&,
+                        const FinishedCallback& = FinishedCallback() );
+
+    // NOTE: no callback is called for the cancelled request,
+    //       the requests in flight are finished by their sessions
+    void cancel();
+    bool isRunning() const;
+
+private:
+    void startNextAgents();
+    void addReply( const int agent,
+                   const QtSnmpResult& );
+    Q_SLOT void deliverBatch();
+
+private:
+    std::vector< qtsnmpclient::Session* > m_sessions;
+    std::vector< int > m_agent_indexes;
+    int m_concurrency = 256;
+    int m_batch_size = 256;
+
+    QtSnmpPreparedRequest m_request;
+    ProgressCallback m_progress;
+    FinishedCallback m_finished;
+    quint64 m_generation = 0;
+    bool m_is_running = false;
+    bool m_is_delivery_posted = false;
+    size_t m_next_agent = 0;
+    int m_in_flight = 0;
+    int m_finished_count = 0;
+    int m_failed_count = 0;
+    int m_delivered_count = 0;
+    ReplyList m_replies;
+};
@@ -0,0 +1,47 @@
+#include "QtSnmpMetrics.h"
+#include <QVariantList>
+#include <limits>
+
+quint64 QtSnmpHistogram::bucketUpperBound( const int bucket ) { // static
+    Q_ASSERT( ( bucket >= 0 ) && ( bucket < BUCKET_COUNT ) );
+    if ( bucket >= BUCKET_COUNT - 1 ) {
+        return std::numeric_limits< quint64 >::max();
+    }
+    return static_cast< quint64 >( 1 ) << bucket;
+}
+
+QVariantMap QtSnmpHistogram::toVariantMap() const {
+    QVariantList bucket_list;
+    bucket_list.reserve( BUCKET_COUNT );
+    for ( const auto value : buckets ) {
+        bucket_list << value;
+    }
+
+    QVariantMap map;
+    map.insert( "count", count );
+    map.insert( "sum", sum );
+    map.insert( "max", max );
+    map.insert( "buckets", bucket_list );
+    return map;
+}
+
+QVariantMap QtSnmpMetrics::toVariantMap() const {
+    QVariantMap map;
+    map.insert( "pdus_sent", pdus_sent );
+    map.insert( "pdus_received", pdus_received );
+    map.insert( "retransmits", retransmits );
+    map.insert( "timeouts", timeouts );
+    map.insert( "drops", drops );
+    map.insert( "too_big", too_big );
+    map.insert( "unexpected_request_ids", unexpected_request_ids );
+    map.insert( "duplicates", duplicates );
+    map.insert( "bytes_sent", bytes_sent );
+    map.insert( "bytes_received", bytes_received );
+    map.insert( "suppressed_messages", suppressed_messages );
+    map.insert( "paced_pdus", paced_pdus );
+    map.insert( "rejects", rejects );
+    map.insert( "aborted_walks", aborted_walks );
+    map.insert( "rtt", rtt.toVariantMap() );
+    map.insert( "job_latency", job_latency.toVariantMap() );
+    return map;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QMetaType>
+#include <QVariantMap>
+#include <array>
+#include "win_export.h"
+
+// NOTE: A bucket N of a histogram counts values (in microseconds)
+//       from 2^(N-1) up to 2^N, the last bucket counts all bigger values.
+struct WIN_EXPORT QtSnmpHistogram {
+    enum { BUCKET_COUNT = 32 };
+
+    quint64 count = 0;
+    quint64 sum = 0;
+    quint64 max = 0;
+    std::array< quint64, BUCKET_COUNT > buckets = {};
+
+    static quint64 bucketUpperBound( const int bucket );
+    QVariantMap toVariantMap() const;
+};
+
+struct WIN_EXPORT QtSnmpMetrics {
+    quint64 pdus_sent = 0;
+    quint64 pdus_received = 0;
+    quint64 retransmits = 0;
+    quint64 timeouts = 0;
+    quint64 drops = 0;
+    quint64 too_big = 0;
+    quint64 unexpected_request_ids = 0;
+    quint64 duplicates = 0; // responses to the already answered requests
+    quint64 bytes_sent = 0;
+    quint64 bytes_received = 0;
+    quint64 suppressed_messages = 0; // diagnostic messages
+    quint64 paced_pdus = 0; // delayed by the rate limits
+    quint64 rejects = 0; // requests failed at once while the agent is down
+    quint64 aborted_walks = 0; // by a not increasing OID or by the walk limits
+    QtSnmpHistogram rtt;
+    QtSnmpHistogram job_latency;
+
+    QVariantMap toVariantMap() const;
+};
+
+Q_DECLARE_METATYPE( QtSnmpMetrics )
@@ -0,0 +1,457 @@
+#include "QtSnmpPollScheduler.h"
+#include "QtSnmpClient.h"
+#include "Transport.h"
+#include "Logging.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // NOTE: the fractional parts of N*(golden ratio) cover [0, 1) almost
+    //       evenly for any count of N, so polls added one by one are spread
+    //       over their interval without knowing how many of them will be.
+    const double GOLDEN_RATIO_FRACTION = 0.6180339887498949;
+
+    // NOTE: the exceptions of SNMPv2 in place of a value
+    bool isMissingValue( const QtSnmpData& value ) {
+        const int type = value.type();
+        return ( 0x80 == type )     // noSuchObject
+               || ( 0x81 == type )  // noSuchInstance
+               || ( 0x82 == type ); // endOfMibView
+    }
+}
+
+QtSnmpPollScheduler::QtSnmpPollScheduler( QObject*const parent )
+    : QObject( parent )
+    , m_random( std::random_device()() )
+{
+    m_clock.start();
+    m_transport = qtsnmpclient::Transport::forCurrentThread();
+}
+
+QtSnmpPollScheduler::~QtSnmpPollScheduler() {
+    for ( const auto& poll : m_polls ) {
+        m_transport->cancelTimer( poll.timer );
+    }
+}
+
+int QtSnmpPollScheduler::addPoll( QtSnmpClient*const client,
+                                  const QStringList& oid_list,
+                                  const int interval_ms,
+                                  const PollType type )
+{
+    Q_ASSERT( client );
+    if ( ! client || oid_list.isEmpty() || ( interval_ms <= 0 ) ) {
+        qCDebug( qtsnmpclient::lcSession ) << tr( "invalid poll of %1 OIDs every %2 ms will be ignored." )
+                                              .arg( oid_list.size() )
+                                              .arg( interval_ms );
+        return -1;
+    }
+    Q_ASSERT( client->thread() == thread() );
+
+    if ( ! m_agents.contains( client ) ) {
+        m_agents.insert( client, Agent() );
+        connect( client, SIGNAL(destroyed(QObject*)),
+                 SLOT(onClientDestroyed(QObject*)) );
+    }
+
+    const int poll_id = ++m_last_poll_id;
+    const double phase = std::fmod( poll_id * GOLDEN_RATIO_FRACTION, 1.0 );
+    Poll poll;
+    poll.client = client;
+    poll.oid_list = oid_list;
+    if ( GetPoll == type ) {
+        poll.prepared = QtSnmpPreparedRequest( oid_list );
+    }
+    poll.interval = interval_ms;
+    poll.type = type;
+    poll.base_time = now() + static_cast< qint64 >( phase * interval_ms );
+    poll.timer = addTimer( poll.base_time, poll_id );
+    m_polls.insert( poll_id, poll );
+    return poll_id;
+}
+
+void QtSnmpPollScheduler::removePoll( const int poll_id ) {
+    const auto iter = m_polls.find( poll_id );
+    if ( m_polls.end() == iter ) {
+        return;
+    }
+
+    QObject*const client = iter->client.data();
+    m_transport->cancelTimer( iter->timer );
+    const auto agent_iter = m_agents.find( client );
+    if ( ( m_agents.end() != agent_iter ) && ( iter->outstanding > 0 ) ) {
+        // NOTE: the late results of the poll are ignored
+        --agent_iter->in_flight;
+    }
+    m_polls.erase( iter );
+
+    startPending( client );
+}
+
+void QtSnmpPollScheduler::setRediscovery( const int poll_id,
+                                         const QString& change_oid,
+                                         const int rediscovery_cycles )
+{
+    const auto iter = m_polls.find( poll_id );
+    if ( m_polls.end() == iter ) {
+        return;
+    }
+    Q_ASSERT( TablePoll == iter->type );
+    if ( change_oid != iter->change_oid ) {
+        // NOTE: the value of the new OID is read by the next walk
+        iter->change_oid = change_oid;
+        iter->change_value = QtSnmpData();
+        iter->is_discovery_needed = true;
+    }
+    iter->rediscovery_cycles = qMax( 0, rediscovery_cycles );
+}
+
+int QtSnmpPollScheduler::instanceCount( const int poll_id ) const {
+    const auto iter = m_polls.constFind( poll_id );
+    return ( m_polls.constEnd() != iter ) ? iter->instance_count : 0;
+}
+
+void QtSnmpPollScheduler::setWalkGuard( const int poll_id,
+                                        const QString& guard_oid )
+{
+    const auto iter = m_polls.find( poll_id );
+    if ( m_polls.end() == iter ) {
+        return;
+    }
+    Q_ASSERT( WalkPoll == iter->type );
+    iter->guard_oid = guard_oid;
+}
+
+bool QtSnmpPollScheduler::hasPoll( const int poll_id ) const {
+    return m_polls.contains( poll_id );
+}
+
+int QtSnmpPollScheduler::pollCount() const {
+    return m_polls.size();
+}
+
+int QtSnmpPollScheduler::agentConcurrency() const {
+    return m_agent_concurrency;
+}
+
+void QtSnmpPollScheduler::setAgentConcurrency( const int value ) {
+    m_agent_concurrency = qMax( 1, value );
+    for ( auto client : m_agents.keys() ) {
+        startPending( client );
+    }
+}
+
+double QtSnmpPollScheduler::jitter() const {
+    return m_jitter;
+}
+
+void QtSnmpPollScheduler::setJitter( const double value ) {
+    m_jitter = qBound( 0.0, value, 0.5 );
+}
+
+quint64 QtSnmpPollScheduler::overrunCount() const {
+    return m_overrun_count;
+}
+
+qint64 QtSnmpPollScheduler::now() const {
+    return m_clock.elapsed();
+}
+
+void QtSnmpPollScheduler::scheduleNextCycle( const int poll_id, Poll& poll ) {
+    poll.base_time += poll.interval;
+    const auto current_time = now();
+    if ( poll.base_time < current_time ) {
+        // NOTE: the event loop was blocked for more than an interval,
+        //       the missed cycles are not made up
+        const auto missed = ( current_time - poll.base_time ) / poll.interval + 1;
+        poll.base_time += missed * poll.interval;
+    }
+
+    qint64 shift = 0;
+    if ( m_jitter > 0 ) {
+        std::uniform_real_distribution< double > distribution( -m_jitter, m_jitter );
+        shift = std::llround( distribution( m_random ) * poll.interval );
+    }
+    poll.timer = addTimer( poll.base_time + shift, poll_id );
+}
+
+void QtSnmpPollScheduler::onCycleDue( const int poll_id ) {
+    const auto iter = m_polls.find( poll_id );
+    if ( m_polls.end() == iter ) {
+        return;
+    }
+
+    auto& poll = iter.value();
+    scheduleNextCycle( poll_id, poll );
+    if ( poll.client.isNull() ) {
+        return;
+    }
+
+    if ( ( poll.outstanding > 0 ) || poll.is_pending ) {
+        ++m_overrun_count;
+        emit cycleOverrun( poll_id );
+        return;
+    }
+
+    auto& agent = m_agents[ poll.client.data() ];
+    if ( agent.in_flight >= m_agent_concurrency ) {
+        poll.is_pending = true;
+        agent.pending.enqueue( poll_id );
+        return;
+    }
+    startPoll( poll_id );
+}
+
+void QtSnmpPollScheduler::startPoll( const int poll_id ) {
+    auto& poll = m_polls[ poll_id ];
+    Q_ASSERT( ! poll.client.isNull() );
+    Q_ASSERT( 0 == poll.outstanding );
+    ++m_agents[ poll.client.data() ].in_flight;
+    const auto cycle = ++poll.cycle;
+
+    // NOTE: a request dropped by the full queue of the client fails
+    //       at once, and the receivers of the failure may remove the poll,
+    //       so the count is set before the requests and the poll is not
+    //       used after them
+    const QPointer< QtSnmpClient > client = poll.client;
+    switch ( poll.type ) {
+    case GetPoll:
+        poll.outstanding = 1;
+        client->requestValues( poll.prepared, this, resultCallback( poll_id, cycle ) );
+        break;
+    case WalkPoll: {
+        const auto oid_list = poll.oid_list;
+        const auto guard_oid = poll.guard_oid;
+        poll.is_failed = false;
+        poll.discovered.clear();
+        poll.outstanding = oid_list.size();
+        for ( const auto& oid : oid_list ) {
+            if ( ! isCycleRunning( poll_id, cycle ) ) {
+                break;
+            }
+            if ( guard_oid.isEmpty() ) {
+                client->requestSubValues( oid, this, resultCallback( poll_id, cycle ) );
+            } else {
+                client->requestSubValuesIfChanged( oid, guard_oid, this, resultCallback( poll_id, cycle ) );
+            }
+        }
+        break;
+    }
+    case TablePoll:
+        startTablePoll( poll_id );
+        break;
+    }
+}
+
+void QtSnmpPollScheduler::startTablePoll( const int poll_id ) {
+    auto& poll = m_polls[ poll_id ];
+    const QPointer< QtSnmpClient > client = poll.client;
+    const auto cycle = poll.cycle;
+    const bool is_due = ( poll.rediscovery_cycles > 0 )
+                        && ( poll.cycles_since_discovery >= poll.rediscovery_cycles );
+    if ( ! poll.is_discovery_needed && ! is_due ) {
+        ++poll.cycles_since_discovery;
+        poll.outstanding = 1;
+        client->requestValues( poll.instances, this, resultCallback( poll_id, cycle ) );
+        return;
+    }
+
+    poll.is_discovering = true;
+    poll.is_failed = false;
+    poll.discovered.clear();
+    poll.outstanding = poll.oid_list.size();
+    const auto oid_list = poll.oid_list;
+    if ( ! poll.change_oid.isEmpty() ) {
+        // NOTE: the value is read before the walk, so a change
+        //       made during the walk triggers the next one
+        ++poll.outstanding;
+        client->requestValue( poll.change_oid, this, resultCallback( poll_id, cycle, true ) );
+    }
+    for ( const auto& oid : oid_list ) {
+        if ( ! isCycleRunning( poll_id, cycle ) ) {
+            break;
+        }
+        client->requestSubValues( oid, this, resultCallback( poll_id, cycle ) );
+    }
+}
+
+bool QtSnmpPollScheduler::isCycleRunning( const int poll_id,
+                                          const quint64 cycle ) const
+{
+    const auto iter = m_polls.constFind( poll_id );
+    return ( m_polls.constEnd() != iter )
+           && ( cycle == iter->cycle )
+           && ( iter->outstanding > 0 )
+           && ! iter->client.isNull();
+}
+
+QtSnmpCallback QtSnmpPollScheduler::resultCallback( const int poll_id,
+                                                    const quint64 cycle,
+                                                    const bool is_change_value )
+{
+    return [this, poll_id, cycle, is_change_value]( const QtSnmpResult& result ) {
+        onPollResult( poll_id, cycle, is_change_value, result );
+    };
+}
+
+void QtSnmpPollScheduler::onPollResult( const int poll_id,
+                                        const quint64 cycle,
+                                        const bool is_change_value,
+                                        const QtSnmpResult& result )
+{
+    // NOTE: the late results of a removed poll are ignored
+    if ( ! isCycleRunning( poll_id, cycle ) ) {
+        return;
+    }
+
+    auto& poll = m_polls[ poll_id ];
+    QObject*const client = poll.client.data();
+    if ( 0 == --poll.outstanding ) {
+        const auto agent_iter = m_agents.find( client );
+        if ( m_agents.end() != agent_iter ) {
+            --agent_iter->in_flight;
+        }
+    }
+
+    const auto values = result.is_ok ? result.values : QtSnmpDataListPtr();
+    switch ( poll.type ) {
+    case GetPoll:
+        if ( values ) {
+            emit pollResultReady( poll_id, values );
+        } else {
+            emit pollFailed( poll_id );
+        }
+        break;
+    case WalkPoll:
+        finishWalkRequest( poll_id, values );
+        break;
+    case TablePoll:
+        finishTableRequest( poll_id, is_change_value, values );
+        break;
+    }
+    startPending( client );
+}
+
+void QtSnmpPollScheduler::finishWalkRequest( const int poll_id,
+                                             const QtSnmpDataListPtr& values )
+{
+    // NOTE: the walks of a poll are in the queue of one client,
+    //       so their results come in the order of the OIDs
+    auto& poll = m_polls[ poll_id ];
+    if ( ! values ) {
+        poll.is_failed = true;
+    } else if ( ! poll.is_failed ) {
+        poll.discovered.insert( poll.discovered.end(), values->cbegin(), values->cend() );
+    }
+    if ( poll.outstanding > 0 ) {
+        return;
+    }
+
+    if ( poll.is_failed ) {
+        poll.discovered.clear();
+        emit pollFailed( poll_id );
+        return;
+    }
+    auto result = std::make_shared< QtSnmpDataList >();
+    std::swap( *result, poll.discovered );
+    emit pollResultReady( poll_id, result );
+}
+
+void QtSnmpPollScheduler::finishTableRequest( const int poll_id,
+                                              const bool is_change_value,
+                                              const QtSnmpDataListPtr& values )
+{
+    auto& poll = m_polls[ poll_id ];
+    if ( ! poll.is_discovering ) {
+        if ( ! values ) {
+            poll.is_discovery_needed = true;
+            emit pollFailed( poll_id );
+            return;
+        }
+
+        const bool has_change_oid = ! poll.change_oid.isEmpty();
+        if ( values->size() != static_cast< size_t >( poll.instance_count + ( has_change_oid ? 1 : 0 ) ) ) {
+            poll.is_discovery_needed = true;
+        } else if ( has_change_oid && !( values->back() == poll.change_value ) ) {
+            poll.is_discovery_needed = true;
+        } else {
+            poll.is_discovery_needed = std::any_of( values->cbegin(), values->cend(), isMissingValue );
+        }
+        emit pollResultReady( poll_id, values );
+        return;
+    }
+
+    if ( ! values ) {
+        poll.is_failed = true;
+    } else if ( is_change_value ) {
+        poll.change_value = values->empty() ? QtSnmpData() : values->front();
+    } else {
+        poll.discovered.insert( poll.discovered.end(), values->cbegin(), values->cend() );
+    }
+    if ( poll.outstanding > 0 ) {
+        return;
+    }
+
+    poll.is_discovering = false;
+    if ( poll.is_failed ) {
+        poll.discovered.clear();
+        emit pollFailed( poll_id );
+        return;
+    }
+
+    auto result = std::make_shared< QtSnmpDataList >();
+    std::swap( *result, poll.discovered );
+    QStringList oid_list;
+    oid_list.reserve( static_cast< int >( result->size() ) + 1 );
+    for ( const auto& value : *result ) {
+        oid_list << QString::fromLatin1( value.address() );
+    }
+    poll.instance_count = oid_list.size();
+    poll.is_discovery_needed = oid_list.isEmpty();
+    poll.cycles_since_discovery = 0;
+    if ( ! poll.change_oid.isEmpty() ) {
+        oid_list << poll.change_oid;
+        result->push_back( poll.change_value );
+    }
+    poll.instances = QtSnmpPreparedRequest( oid_list );
+    emit instancesDiscovered( poll_id, poll.instance_count );
+    emit pollResultReady( poll_id, result );
+}
+
+void QtSnmpPollScheduler::startPending( QObject*const client ) {
+    // NOTE: the agent is looked up for every poll, since a started poll
+    //       may fail at once and its receivers may add or remove polls
+    while ( true ) {
+        const auto agent_iter = m_agents.find( client );
+        const bool is_idle = ( m_agents.end() == agent_iter ) || agent_iter->pending.isEmpty();
+        if ( is_idle || ( agent_iter->in_flight >= m_agent_concurrency ) ) {
+            return;
+        }
+        const int poll_id = agent_iter->pending.dequeue();
+        const auto poll_iter = m_polls.find( poll_id );
+        if ( ( m_polls.end() == poll_iter ) || ! poll_iter->is_pending ) {
+            continue;
+        }
+        poll_iter->is_pending = false;
+        startPoll( poll_id );
+    }
+}
+
+quint64 QtSnmpPollScheduler::addTimer( const qint64 deadline,
+                                       const int poll_id )
+{
+    return m_transport->addTimer( deadline - now(), [this, poll_id]() { onCycleDue( poll_id ); } );
+}
+
+void QtSnmpPollScheduler::onClientDestroyed( QObject*const client ) {
+    QList< int > poll_list;
+    for ( auto iter = m_polls.cbegin(); iter != m_polls.cend(); ++iter ) {
+        if ( iter->client.isNull() ) {
+            poll_list << iter.key();
+        }
+    }
+    m_agents.remove( client );
+    for ( const int poll_id : poll_list ) {
+        removePoll( poll_id );
+    }
+}
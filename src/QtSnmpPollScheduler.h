@@ -0,0 +1,162 @@
+#pragma once
+
+#include "QtSnmpData.h"
+#include "QtSnmpPreparedRequest.h"
+#include "QtSnmpResult.h"
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPointer>
+#include <QQueue>
+#include <QStringList>
+#include <memory>
+#include <random>
+#include "win_export.h"
+
+class QtSnmpClient;
+namespace qtsnmpclient { class Transport; }
+
+// NOTE: Polls a set of OIDs of an agent periodically. The first cycles of
+//       the polls are spread evenly over their intervals, and every next
+//       cycle is shifted by a random jitter, so many polls with the same
+//       interval do not fire together. A cycle which is due while the
+//       previous one of the same poll is not finished is skipped and
+//       reported as an overrun. The scheduler must live in the thread
+//       of the clients. Its requests deliver their results to it by
+//       callbacks, so they emit no signals of the clients, and a request
+//       dropped by the full queue of a client fails at once.
+//
+//       A table poll walks its OIDs once and then requests the found
+//       instances by GET requests, so a cycle costs one round trip per
+//       get limit of OIDs instead of one per row. The instances are walked
+//       again when a GET request fails or returns a missing instance, when
+//       the value of the change OID (e.g. ifTableLastChange.0 or ifNumber.0)
+//       changes and every rediscovery interval of cycles.
+class WIN_EXPORT QtSnmpPollScheduler : public QObject {
+    Q_OBJECT
+    Q_DISABLE_COPY( QtSnmpPollScheduler )
+public:
+    enum PollType {
+        GetPoll = 0,  // a GET request of all the OIDs
+        WalkPoll = 1, // a walk of every OID
+        TablePoll = 2, // a walk of every OID once, then GET of the instances
+    };
+
+public:
+    explicit QtSnmpPollScheduler( QObject*const parent = nullptr );
+    ~QtSnmpPollScheduler() override;
+
+    int addPoll( QtSnmpClient*const,
+                 const QStringList& oid_list,
+                 const int interval_ms,
+                 const PollType = GetPoll );
+    void removePoll( const int poll_id );
+
+    // NOTE: of a table poll; an empty OID or 0 cycles disables the trigger.
+    //       The value of the change OID is the last one of every result.
+    void setRediscovery( const int poll_id,
+                         const QString& change_oid,
+                         const int rediscovery_cycles = 0 );
+    int instanceCount( const int poll_id ) const;
+
+    // NOTE: of a walk poll; the OIDs are walked again only when the value
+    //       of the guard OID changes, otherwise the cached results are
+    //       reported (see QtSnmpClient::requestSubValuesIfChanged)
+    void setWalkGuard( const int poll_id,
+                       const QString& guard_oid );
+
+    bool hasPoll( const int poll_id ) const;
+    int pollCount() const;
+
+    // NOTE: how many polls of one client may be in progress at once
+    int agentConcurrency() const;
+    void setAgentConcurrency( const int );
+
+    // NOTE: the largest shift of a cycle as a part of the interval,
+    //       from 0 to 0.5
+    double jitter() const;
+    void setJitter( const double );
+
+    quint64 overrunCount() const;
+
+    // NOTE: one of them per cycle; the result of a walk poll has
+    //       the values of all its OIDs in their order, its cycle fails
+    //       if any of the walks fails
+    Q_SIGNAL void pollResultReady( const int poll_id,
+                                   const QtSnmpDataListPtr& );
+    Q_SIGNAL void pollFailed( const int poll_id );
+    Q_SIGNAL void cycleOverrun( const int poll_id );
+    Q_SIGNAL void instancesDiscovered( const int poll_id,
+                                       const int count );
+
+private:
+    struct Poll {
+        QPointer< QtSnmpClient > client;
+        QStringList oid_list;
+        QtSnmpPreparedRequest prepared; // of a GET poll
+        QString guard_oid; // of a walk poll
+        int interval = 0;
+        PollType type = GetPoll;
+        qint64 base_time = 0;
+        quint64 timer = 0;
+        int outstanding = 0;
+        quint64 cycle = 0;
+        bool is_pending = false;
+
+        // NOTE: of a table poll
+        QtSnmpPreparedRequest instances;
+        int instance_count = 0;
+        QString change_oid;
+        QtSnmpData change_value;
+        int rediscovery_cycles = 0;
+        int cycles_since_discovery = 0;
+        bool is_discovery_needed = true;
+        bool is_discovering = false;
+
+        // NOTE: the values collected by the cycle of a walk poll
+        //       or by the discovery of a table poll
+        bool is_failed = false;
+        QtSnmpDataList discovered;
+    };
+
+    struct Agent {
+        int in_flight = 0;
+        QQueue< int > pending;
+    };
+
+    qint64 now() const;
+    void scheduleNextCycle( const int poll_id, Poll& );
+    void onCycleDue( const int poll_id );
+    void startPoll( const int poll_id );
+    void startTablePoll( const int poll_id );
+    bool isCycleRunning( const int poll_id,
+                         const quint64 cycle ) const;
+    QtSnmpCallback resultCallback( const int poll_id,
+                                   const quint64 cycle,
+                                   const bool is_change_value = false );
+    void onPollResult( const int poll_id,
+                       const quint64 cycle,
+                       const bool is_change_value,
+                       const QtSnmpResult& );
+    void finishWalkRequest( const int poll_id,
+                            const QtSnmpDataListPtr& values );
+    void finishTableRequest( const int poll_id,
+                             const bool is_change_value,
+                             const QtSnmpDataListPtr& values );
+    void startPending( QObject*const client );
+    quint64 addTimer( const qint64 deadline,
+                      const int poll_id );
+    Q_SLOT void onClientDestroyed( QObject* );
+
+private:
+    QElapsedTimer m_clock;
+    // NOTE: the cycles are timed by the wheel of the thread's transport
+    std::shared_ptr< qtsnmpclient::Transport > m_transport;
+    std::minstd_rand m_random;
+    QHash< int, Poll > m_polls;
+    QHash< QObject*, Agent > m_agents;
+    int m_last_poll_id = 0;
+    int m_agent_concurrency = 1;
+    double m_jitter = 0.05;
+    quint64 m_overrun_count = 0;
+};
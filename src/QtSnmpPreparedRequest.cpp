@@ -0,0 +1,117 @@
+#include "QtSnmpPreparedRequest.h"
+#include "QtSnmpData.h"
+#include "RequestIdAllocator.h"
+#include "Transport.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+
+namespace {
+    const int snmp_v3 = 3;
+    const int request_id_size = 4;
+
+    QtSnmpPreparedRequest::Chunk makeChunk( const QStringList& names,
+                                            const int protocol_version,
+                                            const QByteArray& community )
+    {
+        // NOTE: any id of the allocator is encoded by 4 bytes,
+        //       so the real ones just overwrite it
+        QtSnmpData request( QtSnmpData::GET_REQUEST_TYPE );
+        request.addChild( QtSnmpData::integer( qtsnmpclient::RequestIdAllocator::MIN_ID ) );
+        request.addChild( QtSnmpData::integer( 0 ) );
+        request.addChild( QtSnmpData::integer( 0 ) );
+        QtSnmpData seq_all_obj = QtSnmpData::sequence();
+        for ( const auto& oid_key : names ) {
+            QtSnmpData seq_obj_info = QtSnmpData::sequence();
+            seq_obj_info.addChild( QtSnmpData::oid( oid_key.toLatin1() ) );
+            seq_obj_info.addChild( QtSnmpData::null() );
+            seq_all_obj.addChild( seq_obj_info );
+        }
+        request.addChild( seq_all_obj );
+
+        auto message = QtSnmpData::sequence();
+        message.addChild( QtSnmpData::integer( protocol_version ) );
+        message.addChild( QtSnmpData::string( community ) );
+        message.addChild( request );
+
+        QtSnmpPreparedRequest::Chunk chunk;
+        chunk.datagram = message.makeSnmpChunk();
+        chunk.oid_count = names.size();
+        int length = 0;
+        const bool ok = qtsnmpclient::Transport::findMessageId( chunk.datagram,
+                                                                &chunk.request_id_offset,
+                                                                &length );
+        Q_ASSERT( ok && ( request_id_size == length ) );
+        Q_UNUSED( ok );
+        Q_UNUSED( length );
+        return chunk;
+    }
+}
+
+class QtSnmpPreparedRequest::Data {
+    Q_DISABLE_COPY( Data )
+public:
+    explicit Data( const QStringList& list )
+        : oid_list( list )
+    {
+    }
+
+    struct Encoding {
+        int protocol_version = 0;
+        QByteArray community;
+        int get_request_limit = 0;
+        ChunkListPtr chunks;
+    };
+
+    const QStringList oid_list;
+    QMutex mutex;
+    QVector< Encoding > encodings;
+};
+
+QtSnmpPreparedRequest::QtSnmpPreparedRequest( const QStringList& oid_list )
+    : m_data( std::make_shared< Data >( oid_list ) )
+{
+}
+
+bool QtSnmpPreparedRequest::isNull() const {
+    return ! m_data || m_data->oid_list.isEmpty();
+}
+
+QStringList QtSnmpPreparedRequest::oidList() const {
+    return m_data ? m_data->oid_list : QStringList();
+}
+
+QtSnmpPreparedRequest::ChunkListPtr QtSnmpPreparedRequest::encode( const int protocol_version,
+                                                                   const QByteArray& community,
+                                                                   const int get_request_limit ) const
+{
+    if ( isNull() || ( snmp_v3 == protocol_version ) ) {
+        return ChunkListPtr();
+    }
+
+    QMutexLocker locker( &m_data->mutex );
+    for ( const auto& encoding : m_data->encodings ) {
+        if ( ( protocol_version == encoding.protocol_version )
+             && ( get_request_limit == encoding.get_request_limit )
+             && ( community == encoding.community ) )
+        {
+            return encoding.chunks;
+        }
+    }
+
+    const auto& oid_list = m_data->oid_list;
+    const int step = ( get_request_limit > 0 ) ? get_request_limit : oid_list.size();
+    auto chunks = std::make_shared< ChunkList >();
+    chunks->reserve( static_cast< size_t >( ( oid_list.size() + step - 1 ) / step ) );
+    for ( int pos = 0; pos < oid_list.size(); pos += step ) {
+        chunks->push_back( makeChunk( oid_list.mid( pos, step ), protocol_version, community ) );
+    }
+
+    Data::Encoding encoding;
+    encoding.protocol_version = protocol_version;
+    encoding.community = community;
+    encoding.get_request_limit = get_request_limit;
+    encoding.chunks = chunks;
+    m_data->encodings.append( encoding );
+    return encoding.chunks;
+}
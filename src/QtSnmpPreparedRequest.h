@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QByteArray>
+#include <QMetaType>
+#include <QStringList>
+#include <memory>
+#include <vector>
+#include "win_export.h"
+
+// NOTE: A GET request of a fixed set of OIDs which is sent again and again
+//       (e.g. by a poll). Its PDUs are encoded once for every version,
+//       community and limit of OIDs per request they are sent with, a request
+//       only copies them and writes its request id. The copies of a prepared
+//       request share the encodings, so the clients polling the same OIDs
+//       with the same settings encode them once. SNMPv3 messages are encoded
+//       for every request as usual.
+class WIN_EXPORT QtSnmpPreparedRequest {
+public:
+    // NOTE: one GET request of the OIDs from the limit
+    struct Chunk {
+        QByteArray datagram;
+        int request_id_offset = -1; // 4 bytes of the request id
+        int oid_count = 0;
+    };
+    typedef std::vector< Chunk > ChunkList;
+    typedef std::shared_ptr< const ChunkList > ChunkListPtr;
+
+public:
+    QtSnmpPreparedRequest() = default;
+    explicit QtSnmpPreparedRequest( const QStringList& oid_list );
+
+    bool isNull() const;
+    QStringList oidList() const;
+
+    // NOTE: thread safe, returns null for SNMPv3
+    ChunkListPtr encode( const int protocol_version,
+                         const QByteArray& community,
+                         const int get_request_limit ) const;
+
+private:
+    class Data;
+    std::shared_ptr< Data > m_data;
+};
+
+Q_DECLARE_METATYPE( QtSnmpPreparedRequest )
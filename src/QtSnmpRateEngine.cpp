@@ -0,0 +1,189 @@
+#include "QtSnmpRateEngine.h"
+#include <algorithm>
+
+namespace {
+
+    const quint64 COUNTER32_MASK = Q_UINT64_C( 0xFFFFFFFF );
+    const quint64 COUNTER64_MASK = ~Q_UINT64_C( 0 );
+    const double TICKS_PER_SECOND = 100.0;
+
+    bool isCounter( const int type ) {
+        return ( QtSnmpData::COUNTER_TYPE == type ) || ( QtSnmpData::COUNTER64_TYPE == type );
+    }
+
+} // anonymous namespace
+
+std::vector< QtSnmpRateEngine::Rate > QtSnmpRateEngine::update( const QString& agent,
+                                                                const quint32 sys_uptime,
+                                                                const QtSnmpDataList& counters )
+{
+    auto& state = updateAgent( agent, sys_uptime );
+
+    std::vector< Rate > result;
+    result.reserve( counters.size() );
+    for ( const auto& item : counters ) {
+        result.emplace_back();
+        auto& rate = result.back();
+        rate.oid = item.address();
+        if ( ! isCounter( item.type() ) || item.data().isEmpty() ) {
+            rate.status = RATE_NOT_COUNTER;
+            continue;
+        }
+
+        Sample sample;
+        sample.value = static_cast< quint64 >( item.longLongValue() );
+        sample.uptime = sys_uptime;
+        sample.epoch = state.epoch;
+        sample.is_64bit = ( QtSnmpData::COUNTER64_TYPE == item.type() );
+
+        auto iter = state.counters.find( rate.oid );
+        if ( state.counters.end() == iter ) {
+            state.counters.insert( rate.oid, sample );
+            continue;
+        }
+
+        auto& prev = iter.value();
+        if ( sys_uptime == prev.uptime ) {
+            // NOTE: the same poll is reported twice, there is no interval
+            continue;
+        }
+
+        bool is_continuous = ( prev.epoch == state.epoch );
+        is_continuous = is_continuous && ( prev.is_64bit == sample.is_64bit );
+        is_continuous = is_continuous && ( sys_uptime > prev.uptime );
+        is_continuous = is_continuous && ( ! sample.is_64bit || ( sample.value >= prev.value ) );
+        if ( is_continuous ) {
+            const auto mask = sample.is_64bit ? COUNTER64_MASK : COUNTER32_MASK;
+            rate.delta = ( sample.value - prev.value ) & mask;
+            rate.per_second = static_cast< double >( rate.delta ) * TICKS_PER_SECOND /
+                              static_cast< double >( sys_uptime - prev.uptime );
+            rate.status = RATE_VALID;
+        } else {
+            rate.status = RATE_DISCONTINUITY;
+        }
+        prev = sample;
+    }
+    return result;
+}
+
+QtSnmpRateEngine::ColumnRates QtSnmpRateEngine::update( const QString& agent,
+                                                        const quint32 sys_uptime,
+                                                        const QtSnmpTable& table,
+                                                        const int column )
+{
+    const auto row_count = static_cast< size_t >( table.rowCount() );
+    ColumnRates rates;
+    rates.per_second.resize( row_count, 0 );
+    rates.delta.resize( row_count, 0 );
+    rates.status.resize( row_count, RATE_FIRST_SAMPLE );
+
+    const int type = table.columnType( column );
+    if ( ! isCounter( type ) ) {
+        std::fill( rates.status.begin(), rates.status.end(), static_cast< quint8 >( RATE_NOT_COUNTER ) );
+        return rates;
+    }
+
+    auto& state = updateAgent( agent, sys_uptime );
+    const auto key = table.entryOid() + '.' + QByteArray::number( table.columnId( column ) );
+    auto& prev = state.columns[ key ];
+    if ( ( sys_uptime == prev.uptime ) && ! prev.values.empty() ) {
+        return rates;
+    }
+
+    const bool is_64bit = ( QtSnmpData::COUNTER64_TYPE == type );
+    const auto& values = table.uint64Column( column );
+    const auto& present = table.presence( column );
+
+    bool is_continuous = ! prev.values.empty();
+    is_continuous = is_continuous && ( prev.epoch == state.epoch );
+    is_continuous = is_continuous && ( prev.is_64bit == is_64bit );
+    is_continuous = is_continuous && ( sys_uptime > prev.uptime );
+
+    if ( is_continuous ) {
+        const auto mask = is_64bit ? COUNTER64_MASK : COUNTER32_MASK;
+        const quint8 check_reset = is_64bit ? 1 : 0;
+        const double scale = TICKS_PER_SECOND / static_cast< double >( sys_uptime - prev.uptime );
+        auto computeRow = [&]( const size_t row, const size_t prev_row ) {
+            const quint64 delta = ( values[ row ] - prev.values[ prev_row ] ) & mask;
+            const quint8 is_reset = check_reset & static_cast< quint8 >( values[ row ] < prev.values[ prev_row ] );
+            const quint8 is_known = present[ row ] & prev.present[ prev_row ];
+            const quint8 status = is_known ? ( is_reset ? RATE_DISCONTINUITY : RATE_VALID )
+                                           : RATE_FIRST_SAMPLE;
+            const bool is_valid = ( RATE_VALID == status );
+            rates.delta[ row ] = is_valid ? delta : 0;
+            rates.per_second[ row ] = is_valid ? static_cast< double >( delta ) * scale : 0;
+            rates.status[ row ] = status;
+        };
+
+        if ( prev.row_indexes == table.rowIndexes() ) {
+            // NOTE: the same rows as the last time, so the whole column
+            //       is processed as plain arrays
+            for ( size_t row = 0; row < row_count; ++row ) {
+                computeRow( row, row );
+            }
+        } else {
+            QHash< QByteArray, size_t > prev_rows;
+            prev_rows.reserve( static_cast< int >( prev.row_indexes.size() ) );
+            for ( size_t row = 0; row < prev.row_indexes.size(); ++row ) {
+                prev_rows.insert( prev.row_indexes[ row ], row );
+            }
+            const auto& row_indexes = table.rowIndexes();
+            for ( size_t row = 0; row < row_count; ++row ) {
+                const auto iter = prev_rows.constFind( row_indexes[ row ] );
+                if ( prev_rows.constEnd() != iter ) {
+                    computeRow( row, iter.value() );
+                }
+            }
+        }
+    } else if ( ! prev.values.empty() ) {
+        for ( size_t row = 0; row < row_count; ++row ) {
+            rates.status[ row ] = present[ row ] ? RATE_DISCONTINUITY : RATE_FIRST_SAMPLE;
+        }
+    }
+
+    prev.row_indexes = table.rowIndexes();
+    prev.values = values;
+    prev.present = present;
+    prev.uptime = sys_uptime;
+    prev.epoch = state.epoch;
+    prev.is_64bit = is_64bit;
+    return rates;
+}
+
+void QtSnmpRateEngine::removeAgent( const QString& agent ) {
+    m_agents.remove( agent );
+}
+
+void QtSnmpRateEngine::clear() {
+    m_agents.clear();
+}
+
+int QtSnmpRateEngine::agentCount() const {
+    return m_agents.size();
+}
+
+int QtSnmpRateEngine::sampleCount() const {
+    int count = 0;
+    for ( const auto& state : m_agents ) {
+        count += state.counters.size();
+        for ( const auto& samples : state.columns ) {
+            count += static_cast< int >( samples.values.size() );
+        }
+    }
+    return count;
+}
+
+QtSnmpRateEngine::Agent& QtSnmpRateEngine::updateAgent( const QString& agent,
+                                                        const quint32 sys_uptime )
+{
+    auto iter = m_agents.find( agent );
+    if ( m_agents.end() == iter ) {
+        iter = m_agents.insert( agent, Agent() );
+    } else if ( sys_uptime < iter->uptime ) {
+        // NOTE: also happens when sysUpTime wraps after 497 days,
+        //       it is handled as a restart of the agent
+        ++iter->epoch;
+    }
+    iter->uptime = sys_uptime;
+    return iter.value();
+}
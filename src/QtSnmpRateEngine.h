@@ -0,0 +1,88 @@
+#pragma once
+
+#include "QtSnmpData.h"
+#include "QtSnmpTable.h"
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <vector>
+#include "win_export.h"
+
+// NOTE: Turns successive samples of Counter32/Counter64 values into rates.
+//       The interval between two samples is taken from sysUpTime.0
+//       (TimeTicks, hundredths of a second) of the same poll, so the poll
+//       jitter does not affect the rates. A sysUpTime that goes back means
+//       the agent was restarted: all its counters are discontinuous then.
+//       A Counter32 which goes back is considered as wrapped once,
+//       a Counter64 which goes back is considered as reset.
+class WIN_EXPORT QtSnmpRateEngine {
+public:
+    enum Status : quint8 {
+        RATE_VALID = 0,
+        RATE_FIRST_SAMPLE,   // there is no previous sample yet
+        RATE_DISCONTINUITY,  // the agent or the counter was reset
+        RATE_NOT_COUNTER,    // the value is not a counter
+    };
+
+    struct Rate {
+        QByteArray oid;
+        double per_second = 0;
+        quint64 delta = 0;
+        Status status = RATE_FIRST_SAMPLE;
+    };
+
+    struct ColumnRates {
+        // NOTE: every array has the row count of the table
+        std::vector< double > per_second;
+        std::vector< quint64 > delta;
+        std::vector< quint8 > status;
+    };
+
+public:
+    QtSnmpRateEngine() = default;
+
+    std::vector< Rate > update( const QString& agent,
+                                const quint32 sys_uptime,
+                                const QtSnmpDataList& counters );
+
+    ColumnRates update( const QString& agent,
+                        const quint32 sys_uptime,
+                        const QtSnmpTable& table,
+                        const int column );
+
+    void removeAgent( const QString& agent );
+    void clear();
+
+    int agentCount() const;
+    int sampleCount() const;
+
+private:
+    struct Sample {
+        quint64 value = 0;
+        quint32 uptime = 0;
+        quint32 epoch = 0;
+        bool is_64bit = false;
+    };
+
+    struct ColumnSamples {
+        std::vector< QByteArray > row_indexes;
+        std::vector< quint64 > values;
+        std::vector< quint8 > present;
+        quint32 uptime = 0;
+        quint32 epoch = 0;
+        bool is_64bit = false;
+    };
+
+    struct Agent {
+        quint32 uptime = 0;
+        // NOTE: is increased every time the agent restarts
+        quint32 epoch = 0;
+        QHash< QByteArray, Sample > counters;
+        QHash< QByteArray, ColumnSamples > columns;
+    };
+
+    Agent& updateAgent( const QString& agent, const quint32 sys_uptime );
+
+private:
+    QHash< QString, Agent > m_agents;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "QtSnmpData.h"
+#include "QtSnmpTable.h"
+#include <functional>
+#include <vector>
+#include "win_export.h"
+
+// NOTE: The outcome of one request passed to its callback. A failed request
+//       (no response, an error response or dropped by the full queue)
+//       has neither values nor table.
+struct WIN_EXPORT QtSnmpResult {
+    enum Error {
+        NoError = 0,
+        RequestFailed,
+        OidNotIncreasing,  // the agent has returned the same or a lower OID in a walk
+        WalkLimitExceeded, // the walk has more rows or lasts longer than the limits
+        SetFailed,         // some values of setValues have not been set, see set_status
+    };
+
+    // NOTE: set_status of a value which is not set only because
+    //       another value of the same PDU has failed
+    enum { SetNotApplied = -1 };
+
+    qint32 request_id = 0;
+    bool is_ok = false;
+    int error = NoError;
+    QtSnmpDataListPtr values; // requestValues, requestSubValues, setValue, setValues
+    QtSnmpTablePtr table;     // requestTable
+    std::vector< int > set_status; // setValues: the error status of every value (0 is set)
+};
+
+typedef std::function< void( const QtSnmpResult& ) > QtSnmpCallback;
@@ -0,0 +1,334 @@
+#include "QtSnmpTable.h"
+
+namespace {
+
+    QtSnmpTable::ColumnKind kindOf( const int type ) {
+        switch ( type ) {
+        case QtSnmpData::INTEGER_TYPE:
+            return QtSnmpTable::INT64_COLUMN;
+        case QtSnmpData::COUNTER_TYPE:
+        case QtSnmpData::GAUGE_TYPE:
+        case QtSnmpData::TIME_TICKS_TYPE:
+        case QtSnmpData::COUNTER64_TYPE:
+            return QtSnmpTable::UINT64_COLUMN;
+        default:
+            return QtSnmpTable::BYTES_COLUMN;
+        }
+    }
+
+    bool decodeUnsigned( const QByteArray& data, quint64*const result ) {
+        const int size = data.size();
+        int pos = 0;
+        while ( ( pos < size - 1 ) && ( 0 == data.at( pos ) ) ) {
+            ++pos;
+        }
+        if ( ( 0 == size ) || ( size - pos > 8 ) ) {
+            return false;
+        }
+        quint64 value = 0;
+        for ( ; pos < size; ++pos ) {
+            value = ( value << 8 ) | static_cast< quint8 >( data.at( pos ) );
+        }
+        *result = value;
+        return true;
+    }
+
+    bool decodeSigned( const QByteArray& data, qint64*const result ) {
+        const int size = data.size();
+        if ( ( 0 == size ) || ( size > 8 ) ) {
+            return false;
+        }
+        quint64 value = ( data.at( 0 ) & 0x80 ) ? ~static_cast< quint64 >( 0 ) : 0;
+        for ( int i = 0; i < size; ++i ) {
+            value = ( value << 8 ) | static_cast< quint8 >( data.at( i ) );
+        }
+        *result = static_cast< qint64 >( value );
+        return true;
+    }
+
+    QByteArray encodeUnsigned( const quint64 value ) {
+        QByteArray data;
+        quint64 rest = value;
+        do {
+            data.prepend( static_cast< char >( rest & 0xFF ) );
+            rest >>= 8;
+        } while ( rest );
+        if ( data.at( 0 ) & 0x80 ) {
+            data.prepend( '\0' );
+        }
+        return data;
+    }
+
+    QByteArray encodeSigned( const qint64 value ) {
+        QByteArray data;
+        qint64 rest = value;
+        for ( ;; ) {
+            data.prepend( static_cast< char >( rest & 0xFF ) );
+            const bool is_negative_byte = data.at( 0 ) & 0x80;
+            rest >>= 8;
+            if ( ( 0 == rest ) && ! is_negative_byte ) {
+                break;
+            }
+            if ( ( -1 == rest ) && is_negative_byte ) {
+                break;
+            }
+        }
+        return data;
+    }
+
+    // NOTE: splits ".<column>.<row index>" into the column id and
+    //       the row index (without the leading dot)
+    bool splitSuffix( const QByteArray& suffix,
+                      quint32*const column_id,
+                      QByteArray*const row_index )
+    {
+        if ( ( suffix.size() < 4 ) || ( '.' != suffix.at( 0 ) ) ) {
+            return false;
+        }
+        const int dot_pos = suffix.indexOf( '.', 1 );
+        if ( ( dot_pos < 2 ) || ( dot_pos == suffix.size() - 1 ) ) {
+            return false;
+        }
+        bool ok = false;
+        *column_id = QByteArray::fromRawData( suffix.constData() + 1, dot_pos - 1 ).toUInt( &ok );
+        *row_index = suffix.mid( dot_pos + 1 );
+        return ok;
+    }
+
+} // anonymous namespace
+
+void QtSnmpTable::Column::resize( const size_t size ) {
+    present.resize( size, 0 );
+    switch ( kind ) {
+    case INT64_COLUMN:
+        int64_values.resize( size, 0 );
+        break;
+    case UINT64_COLUMN:
+        uint64_values.resize( size, 0 );
+        break;
+    case BYTES_COLUMN:
+        offsets.resize( size, 0 );
+        sizes.resize( size, 0 );
+        break;
+    }
+}
+
+QtSnmpTable::QtSnmpTable( const QByteArray& entry_oid )
+    : m_entry_oid( entry_oid )
+{
+}
+
+QtSnmpTable QtSnmpTable::fromList( const QByteArray& entry_oid,
+                                   const QtSnmpDataList& list ) // static
+{
+    QtSnmpTable table( entry_oid );
+    for ( const auto& item : list ) {
+        table.append( item );
+    }
+    return table;
+}
+
+QByteArray QtSnmpTable::entryOid() const {
+    return m_entry_oid;
+}
+
+bool QtSnmpTable::append( const QtSnmpData& item ) {
+    const auto address = item.address();
+    const int prefix_size = m_entry_oid.size();
+    if ( ! address.startsWith( m_entry_oid ) ) {
+        return false;
+    }
+
+    quint32 column_id = 0;
+    QByteArray row_index;
+    const auto suffix = QByteArray::fromRawData( address.constData() + prefix_size,
+                                                 address.size() - prefix_size );
+    if ( ! splitSuffix( suffix, &column_id, &row_index ) ) {
+        return false;
+    }
+
+    int column = findColumn( column_id );
+    if ( -1 == column ) {
+        column = addColumn( column_id, item.type() );
+    }
+    auto& col = m_columns[ static_cast< size_t >( column ) ];
+    if ( col.kind != kindOf( item.type() ) ) {
+        return false;
+    }
+
+    const auto& data = item.data();
+    qint64 int64_value = 0;
+    quint64 uint64_value = 0;
+    switch ( col.kind ) {
+    case INT64_COLUMN:
+        if ( ! decodeSigned( data, &int64_value ) ) {
+            return false;
+        }
+        break;
+    case UINT64_COLUMN:
+        if ( ! decodeUnsigned( data, &uint64_value ) ) {
+            return false;
+        }
+        break;
+    case BYTES_COLUMN:
+        break;
+    }
+
+    int row = findRow( row_index );
+    if ( -1 == row ) {
+        row = addRow( row_index );
+    }
+    const auto pos = static_cast< size_t >( row );
+    col.present[ pos ] = 1;
+    switch ( col.kind ) {
+    case INT64_COLUMN:
+        col.int64_values[ pos ] = int64_value;
+        break;
+    case UINT64_COLUMN:
+        col.uint64_values[ pos ] = uint64_value;
+        break;
+    case BYTES_COLUMN:
+        col.offsets[ pos ] = static_cast< quint32 >( col.blob.size() );
+        col.sizes[ pos ] = static_cast< quint32 >( data.size() );
+        col.blob.append( data );
+        break;
+    }
+    return true;
+}
+
+int QtSnmpTable::rowCount() const {
+    return static_cast< int >( m_row_indexes.size() );
+}
+
+int QtSnmpTable::columnCount() const {
+    return static_cast< int >( m_columns.size() );
+}
+
+QByteArray QtSnmpTable::rowIndex( const int row ) const {
+    Q_ASSERT( ( row >= 0 ) && ( row < rowCount() ) );
+    return m_row_indexes.at( static_cast< size_t >( row ) );
+}
+
+const std::vector< QByteArray >& QtSnmpTable::rowIndexes() const {
+    return m_row_indexes;
+}
+
+int QtSnmpTable::findRow( const QByteArray& row_index ) const {
+    return m_row_by_index.value( row_index, -1 );
+}
+
+quint32 QtSnmpTable::columnId( const int column ) const {
+    return columnAt( column ).id;
+}
+
+int QtSnmpTable::findColumn( const quint32 column_id ) const {
+    // NOTE: tables have a few tens of columns at most
+    for ( size_t i = 0; i < m_columns.size(); ++i ) {
+        if ( column_id == m_columns[ i ].id ) {
+            return static_cast< int >( i );
+        }
+    }
+    return -1;
+}
+
+int QtSnmpTable::columnType( const int column ) const {
+    return columnAt( column ).type;
+}
+
+QtSnmpTable::ColumnKind QtSnmpTable::columnKind( const int column ) const {
+    return columnAt( column ).kind;
+}
+
+bool QtSnmpTable::hasValue( const int row, const int column ) const {
+    Q_ASSERT( ( row >= 0 ) && ( row < rowCount() ) );
+    return columnAt( column ).present.at( static_cast< size_t >( row ) );
+}
+
+const std::vector< quint8 >& QtSnmpTable::presence( const int column ) const {
+    return columnAt( column ).present;
+}
+
+const std::vector< qint64 >& QtSnmpTable::int64Column( const int column ) const {
+    const auto& col = columnAt( column );
+    Q_ASSERT( INT64_COLUMN == col.kind );
+    return col.int64_values;
+}
+
+const std::vector< quint64 >& QtSnmpTable::uint64Column( const int column ) const {
+    const auto& col = columnAt( column );
+    Q_ASSERT( UINT64_COLUMN == col.kind );
+    return col.uint64_values;
+}
+
+QByteArray QtSnmpTable::bytesValue( const int row, const int column ) const {
+    Q_ASSERT( ( row >= 0 ) && ( row < rowCount() ) );
+    const auto& col = columnAt( column );
+    Q_ASSERT( BYTES_COLUMN == col.kind );
+    const auto pos = static_cast< size_t >( row );
+    return col.blob.mid( static_cast< int >( col.offsets.at( pos ) ),
+                         static_cast< int >( col.sizes.at( pos ) ) );
+}
+
+QtSnmpData QtSnmpTable::value( const int row, const int column ) const {
+    if ( ! hasValue( row, column ) ) {
+        return QtSnmpData();
+    }
+
+    const auto& col = columnAt( column );
+    const auto pos = static_cast< size_t >( row );
+    QByteArray data;
+    switch ( col.kind ) {
+    case INT64_COLUMN:
+        data = encodeSigned( col.int64_values.at( pos ) );
+        break;
+    case UINT64_COLUMN:
+        data = encodeUnsigned( col.uint64_values.at( pos ) );
+        break;
+    case BYTES_COLUMN:
+        data = bytesValue( row, column );
+        break;
+    }
+
+    QtSnmpData result( col.type, data );
+    result.setAddress( m_entry_oid + '.' + QByteArray::number( col.id ) + '.' + rowIndex( row ) );
+    return result;
+}
+
+QtSnmpDataList QtSnmpTable::toList() const {
+    QtSnmpDataList list;
+    list.reserve( m_columns.size() * m_row_indexes.size() );
+    for ( int column = 0; column < columnCount(); ++column ) {
+        for ( int row = 0; row < rowCount(); ++row ) {
+            if ( hasValue( row, column ) ) {
+                list.push_back( value( row, column ) );
+            }
+        }
+    }
+    return list;
+}
+
+int QtSnmpTable::addRow( const QByteArray& row_index ) {
+    const int row = rowCount();
+    m_row_indexes.push_back( row_index );
+    // NOTE: the hash key shares the data of the stored index
+    m_row_by_index.insert( m_row_indexes.back(), row );
+    for ( auto& col : m_columns ) {
+        col.resize( m_row_indexes.size() );
+    }
+    return row;
+}
+
+int QtSnmpTable::addColumn( const quint32 id, const int type ) {
+    Column col;
+    col.id = id;
+    col.type = type;
+    col.kind = kindOf( type );
+    col.resize( m_row_indexes.size() );
+    m_columns.push_back( std::move( col ) );
+    return columnCount() - 1;
+}
+
+const QtSnmpTable::Column& QtSnmpTable::columnAt( const int column ) const {
+    Q_ASSERT( ( column >= 0 ) && ( column < columnCount() ) );
+    return m_columns.at( static_cast< size_t >( column ) );
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "QtSnmpData.h"
+#include <QByteArray>
+#include <QHash>
+#include <QMetaType>
+#include <memory>
+#include <vector>
+#include "win_export.h"
+
+// NOTE: A column-oriented result of a table walk. The OID of every value
+//       is split into <entry oid>.<column>.<row index>; the row index is
+//       stored once per row and the values are kept in per-column typed
+//       arrays, so a column can be aggregated as a plain array of numbers.
+//       A column is filled with zeros (or empty strings) where an agent
+//       has no value, use hasValue() to tell them apart.
+class WIN_EXPORT QtSnmpTable {
+public:
+    enum ColumnKind {
+        INT64_COLUMN,   // INTEGER
+        UINT64_COLUMN,  // Counter32, Gauge32, TimeTicks, Counter64
+        BYTES_COLUMN,   // everything else, as raw BER contents
+    };
+
+public:
+    QtSnmpTable() = default;
+    explicit QtSnmpTable( const QByteArray& entry_oid );
+
+    static QtSnmpTable fromList( const QByteArray& entry_oid,
+                                 const QtSnmpDataList& );
+
+    QByteArray entryOid() const;
+
+    // NOTE: returns false if the value is not placed under the entry oid
+    //       or its type does not fit the kind of the column.
+    bool append( const QtSnmpData& );
+
+    int rowCount() const;
+    int columnCount() const;
+
+    QByteArray rowIndex( const int row ) const;
+    const std::vector< QByteArray >& rowIndexes() const;
+    int findRow( const QByteArray& row_index ) const;
+
+    quint32 columnId( const int column ) const;
+    int findColumn( const quint32 column_id ) const;
+    int columnType( const int column ) const;
+    ColumnKind columnKind( const int column ) const;
+
+    bool hasValue( const int row, const int column ) const;
+    const std::vector< quint8 >& presence( const int column ) const;
+
+    // NOTE: every array has rowCount() items
+    const std::vector< qint64 >& int64Column( const int column ) const;
+    const std::vector< quint64 >& uint64Column( const int column ) const;
+    QByteArray bytesValue( const int row, const int column ) const;
+
+    QtSnmpData value( const int row, const int column ) const;
+    QtSnmpDataList toList() const;
+
+private:
+    struct Column {
+        quint32 id = 0;
+        int type = QtSnmpData::INVALID_TYPE;
+        ColumnKind kind = BYTES_COLUMN;
+        std::vector< quint8 > present;
+        std::vector< qint64 > int64_values;
+        std::vector< quint64 > uint64_values;
+        // NOTE: byte values of all rows share one blob
+        QByteArray blob;
+        std::vector< quint32 > offsets;
+        std::vector< quint32 > sizes;
+
+        void resize( const size_t );
+    };
+
+    int addRow( const QByteArray& row_index );
+    int addColumn( const quint32 id, const int type );
+    const Column& columnAt( const int column ) const;
+
+private:
+    QByteArray m_entry_oid;
+    std::vector< QByteArray > m_row_indexes;
+    QHash< QByteArray, int > m_row_by_index;
+    std::vector< Column > m_columns;
+};
+
+typedef std::shared_ptr< const QtSnmpTable > QtSnmpTablePtr;
+
+Q_DECLARE_METATYPE( QtSnmpTablePtr )
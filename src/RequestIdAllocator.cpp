@@ -0,0 +1,44 @@
+#include "RequestIdAllocator.h"
+#include <QRandomGenerator>
+
+namespace qtsnmpclient {
+
+qint32 RequestIdAllocator::allocate() {
+    while ( true ) {
+        // NOTE: the values below MIN_ID are skipped rather than folded,
+        //       so the ids stay uniform
+        const auto id = static_cast< qint32 >( nextRandom() & MAX_ID );
+        if ( ( id >= MIN_ID ) && ! m_outstanding_ids.contains( id ) ) {
+            m_outstanding_ids.insert( id );
+            return id;
+        }
+    }
+}
+
+bool RequestIdAllocator::reserve( const qint32 id ) {
+    if ( m_outstanding_ids.contains( id ) ) {
+        return false;
+    }
+    m_outstanding_ids.insert( id );
+    return true;
+}
+
+void RequestIdAllocator::release( const qint32 id ) {
+    m_outstanding_ids.remove( id );
+}
+
+bool RequestIdAllocator::isOutstanding( const qint32 id ) const {
+    return m_outstanding_ids.contains( id );
+}
+
+quint32 RequestIdAllocator::nextRandom() {
+    // NOTE: every value of the system generator may be a system call,
+    //       so they are taken by batches
+    if ( 0 == m_random_count ) {
+        QRandomGenerator::system()->fillRange( m_random_batch );
+        m_random_count = static_cast< int >( sizeof( m_random_batch ) / sizeof( m_random_batch[ 0 ] ) );
+    }
+    return m_random_batch[ --m_random_count ];
+}
+
+} // namespace qtsnmpclient
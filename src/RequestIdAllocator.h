@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QSet>
+
+namespace qtsnmpclient {
+
+// NOTE: The request ids of one socket (see Transport) are unique among its
+//       outstanding requests, so the sessions sharing it have no cross-talk.
+//       The ids only have to be unique per socket, so every thread has its own
+//       allocator and the threads never contend for one. The ids are values
+//       of the system's cryptographically secure generator from [MIN_ID, MAX_ID],
+//       so an off-path attacker can't predict them from the observed ones, and
+//       each of them is encoded by 4 bytes exactly.
+//       The allocator is used by the thread of its transport only.
+class RequestIdAllocator {
+    Q_DISABLE_COPY( RequestIdAllocator )
+public:
+    enum : qint32 {
+        MIN_ID = 0x00800000,
+        MAX_ID = 0x7FFFFFFF,
+    };
+
+    RequestIdAllocator() = default;
+
+    qint32 allocate();
+    // NOTE: takes an id allocated by another allocator (of the thread
+    //       a session has left), false if it is outstanding here
+    bool reserve( const qint32 id );
+    void release( const qint32 id );
+    bool isOutstanding( const qint32 id ) const;
+
+private:
+    quint32 nextRandom();
+
+private:
+    QSet< qint32 > m_outstanding_ids;
+    quint32 m_random_batch[ 64 ];
+    int m_random_count = 0;
+};
+
+} // namespace qtsnmpclient
@@ -8,30 +8,41 @@ RequestSubValuesJob::RequestSubValuesJob( Session*const session,
                                                   const QString& base_oid )
     : AbstractJob( session, id )
     , m_base_oid( base_oid )
+    , m_cursor( base_oid.toLatin1() )
 {
 }
 
 void RequestSubValuesJob::start() {
+    m_cursor.start( m_session->walkRowLimit(), qint64( m_session->walkTimeLimit() ) * 1000, Metrics::now() );
     m_session->sendRequestGetNextValue( m_base_oid );
 }
 
-void RequestSubValuesJob::processData( const QtSnmpDataList& values,
+void RequestSubValuesJob::processData( QtSnmpDataList&& values,
                                        const QList< ErrorResponse >& )
 {
     if ( 0 == values.size() ) {
-        m_session->completeWork( values );
+        m_session->completeWork( std::move( values ) );
         return;
     }
 
-    const auto& value = values.at( 0 );
-    const auto& oid = value.address();
-    bool request_next_value = ( 1 == values.size() );
-    request_next_value = request_next_value && ( 0 == oid.indexOf( m_base_oid + "." ) );
-    if ( request_next_value ) {
-        m_found.push_back( value );
+    auto& value = values.front();
+    const auto step = ( 1 == values.size() ) ? m_cursor.step( value, Metrics::now() ) : WalkCursor::END;
+    switch ( step ) {
+    case WalkCursor::NEXT: {
+        const auto oid = value.address();
+        m_found.push_back( std::move( value ) );
         m_session->sendRequestGetNextValue( oid );
-    } else {
-        m_session->completeWork( m_found );
+        break;
+    }
+    case WalkCursor::END:
+        m_session->completeWork( std::move( m_found ) );
+        break;
+    case WalkCursor::NOT_INCREASING:
+        m_session->failWork( QtSnmpResult::OidNotIncreasing );
+        break;
+    case WalkCursor::LIMIT_EXCEEDED:
+        m_session->failWork( QtSnmpResult::WalkLimitExceeded );
+        break;
     }
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AbstractJob.h"
+#include "WalkCursor.h"
 
 namespace qtsnmpclient {
 
@@ -11,11 +12,12 @@ public:
                                   const qint32 id,
                                   const QString& base_oid );
     virtual void start() override final;
-    virtual void processData( const QtSnmpDataList&, const QList< ErrorResponse >& ) override final;
+    virtual void processData( QtSnmpDataList&&, const QList< ErrorResponse >& ) override final;
     virtual QString description() const override final;
 
 private:
     const QString m_base_oid;
+    WalkCursor m_cursor;
     QtSnmpDataList m_found;
 };
 
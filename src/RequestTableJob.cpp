@@ -0,0 +1,51 @@
+#include "RequestTableJob.h"
+#include "Session.h"
+
+namespace qtsnmpclient {
+
+RequestTableJob::RequestTableJob( Session*const session,
+                                  const qint32 id,
+                                  const QString& entry_oid )
+    : AbstractJob( session, id )
+    , m_entry_oid( entry_oid )
+    , m_table( entry_oid.toLatin1() )
+    , m_cursor( entry_oid.toLatin1() )
+{
+}
+
+void RequestTableJob::start() {
+    m_cursor.start( m_session->walkRowLimit(), qint64( m_session->walkTimeLimit() ) * 1000, Metrics::now() );
+    m_session->sendRequestGetNextValue( m_entry_oid );
+}
+
+void RequestTableJob::processData( QtSnmpDataList&& values,
+                                   const QList< ErrorResponse >& )
+{
+    if ( 1 != values.size() ) {
+        m_session->completeTable( std::move( m_table ) );
+        return;
+    }
+
+    const auto& value = values.front();
+    switch ( m_cursor.step( value, Metrics::now() ) ) {
+    case WalkCursor::NEXT:
+        m_table.append( value );
+        m_session->sendRequestGetNextValue( value.address() );
+        break;
+    case WalkCursor::END:
+        m_session->completeTable( std::move( m_table ) );
+        break;
+    case WalkCursor::NOT_INCREASING:
+        m_session->failWork( QtSnmpResult::OidNotIncreasing );
+        break;
+    case WalkCursor::LIMIT_EXCEEDED:
+        m_session->failWork( QtSnmpResult::WalkLimitExceeded );
+        break;
+    }
+}
+
+QString RequestTableJob::description() const {
+    return "requestTable: " + m_entry_oid;
+}
+
+} // namespace qtsnmpclient
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "AbstractJob.h"
+#include "QtSnmpTable.h"
+#include "WalkCursor.h"
+
+namespace qtsnmpclient {
+
+// NOTE: walks a table like RequestSubValuesJob but collects the rows
+//       straight into the columns of a QtSnmpTable
+class RequestTableJob : public AbstractJob {
+    Q_DISABLE_COPY( RequestTableJob )
+public:
+    explicit RequestTableJob( Session*const,
+                              const qint32 id,
+                              const QString& entry_oid );
+    virtual void start() override final;
+    virtual void processData( QtSnmpDataList&&, const QList< ErrorResponse >& ) override final;
+    virtual QString description() const override final;
+
+private:
+    const QString m_entry_oid;
+    QtSnmpTable m_table;
+    WalkCursor m_cursor;
+};
+
+} // namespace qtsnmpclient
@@ -8,22 +8,45 @@ RequestValuesJob::RequestValuesJob( Session*const session,
                                     const QStringList& oid_list,
                                     const int limit )
     : AbstractJob( session, id )
-    , m_description( "requestValues:" + oid_list.join( "; " ) )
+    , m_oid_list( oid_list )
     , m_requests( oid_list )
     , m_limit( limit )
 {
     m_results.reserve( static_cast< size_t >( oid_list.size() ) );
 }
 
+RequestValuesJob::RequestValuesJob( Session*const session,
+                                    const qint32 id,
+                                    const QtSnmpPreparedRequest& prepared,
+                                    const int limit )
+    : AbstractJob( session, id )
+    , m_oid_list( prepared.oidList() )
+    , m_prepared( prepared )
+    , m_limit( limit )
+{
+    m_results.reserve( static_cast< size_t >( m_oid_list.size() ) );
+}
+
 void RequestValuesJob::start() {
+    if ( ! m_prepared.isNull() ) {
+        // NOTE: the settings of the session are known only now;
+        //       the requests of SNMPv3 are encoded as usual
+        m_chunks = m_prepared.encode( m_session->protocolVersion(),
+                                      m_session->community(),
+                                      m_limit );
+        if ( ! m_chunks ) {
+            m_requests = m_oid_list;
+        }
+    }
     makeRequest();
 }
 
 QString RequestValuesJob::description() const {
-    return m_description;
+    // NOTE: it is needed only for the diagnostics, so it is not kept
+    return "requestValues:" + m_oid_list.join( "; " );
 }
 
-void RequestValuesJob::processData( const QtSnmpDataList& values,
+void RequestValuesJob::processData( QtSnmpDataList&& values,
                                     const QList< ErrorResponse >& error )
 {
     if ( ! error.isEmpty() ) {
@@ -31,19 +54,35 @@ void RequestValuesJob::processData( const QtSnmpDataList& values,
         return;
     }
 
-    for ( const auto& item : values ) {
-        m_results.push_back( item );
+    if ( m_results.empty() ) {
+        m_results = std::move( values );
+    } else {
+        m_results.insert( m_results.end(),
+                          std::make_move_iterator( values.begin() ),
+                          std::make_move_iterator( values.end() ) );
     }
 
-    if ( m_requests.isEmpty() ) {
-        m_session->completeWork( m_results );
+    if ( ! hasRequests() ) {
+        m_session->completeWork( std::move( m_results ) );
         return;
     }
 
     makeRequest();
 }
 
+bool RequestValuesJob::hasRequests() const {
+    if ( m_chunks ) {
+        return m_next_chunk < m_chunks->size();
+    }
+    return ! m_requests.isEmpty();
+}
+
 void RequestValuesJob::makeRequest() {
+    if ( m_chunks ) {
+        m_session->sendPreparedGetValues( m_chunks->at( m_next_chunk++ ) );
+        return;
+    }
+
     auto size = m_requests.size();
     if ( m_limit > 0 ) {
         size = std::min( m_limit, size );
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AbstractJob.h"
+#include "QtSnmpPreparedRequest.h"
 #include <QStringList>
 
 namespace qtsnmpclient {
@@ -12,15 +13,23 @@ public:
                                const qint32 id,
                                const QStringList& oid_list,
                                const int limit );
+    explicit RequestValuesJob( Session*const,
+                               const qint32 id,
+                               const QtSnmpPreparedRequest&,
+                               const int limit );
     virtual void start() override final;
     virtual QString description() const override final;
-    virtual void processData( const QtSnmpDataList&,
+    virtual void processData( QtSnmpDataList&&,
                               const QList< ErrorResponse >& ) override final;
 private:
+    bool hasRequests() const;
     void makeRequest();
 
 private:
-    const QString m_description;
+    const QStringList m_oid_list;
+    const QtSnmpPreparedRequest m_prepared;
+    QtSnmpPreparedRequest::ChunkListPtr m_chunks;
+    size_t m_next_chunk = 0;
     QStringList m_requests;
     QtSnmpDataList m_results;
     const int m_limit = 0;
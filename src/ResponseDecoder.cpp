@@ -0,0 +1,209 @@
+#include "ResponseDecoder.h"
+#include "BerArena.h"
+#include "Usm.h"
+
+namespace qtsnmpclient {
+
+namespace {
+    void addInvalid( const ResponseDecoder::Reason reason,
+                     const int value,
+                     ResponseDecoder::Invalid*const first,
+                     int*const count,
+                     const char*const usm_error = nullptr )
+    {
+        // NOTE: the first reason is kept, the rest are only counted
+        if ( 0 == ( *count )++ ) {
+            first->reason = reason;
+            first->value = value;
+            first->usm_error = usm_error;
+        }
+    }
+}
+
+void ResponseDecoder::decode( const QByteArray& datagram,
+                              BerArena*const arena,
+                              BerArena*const scoped_pdu_arena,
+                              Usm*const usm,
+                              Result*const result ) // static
+{
+    Q_ASSERT( arena && scoped_pdu_arena && result );
+    result->is_parsed = arena->parse( datagram );
+    if ( ! result->is_parsed ) {
+        arena->clear();
+        return;
+    }
+
+    for ( int packet = arena->first(); packet >= 0; packet = arena->next( packet ) ) {
+        const int part_count = arena->childCount( packet );
+        const bool is_v3_message = usm && ( 4 == part_count );
+        if ( ( 3 != part_count ) && ! is_v3_message ) {
+            addInvalid( TOP_CHILD_COUNT, part_count, &result->invalid, &result->invalid_count );
+            continue;
+        }
+
+        // NOTE: the encrypted scoped PDU of SNMPv3 message is decrypted
+        //       by USM, so it gets its own arena.
+        const BerArena* pdu_arena = arena;
+        int resp = arena->child( packet, 2 );
+        Usm::MessageInfo info;
+        if ( is_v3_message ) {
+            const char* error = nullptr;
+            if ( ! usm->processMessage( datagram, *arena, packet, scoped_pdu_arena, &info, &error ) ) {
+                addInvalid( USM_FAILURE, 0, &result->invalid, &result->invalid_count, error );
+                continue;
+            }
+            pdu_arena = info.pdu_arena;
+            resp = info.pdu;
+        }
+
+        const int resp_type = ( resp >= 0 ) ? pdu_arena->type( resp ) : QtSnmpData::INVALID_TYPE;
+        const bool is_report = is_v3_message && ( QtSnmpData::REPORT_TYPE == resp_type );
+        if ( ( QtSnmpData::GET_RESPONSE_TYPE != resp_type ) && ! is_report ) {
+            addInvalid( RESPONSE_TYPE, resp_type, &result->invalid, &result->invalid_count );
+            continue;
+        }
+
+        const int child_count = pdu_arena->childCount( resp );
+        if ( 4 != child_count ) {
+            addInvalid( RESPONSE_CHILD_COUNT, child_count, &result->invalid, &result->invalid_count );
+            continue;
+        }
+
+        const int request_id_data = pdu_arena->firstChild( resp );
+        if ( QtSnmpData::INTEGER_TYPE != pdu_arena->type( request_id_data ) ) {
+            addInvalid( REQUEST_ID_TYPE, pdu_arena->type( request_id_data ),
+                        &result->invalid, &result->invalid_count );
+            continue;
+        }
+
+        // NOTE: the message is matched by the session even if the rest
+        //       of it is invalid, so it is kept with the reason
+        result->messages.emplace_back();
+        auto& message = result->messages.back();
+        message.request_id = static_cast< qint32 >( pdu_arena->integerValue( request_id_data ) );
+        message.is_report = is_report;
+        if ( is_report ) {
+            // NOTE: only the (rare) reports are copied as a whole; a report
+            //       is matched by the message id of the request it rejects,
+            //       since its PDU may be the one the agent could not read
+            message.request_id = info.msg_id;
+            message.pdu = pdu_arena->toData( resp );
+            message.engine_id = std::move( info.engine_id );
+            message.is_authenticated = info.is_authenticated;
+            message.is_valid = true;
+            continue;
+        }
+
+        const int error_state_data = pdu_arena->next( request_id_data );
+        if ( QtSnmpData::INTEGER_TYPE != pdu_arena->type( error_state_data ) ) {
+            message.invalid.reason = ERROR_STATE_TYPE;
+            message.invalid.value = pdu_arena->type( error_state_data );
+            continue;
+        }
+
+        const int error_index_data = pdu_arena->next( error_state_data );
+        if ( QtSnmpData::INTEGER_TYPE != pdu_arena->type( error_index_data ) ) {
+            message.invalid.reason = ERROR_INDEX_TYPE;
+            message.invalid.value = pdu_arena->type( error_index_data );
+            continue;
+        }
+
+        message.error_status = static_cast< int >( pdu_arena->integerValue( error_state_data ) );
+        message.error_index = static_cast< int >( pdu_arena->integerValue( error_index_data ) );
+        if ( message.error_status || message.error_index ) {
+            message.is_valid = true;
+            continue;
+        }
+
+        const int variable_list_data = pdu_arena->next( error_index_data );
+        if ( QtSnmpData::SEQUENCE_TYPE != pdu_arena->type( variable_list_data ) ) {
+            message.invalid.reason = VARIABLE_LIST_TYPE;
+            message.invalid.value = pdu_arena->type( variable_list_data );
+            continue;
+        }
+
+        // NOTE: the copies of the values are the only allocations here
+        message.is_valid = true;
+        message.values.reserve( static_cast< size_t >( pdu_arena->childCount( variable_list_data ) ) );
+        for ( int variable = pdu_arena->firstChild( variable_list_data );
+              variable >= 0;
+              variable = pdu_arena->next( variable ) )
+        {
+            if ( QtSnmpData::SEQUENCE_TYPE != pdu_arena->type( variable ) ) {
+                addInvalid( VARIABLE_TYPE, pdu_arena->type( variable ),
+                            &message.invalid_value, &message.invalid_value_count );
+                continue;
+            }
+
+            const int item_count = pdu_arena->childCount( variable );
+            if ( 2 != item_count ) {
+                addInvalid( ITEM_COUNT, item_count, &message.invalid_value, &message.invalid_value_count );
+                continue;
+            }
+
+            const int object = pdu_arena->firstChild( variable );
+            if ( QtSnmpData::OBJECT_TYPE != pdu_arena->type( object ) ) {
+                addInvalid( OBJECT_TYPE, pdu_arena->type( object ),
+                            &message.invalid_value, &message.invalid_value_count );
+                continue;
+            }
+
+            message.values.push_back( pdu_arena->toData( pdu_arena->next( object ) ) );
+            message.values.back().setAddress( pdu_arena->toData( object ).data() );
+        }
+    }
+
+    // NOTE: the values are copied, so the datagram (a receive buffer
+    //       of the transport) is released for the next one
+    arena->clear();
+    scoped_pdu_arena->clear();
+}
+
+QString ResponseDecoder::reasonText( const Invalid& invalid ) { // static
+    switch ( invalid.reason ) {
+    case NO_REASON:
+        break;
+    case USM_FAILURE:
+        return QString::fromLatin1( invalid.usm_error );
+    case TOP_CHILD_COUNT:
+        return tr( "Unexpected top packet's children count: %1 (expected 3)" )
+               .arg( invalid.value );
+    case RESPONSE_TYPE:
+        return tr( "Unexpected response's type: %1 (expected GET_RESPONSE_TYPE as %2 )" )
+               .arg( invalid.value )
+               .arg( QtSnmpData::GET_RESPONSE_TYPE );
+    case RESPONSE_CHILD_COUNT:
+        return tr( "Unexpected child count: %1 (expected 4)" )
+               .arg( invalid.value );
+    case REQUEST_ID_TYPE:
+        return tr( "Unexpected request id's type: %1 (expected INTEGER_TYPE as %2)" )
+               .arg( invalid.value )
+               .arg( QtSnmpData::INTEGER_TYPE );
+    case ERROR_STATE_TYPE:
+        return tr( "Unexpected error state's type: %1 (expected INTEGER_TYPE as %2)" )
+               .arg( invalid.value )
+               .arg( QtSnmpData::INTEGER_TYPE );
+    case ERROR_INDEX_TYPE:
+        return tr( "Unexpected error index's type: %1 (expected INTEGER_TYPE as %2)" )
+               .arg( invalid.value )
+               .arg( QtSnmpData::INTEGER_TYPE );
+    case VARIABLE_LIST_TYPE:
+        return tr( "Unexpected variable list's type %1 (expected SEQUENCE_TYPE as %2)" )
+               .arg( invalid.value )
+               .arg( QtSnmpData::SEQUENCE_TYPE );
+    case VARIABLE_TYPE:
+        return tr( "Unexpected variable's type %1 (expected SEQUENCE_TYPE as %2)" )
+               .arg( invalid.value )
+               .arg( QtSnmpData::SEQUENCE_TYPE );
+    case ITEM_COUNT:
+        return tr( "Unexpected item count %1 (expected 2)" )
+               .arg( invalid.value );
+    case OBJECT_TYPE:
+        return tr( "Unexpected object's type %1 (expected OBJECT_TYPE as %2)" )
+               .arg( invalid.value )
+               .arg( QtSnmpData::OBJECT_TYPE );
+    }
+    return {};
+}
+
+} // namespace qtsnmpclient
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "QtSnmpData.h"
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QString>
+#include <vector>
+
+namespace qtsnmpclient {
+
+class BerArena;
+class Usm;
+
+// NOTE: Decodes the messages of a response datagram without any state of
+//       the session, so the responses of SNMPv1/v2c may be decoded by any
+//       thread. The session matches the decoded messages with its request.
+//       The reasons of the invalid parts are kept for the diagnostics
+//       of the session as codes, their text is formatted only when it
+//       is actually logged.
+class ResponseDecoder {
+    Q_DECLARE_TR_FUNCTIONS( ResponseDecoder )
+public:
+    enum Reason {
+        NO_REASON,
+        USM_FAILURE,
+        TOP_CHILD_COUNT,
+        RESPONSE_TYPE,
+        RESPONSE_CHILD_COUNT,
+        REQUEST_ID_TYPE,
+        ERROR_STATE_TYPE,
+        ERROR_INDEX_TYPE,
+        VARIABLE_LIST_TYPE,
+        VARIABLE_TYPE,
+        ITEM_COUNT,
+        OBJECT_TYPE,
+    };
+
+    struct Invalid {
+        Reason reason = NO_REASON;
+        int value = 0; // the unexpected type or count
+        const char* usm_error = nullptr;
+    };
+
+    struct Message {
+        qint32 request_id = 0;
+        bool is_report = false;
+        bool is_valid = false; // the error status, the error index and the values
+        Invalid invalid;
+        Invalid invalid_value; // the first one
+        int invalid_value_count = 0;
+        QtSnmpData pdu; // of a report
+        QByteArray engine_id; // of a report
+        bool is_authenticated = false; // of a report
+        int error_status = 0;
+        int error_index = 0;
+        QtSnmpDataList values;
+    };
+
+    struct Result {
+        bool is_parsed = false;
+        Invalid invalid; // the first of the messages without a request id
+        int invalid_count = 0;
+        std::vector< Message > messages;
+    };
+
+    // NOTE: the usm is needed only for SNMPv3 messages
+    static void decode( const QByteArray& datagram,
+                        BerArena*const arena,
+                        BerArena*const scoped_pdu_arena,
+                        Usm*const usm,
+                        Result*const );
+    static QString reasonText( const Invalid& );
+};
+
+} // namespace qtsnmpclient
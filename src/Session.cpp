@@ -2,17 +2,29 @@
 #include "QtSnmpData.h"
 #include "RequestValuesJob.h"
 #include "RequestSubValuesJob.h"
+#include "ConditionalWalkJob.h"
 #include "SetValueJob.h"
+#include "SetValuesJob.h"
+#include "RequestTableJob.h"
+#include "QtSnmpClient.h"
+#include "Logging.h"
+#include "Transport.h"
+#include "DecodePool.h"
 #include <QDateTime>
+#include <QEvent>
 #include <QHostAddress>
+#include <QPointer>
 #include <QThread>
-#include <math.h>
+#include <algorithm>
 
 namespace qtsnmpclient {
 
 namespace {
     const int default_response_timeout = 10000;
 
+    // NOTE: the probe of an agent which is down
+    const char*const probe_oid = ".1.3.6.1.2.1.1.3.0"; // sysUpTime.0
+
     QString errorStatusText( const int val ) {
         static const QHash< int, QString > map = { {0, "No errors"},
                                                    {1, "Too big"},
@@ -30,44 +42,46 @@ namespace {
     QtSnmpData changeRequestId( const QtSnmpData& request,
                                 const int request_id )
     {
-        Q_ASSERT( QtSnmpData::SEQUENCE_TYPE == request.type() );
-        Q_ASSERT( 3 == request.children().size() );
-
-        auto message_children = request.children();
-        auto request_item = message_children[2];
-
-        auto new_request_item = QtSnmpData( request_item.type() );
-        new_request_item.addChild( QtSnmpData::integer( request_id ) );
-
-        auto request_children = request_item.children();
+        const auto& request_children = request.children();
         Q_ASSERT( request_children.size() > 0 );
 
+        auto new_request = QtSnmpData( request.type() );
+        new_request.addChild( QtSnmpData::integer( request_id ) );
         for ( size_t i = 1; i < request_children.size(); ++i ) {
-            new_request_item.addChild( request_children.at( i ) );
+            new_request.addChild( request_children.at( i ) );
         }
+        return new_request;
+    }
 
-        auto new_message = QtSnmpData::sequence();
-        new_message.addChild( message_children.at(0) );
-        new_message.addChild( message_children.at(1) );
-        new_message.addChild( new_request_item );
-
-        return new_message;
+    QByteArray changeRequestId( const QByteArray& datagram,
+                                const int offset,
+                                const qint32 request_id )
+    {
+        Q_ASSERT( ( offset >= 0 ) && ( offset + 4 <= datagram.size() ) );
+        QByteArray result( datagram );
+        char*const data = result.data();
+        data[ offset ] = static_cast< char >( request_id >> 24 );
+        data[ offset + 1 ] = static_cast< char >( request_id >> 16 );
+        data[ offset + 2 ] = static_cast< char >( request_id >> 8 );
+        data[ offset + 3 ] = static_cast< char >( request_id );
+        return result;
     }
 }
 
 Session::Session( QObject*const parent )
     : QObject( parent )
     , m_community( "public" )
+    , m_response_timeout( default_response_timeout )
+    , m_metrics( &Metrics::global() )
 {
-    connect( &m_socket, SIGNAL(readyRead()), SLOT(onReadyRead()) );
-    auto socket_timer = new QTimer( this );
-    connect( socket_timer, SIGNAL(timeout()), SLOT(onReadyRead()) );
-    socket_timer->start( 300 );
+}
 
-    connect( &m_response_wait_timer,
-             SIGNAL(timeout()),
-             SLOT(onResponseTimeExpired()) );
-    m_response_wait_timer.setInterval( default_response_timeout );
+Session::~Session() {
+    if ( m_decode_inbox ) {
+        m_decode_inbox->detach();
+    }
+    releaseRequestIds();
+    detachTransport();
 }
 
 QHostAddress Session::agentAddress() const {
@@ -82,10 +96,9 @@ void Session::setAgentAddress( const QHostAddress& value ) {
     if ( ok ) {
         m_timeout_cnt = 0;
         m_agent_address = value;
-        m_socket.close();
-        m_socket.bind( QHostAddress::AnyIPv4 );
+        updateAgent();
     } else {
-        qDebug() << tr( "Attempt to set invalid agent address: %1" ).arg( value.toString() );
+        qCDebug( lcSession ) << tr( "Attempt to set invalid agent address: %1" ).arg( value.toString() );
     }
 }
 
@@ -95,6 +108,7 @@ quint16 Session::agentPort() const {
 
 void Session::setAgentPort( const quint16 value ) {
     m_agent_port = value;
+    updateAgent();
 }
 
 int Session::protocolVersion() const {
@@ -113,14 +127,37 @@ void Session::setCommunity( const QByteArray& value ) {
     m_community = value;
 }
 
+QByteArray Session::userName() const {
+    return m_usm.userName();
+}
+
+void Session::setUserName( const QByteArray& value ) {
+    m_usm.setUserName( value );
+}
+
+int Session::securityLevel() const {
+    return m_usm.securityLevel();
+}
+
+void Session::setSecurityLevel( const int value ) {
+    m_usm.setSecurityLevel( value );
+}
+
+void Session::setAuthPassword( const QByteArray& value ) {
+    m_usm.setAuthPassword( value );
+}
+
+void Session::setPrivPassword( const QByteArray& value ) {
+    m_usm.setPrivPassword( value );
+}
+
 int Session::responseTimeout() const {
-    return m_response_wait_timer.interval();
+    return m_response_timeout;
 }
 
 void Session::setResponseTimeout( const int value ) {
-    if ( value != m_response_wait_timer.interval() ) {
-        m_response_wait_timer.setInterval( value );
-    }
+    // NOTE: the timeout of the request in progress is not changed
+    m_response_timeout.exchange( value );
 }
 
 int Session::getRequestLimit() const {
@@ -131,29 +168,167 @@ void Session::setGetRequestLimit( const int value ) {
     m_get_limit.exchange( value );
 }
 
+int Session::setRequestLimit() const {
+    return m_set_limit;
+}
+
+void Session::setSetRequestLimit( const int value ) {
+    m_set_limit.exchange( value );
+}
+
+double Session::rateLimit() const {
+    return m_rate_limit.rate();
+}
+
+int Session::rateBurst() const {
+    return m_rate_limit.burst();
+}
+
+void Session::setRateLimit( const double pdus_per_second,
+                            const int burst )
+{
+    m_rate_limit.setRate( pdus_per_second, burst );
+}
+
+int Session::circuitBreakerThreshold() const {
+    return m_breaker.threshold();
+}
+
+int Session::circuitBreakerProbeInterval() const {
+    return static_cast< int >( m_breaker.probeInterval() / 1000 );
+}
+
+void Session::setCircuitBreaker( const int failures,
+                                 const int probe_interval_ms )
+{
+    // NOTE: the agent is taken as available again
+    m_breaker.setThreshold( failures, qint64( probe_interval_ms ) * 1000 );
+    cancelTimer( &m_probe_timer );
+    startNextWork();
+}
+
+bool Session::isAgentAvailable() const {
+    return CircuitBreaker::CLOSED == m_breaker.state();
+}
+
+int Session::walkRowLimit() const {
+    return m_walk_row_limit;
+}
+
+int Session::walkTimeLimit() const {
+    return m_walk_time_limit;
+}
+
+void Session::setWalkLimits( const int max_rows,
+                             const int max_duration_ms )
+{
+    // NOTE: the limits of the walk in progress are not changed
+    m_walk_row_limit.exchange( qMax( 0, max_rows ) );
+    m_walk_time_limit.exchange( qMax( 0, max_duration_ms ) );
+}
+
+void Session::setConfig( const QtSnmpAgentConfig& config ) {
+    if ( ! config.isValid() ) {
+        qCDebug( lcSession ) << tr( "Attempt to set invalid agent address: %1" ).arg( config.address.toString() );
+        return;
+    }
+
+    m_timeout_cnt = 0;
+    m_agent_address = config.address;
+    m_agent_port = config.port;
+    m_protocol_version = config.protocol_version;
+    m_community = config.community;
+    m_usm.setUserName( config.user_name );
+    m_usm.setSecurityLevel( config.security_level );
+    m_usm.setAuthPassword( config.auth_password );
+    m_usm.setPrivPassword( config.priv_password );
+    setResponseTimeout( config.response_timeout );
+    m_get_limit.exchange( config.get_request_limit );
+    m_set_limit.exchange( config.set_request_limit );
+    m_rate_limit.setRate( config.rate_limit, config.rate_burst );
+    updateAgent();
+}
+
 bool Session::isBusy() const {
     return m_current_work || m_work_queue.size();
 }
 
-qint32 Session::requestValues( const QStringList& oid_list ) {
+QtSnmpMetrics Session::metrics() const {
+    return m_metrics.snapshot();
+}
+
+qint32 Session::requestValues( const QStringList& oid_list,
+                               const QtSnmpCallback& callback )
+{
     const qint32 work_id = createWorkId();
-    addWork( std::make_shared< RequestValuesJob >( this, work_id, oid_list, m_get_limit ) );
+    const auto work = std::make_shared< RequestValuesJob >( this, work_id, oid_list, m_get_limit );
+    work->setCallback( callback );
+    addWork( work );
     return work_id;
 }
 
-qint32 Session::requestSubValues( const QString& oid ) {
+qint32 Session::requestValues( const QtSnmpPreparedRequest& prepared,
+                               const QtSnmpCallback& callback )
+{
+    const qint32 work_id = createWorkId();
+    const auto work = std::make_shared< RequestValuesJob >( this, work_id, prepared, m_get_limit );
+    work->setCallback( callback );
+    addWork( work );
+    return work_id;
+}
+
+qint32 Session::requestSubValues( const QString& oid,
+                                  const QtSnmpCallback& callback )
+{
     const qint32 work_id = createWorkId();
-    addWork( std::make_shared< RequestSubValuesJob >( this, work_id, oid ) );
+    const auto work = std::make_shared< RequestSubValuesJob >( this, work_id, oid );
+    work->setCallback( callback );
+    addWork( work );
+    return work_id;
+}
+
+qint32 Session::requestSubValuesIfChanged( const QString& oid,
+                                           const QString& guard_oid,
+                                           const QtSnmpCallback& callback )
+{
+    const qint32 work_id = createWorkId();
+    const auto work = std::make_shared< ConditionalWalkJob >( this, work_id, oid, guard_oid );
+    work->setCallback( callback );
+    addWork( work );
+    return work_id;
+}
+
+qint32 Session::requestTable( const QString& entry_oid,
+                              const QtSnmpCallback& callback )
+{
+    const qint32 work_id = createWorkId();
+    const auto work = std::make_shared< RequestTableJob >( this, work_id, entry_oid );
+    work->setCallback( callback );
+    addWork( work );
     return work_id;
 }
 
 qint32 Session::setValue( const QByteArray& community,
                           const QString& oid,
                           const int type,
-                          const QByteArray& value )
+                          const QByteArray& value,
+                          const QtSnmpCallback& callback )
 {
     const qint32 work_id = createWorkId();
-    addWork( std::make_shared< SetValueJob >( this, work_id, community, oid, type, value ) );
+    const auto work = std::make_shared< SetValueJob >( this, work_id, community, oid, type, value );
+    work->setCallback( callback );
+    addWork( work );
+    return work_id;
+}
+
+qint32 Session::setValues( const QByteArray& community,
+                           const QtSnmpDataList& values,
+                           const QtSnmpCallback& callback )
+{
+    const qint32 work_id = createWorkId();
+    const auto work = std::make_shared< SetValuesJob >( this, work_id, community, values, m_set_limit );
+    work->setCallback( callback );
+    addWork( work );
     return work_id;
 }
 
@@ -174,69 +349,279 @@ void Session::addWork( const JobPointer& work ) {
         m_work_queue.push( work );
         startNextWork();
     } else {
-        qDebug() << tr( "SNMP request %1 for %2 has been dropped, due to the queue is full.")
-                        .arg( work->description(), m_agent_address.toString() );
+        m_metrics.add( Metrics::DROPS );
+        if ( isLogAllowed( LogThrottle::DROPPED_WORK ) ) {
+            qCDebug( lcSession ) << tr( "SNMP request %1 for %2 has been dropped, due to the queue is full.")
+                            .arg( work->description(), m_agent_address.toString() );
+        }
+        // NOTE: the owner of a callback would wait for the result forever
+        if ( work->callback() ) {
+            deliverFailure( work );
+        }
+    }
+}
+
+void Session::deliverFailure( const JobPointer& work,
+                              const int error )
+{
+    if ( work->callback() ) {
+        QtSnmpResult result;
+        result.request_id = work->id();
+        result.error = error;
+        work->callback()( result );
+    } else {
+        if ( QtSnmpResult::RequestFailed != error ) {
+            emit walkAborted( work->id(), error );
+        }
+        emit requestFailed( work->id() );
     }
 }
 
 void Session::startNextWork() {
-    if ( !m_current_work && m_work_queue.size() ){
-        m_current_work = m_work_queue.front();
-        m_work_queue.pop();
-        m_current_work->start();
+    if ( m_current_work || m_work_queue.empty() ) {
+        return;
+    }
+
+    switch ( m_breaker.state() ) {
+    case CircuitBreaker::CLOSED:
+        break;
+    case CircuitBreaker::OPEN:
+        // NOTE: the requests are failed later, since the caller
+        //       has to get the id of a request before its result
+        if ( ! m_is_rejection_posted ) {
+            m_is_rejection_posted = true;
+            QMetaObject::invokeMethod( this, "rejectQueuedWork", Qt::QueuedConnection );
+        }
+        return;
+    case CircuitBreaker::HALF_OPEN:
+        // NOTE: the requests wait for the result of the probe
+        return;
     }
+
+    m_current_work = m_work_queue.front();
+    m_work_queue.pop();
+    m_current_work->start();
 }
 
-void Session::finishWork() {
+JobPointer Session::finishWork() {
+    // NOTE: the session is done with the job before its result is delivered,
+    //       since the callback (or a receiver of the signal) may delete it
+    auto work = std::move( m_current_work );
     m_current_work.reset();
-    m_response_wait_timer.stop();
+    cancelTimer( &m_response_timer );
+    cancelTimer( &m_pacing_timer );
+    m_paced_datagram.clear();
     m_timeout_cnt = 0;
+    return work;
+}
+
+void Session::completeWork( QtSnmpDataList&& values ) {
+    completeWork( std::make_shared< const QtSnmpDataList >( std::move( values ) ) );
 }
 
-void Session::completeWork( const QtSnmpDataList& values ) {
+void Session::completeWork( const QtSnmpDataListPtr& result ) {
     Q_ASSERT( m_current_work );
-    emit responseReceived( m_current_work->id(), values );
-    finishWork();
-    startNextWork();
+    addJobLatency();
+    const auto work = finishWork();
+    const QPointer< Session > guard( this );
+    if ( work->callback() ) {
+        QtSnmpResult outcome;
+        outcome.request_id = work->id();
+        outcome.is_ok = true;
+        outcome.values = result;
+        work->callback()( outcome );
+    } else {
+        emit responseReceived( work->id(), result );
+    }
+    if ( guard ) {
+        startNextWork();
+    }
 }
 
-void Session::failWork() {
+void Session::completeTable( QtSnmpTable&& table ) {
     Q_ASSERT( m_current_work );
-    emit requestFailed( m_current_work->id() );
-    finishWork();
-    startNextWork();
+    addJobLatency();
+    const auto work = finishWork();
+    const QPointer< Session > guard( this );
+    auto result = std::make_shared< const QtSnmpTable >( std::move( table ) );
+    if ( work->callback() ) {
+        QtSnmpResult outcome;
+        outcome.request_id = work->id();
+        outcome.is_ok = true;
+        outcome.table = std::move( result );
+        work->callback()( outcome );
+    } else {
+        emit tableReceived( work->id(), result );
+    }
+    if ( guard ) {
+        startNextWork();
+    }
+}
+
+void Session::completeSet( QtSnmpDataList&& values,
+                            std::vector< int >&& status )
+{
+    Q_ASSERT( m_current_work );
+    addJobLatency();
+    const auto work = finishWork();
+    const QPointer< Session > guard( this );
+    const bool is_ok = std::all_of( status.cbegin(), status.cend(), []( const int item ) { return 0 == item; } );
+    auto result = std::make_shared< const QtSnmpDataList >( std::move( values ) );
+    if ( work->callback() ) {
+        QtSnmpResult outcome;
+        outcome.request_id = work->id();
+        outcome.is_ok = is_ok;
+        outcome.error = is_ok ? QtSnmpResult::NoError : QtSnmpResult::SetFailed;
+        outcome.values = std::move( result );
+        outcome.set_status = std::move( status );
+        work->callback()( outcome );
+    } else if ( is_ok ) {
+        emit responseReceived( work->id(), result );
+    } else {
+        emit requestFailed( work->id() );
+    }
+    if ( guard ) {
+        startNextWork();
+    }
+}
+
+void Session::failWork( const int error ) {
+    Q_ASSERT( m_current_work );
+    if ( QtSnmpResult::RequestFailed != error ) {
+        m_metrics.add( Metrics::ABORTED_WALKS );
+        if ( isLogAllowed( LogThrottle::ERROR_RESPONSE ) ) {
+            const auto cause = ( QtSnmpResult::OidNotIncreasing == error )
+                               ? tr( "the agent has returned a not increasing OID" )
+                               : tr( "the walk has exceeded its limits" );
+            qCDebug( lcSession ) << tr( "SNMP request %1 for %2 has been aborted, due to %3." )
+                                    .arg( m_current_work->description(), m_agent_address.toString(), cause );
+        }
+    }
+    addJobLatency();
+    const auto work = finishWork();
+    const QPointer< Session > guard( this );
+    deliverFailure( work, error );
+    if ( guard ) {
+        startNextWork();
+    }
 }
 
 void Session::onResponseTimeExpired() {
-    if ( ++m_timeout_cnt > 5 ) {
-        qDebug() << tr( "Response's timeout has been expired.\n"
-                        "There is no any snmp response for %1 from %2\n"
-                        "Request internal id #%3." )
-                        .arg( m_current_work->description(), m_agent_address.toString() )
-                        .arg( m_request_id );
+    // NOTE: the probe of an agent which is down is not retransmitted
+    const bool is_probe = ( CircuitBreaker::HALF_OPEN == m_breaker.state() );
+    if ( is_probe || ( ++m_timeout_cnt > 5 ) ) {
+        m_metrics.add( Metrics::TIMEOUTS );
+        if ( isLogAllowed( LogThrottle::TIMEOUT ) ) {
+            qCDebug( lcSession ) << tr( "Response's timeout has been expired.\n"
+                            "There is no any snmp response for %1 from %2\n"
+                            "Request internal id #%3." )
+                            .arg( m_current_work->description(), m_agent_address.toString() )
+                            .arg( m_request_id );
+        }
+        if ( m_breaker.addFailure( Metrics::now() ) ) {
+            openCircuit();
+        }
         cancelWork();
         return;
     }
 
-    updateRequestId();
-    const auto new_request = changeRequestId( m_last_request_data, m_request_id );
-    writeDatagram( new_request.makeSnmpChunk() );
+    m_metrics.add( Metrics::RETRANSMITS );
+    resendRequest();
 }
 
 void Session::cancelWork() {
     if ( m_current_work ) {
-        emit requestFailed( m_current_work->id() );
-        m_current_work.reset();
+        addJobLatency();
     }
-    m_response_wait_timer.stop();
+    const auto work = finishWork();
     m_request_id = -1;
-    m_timeout_cnt = 0;
+    m_request_attempts.clear();
+    if ( work ) {
+        const QPointer< Session > guard( this );
+        deliverFailure( work );
+        if ( ! guard ) {
+            return;
+        }
+    }
+    startNextWork();
+}
+
+void Session::openCircuit() {
+    if ( isLogAllowed( LogThrottle::TIMEOUT ) ) {
+        qCDebug( lcSession ) << tr( "The agent %1 is not available, its requests will be failed "
+                                    "till it responds to a probe." )
+                                .arg( m_agent_address.toString() );
+    }
+    scheduleProbe();
+}
+
+void Session::scheduleProbe() {
+    // NOTE: the wheel counts whole milliseconds of its own clock,
+    //       so the timer may expire a bit before the probe time
+    const auto delay = m_breaker.nextProbeTime() - Metrics::now();
+    setTimer( &m_probe_timer, qMax( qint64( 1 ), ( delay + 999 ) / 1000 ), &Session::onProbeTime );
+}
+
+void Session::onProbeTime() {
+    if ( CircuitBreaker::OPEN != m_breaker.state() ) {
+        return;
+    }
+    // NOTE: a refused probe is scheduled again, otherwise
+    //       the circuit would stay open for good
+    if ( m_current_work || ! m_breaker.startProbe( Metrics::now() ) ) {
+        scheduleProbe();
+        return;
+    }
+
+    // NOTE: any response (even an error) means the agent is available
+    const auto probe = std::make_shared< RequestValuesJob >( this, createWorkId(), QStringList( probe_oid ), 0 );
+    probe->setCallback( []( const QtSnmpResult& ) {} );
+    m_current_work = probe;
+    m_current_work->start();
+}
+
+void Session::rejectQueuedWork() {
+    m_is_rejection_posted = false;
+    const QPointer< Session > guard( this );
+    while ( ( CircuitBreaker::OPEN == m_breaker.state() ) && ! m_work_queue.empty() ) {
+        const auto work = m_work_queue.front();
+        m_work_queue.pop();
+        m_metrics.add( Metrics::REJECTS );
+        deliverFailure( work );
+        if ( ! guard ) {
+            return;
+        }
+    }
     startNextWork();
 }
 
+bool Session::isLogAllowed( const LogThrottle::Kind kind ) {
+    if ( ! lcSession().isDebugEnabled() ) {
+        return false;
+    }
+
+    int suppressed = 0;
+    if ( ! m_log_throttle.allow( kind, Metrics::now(), &suppressed ) ) {
+        m_metrics.add( Metrics::SUPPRESSED_MESSAGES );
+        return false;
+    }
+
+    if ( suppressed > 0 ) {
+        qCDebug( lcSession ) << tr( "%1 similar messages about %2 have been suppressed." )
+                                    .arg( suppressed )
+                                    .arg( m_agent_address.toString() );
+    }
+    return true;
+}
+
+void Session::addJobLatency() {
+    Q_ASSERT( m_current_work );
+    m_metrics.addJobLatency( Metrics::now() - m_current_work->enqueueTime() );
+}
+
 void Session::sendRequestGetValues( const QStringList& names ) {
     if ( -1 != m_request_id ) {
-        qDebug() << tr( "An attempt to make new request during waiting response for the previous one.\n"
+        qCDebug( lcSession ) << tr( "An attempt to make new request during waiting response for the previous one.\n"
                         "Agent's address: %1\n"
                         "Requested OIDS: %2" )
                         .arg( m_agent_address.toString(), names.join( "; " ) );
@@ -244,9 +629,6 @@ void Session::sendRequestGetValues( const QStringList& names ) {
     }
 
     updateRequestId();
-    QtSnmpData full_packet = QtSnmpData::sequence();
-    full_packet.addChild( QtSnmpData::integer( m_protocol_version ) );
-    full_packet.addChild( QtSnmpData::string( m_community ) );
     QtSnmpData request( QtSnmpData::GET_REQUEST_TYPE );
     request.addChild( QtSnmpData::integer( m_request_id ) );
     request.addChild( QtSnmpData::integer( 0 ) );
@@ -259,13 +641,29 @@ void Session::sendRequestGetValues( const QStringList& names ) {
         seq_all_obj.addChild( seq_obj_info );
     }
     request.addChild( seq_all_obj );
-    full_packet.addChild( request );
-    sendRequest( full_packet );
+    sendRequest( request, m_community );
+}
+
+void Session::sendPreparedGetValues( const QtSnmpPreparedRequest::Chunk& chunk ) {
+    if ( -1 != m_request_id ) {
+        qCDebug( lcSession ) << tr( "An attempt to make new request during waiting response for the previous one.\n"
+                        "Agent's address: %1\n"
+                        "Prepared OIDs: %2" )
+                        .arg( m_agent_address.toString() )
+                        .arg( chunk.oid_count );
+        return;
+    }
+
+    updateRequestId();
+    m_last_request_datagram = chunk.datagram;
+    m_last_request_id_offset = chunk.request_id_offset;
+    m_report_cnt = 0;
+    transmitDatagram( changeRequestId( chunk.datagram, chunk.request_id_offset, m_request_id ), false );
 }
 
 void Session::sendRequestGetNextValue( const QString& name ) {
     if ( -1 != m_request_id ) {
-        qDebug() << tr( "An attempt to make new request during waiting response for the previous one.\n"
+        qCDebug( lcSession ) << tr( "An attempt to make new request during waiting response for the previous one.\n"
                         "Agent's address: %1\n"
                         "Requested OID: %2" )
                         .arg( m_agent_address.toString(), name );
@@ -273,9 +671,6 @@ void Session::sendRequestGetNextValue( const QString& name ) {
     }
 
     updateRequestId();
-    QtSnmpData full_packet = QtSnmpData::sequence();
-    full_packet.addChild( QtSnmpData::integer( m_protocol_version ) );
-    full_packet.addChild( QtSnmpData::string( m_community ) );
     QtSnmpData request( QtSnmpData::GET_NEXT_REQUEST_TYPE );
     request.addChild( QtSnmpData::integer( m_request_id ) );
     request.addChild( QtSnmpData::integer( 0 ) );
@@ -286,8 +681,7 @@ void Session::sendRequestGetNextValue( const QString& name ) {
     seq_obj_info.addChild( QtSnmpData::null() );
     seq_all_obj.addChild( seq_obj_info );
     request.addChild( seq_all_obj );
-    full_packet.addChild( request );
-    sendRequest( full_packet );
+    sendRequest( request, m_community );
 }
 
 void Session::sendRequestSetValue( const QByteArray& community,
@@ -296,7 +690,7 @@ void Session::sendRequestSetValue( const QByteArray& community,
                                    const QByteArray& value )
 {
     if ( -1 != m_request_id ) {
-        qDebug() << tr( "An attempt to make new (SET) request during waiting response for the previous one.\n"
+        qCDebug( lcSession ) << tr( "An attempt to make new (SET) request during waiting response for the previous one.\n"
                         "Agent's address: %1\n"
                         "OID: %2\n"
                         "type: %3\n"
@@ -308,9 +702,6 @@ void Session::sendRequestSetValue( const QByteArray& community,
     }
 
     updateRequestId();
-    auto pdu_packet = QtSnmpData::sequence();
-    pdu_packet.addChild( QtSnmpData::integer( m_protocol_version ) );
-    pdu_packet.addChild( QtSnmpData::string( community ) );
     auto request_type = QtSnmpData( QtSnmpData::SET_REQUEST_TYPE );
     request_type.addChild( QtSnmpData::integer( m_request_id ) );
     request_type.addChild( QtSnmpData::integer( 0 ) );
@@ -318,255 +709,380 @@ void Session::sendRequestSetValue( const QByteArray& community,
     auto seq_all_obj = QtSnmpData::sequence();
     auto seq_obj_info = QtSnmpData::sequence();
     seq_obj_info.addChild( QtSnmpData::oid( name.toLatin1() ) );
-    seq_obj_info.addChild( QtSnmpData( type, value ) );
+    seq_obj_info.emplaceChild( type, value );
     seq_all_obj.addChild( seq_obj_info );
     request_type.addChild( seq_all_obj );
-    pdu_packet.addChild( request_type );
-    sendRequest( pdu_packet );
+    sendRequest( request_type, community );
 }
 
-void Session::onReadyRead() {
-    if ( QUdpSocket::BoundState != m_socket.state() ) {
+void Session::sendRequestSetValues( const QByteArray& community,
+                                    const QtSnmpDataList& values,
+                                    const size_t first,
+                                    const size_t count )
+{
+    Q_ASSERT( first + count <= values.size() );
+    if ( -1 != m_request_id ) {
+        qCDebug( lcSession ) << tr( "An attempt to make new (SET) request during waiting response for the previous one.\n"
+                        "Agent's address: %1\n"
+                        "Values: %2" )
+                        .arg( m_agent_address.toString() )
+                        .arg( count );
         return;
     }
 
-    while ( m_socket.hasPendingDatagrams() ) {
-        // NOTE:
-        // The field size sets a theoretical limit of 65,535 bytes
-        // (8 byte header + 65,527 bytes of data) for a UDP datagram.
-        // However the actual limit for the data length,
-        // which is imposed by the underlying IPv4 protocol,
-        // is 65,507 bytes (65,535 − 8 byte UDP header − 20 byte IP header).
-        const int max_datagram_size = 65507;
+    updateRequestId();
+    auto request_type = QtSnmpData( QtSnmpData::SET_REQUEST_TYPE );
+    request_type.addChild( QtSnmpData::integer( m_request_id ) );
+    request_type.addChild( QtSnmpData::integer( 0 ) );
+    request_type.addChild( QtSnmpData::integer( 0 ) );
+    auto seq_all_obj = QtSnmpData::sequence();
+    for ( size_t i = first; i < first + count; ++i ) {
+        const auto& value = values.at( i );
+        auto& seq_obj_info = seq_all_obj.emplaceChild( QtSnmpData::sequence() );
+        seq_obj_info.addChild( QtSnmpData::oid( value.address() ) );
+        seq_obj_info.emplaceChild( value.type(), value.data() );
+    }
+    request_type.addChild( seq_all_obj );
+    sendRequest( request_type, community );
+}
 
-        const int size = static_cast< int >( m_socket.pendingDatagramSize() );
-        if ( (size <= 0) ) {
-            continue;
+void Session::receiveDatagram( const QByteArray& datagram ) {
+    m_metrics.add( Metrics::PDUS_RECEIVED );
+    m_metrics.add( Metrics::BYTES_RECEIVED, static_cast< quint64 >( datagram.size() ) );
+
+    // NOTE: the datagrams are decoded by the pool while some of them
+    //       are still there, even after it is disabled, so they are
+    //       never processed out of order
+    auto& pool = DecodePool::instance();
+    const bool is_pending = m_decode_inbox && m_decode_inbox->hasPending();
+    if ( ( QtSnmpClient::SNMPv3 != m_protocol_version ) && ( pool.isEnabled() || is_pending ) ) {
+        if ( ! m_decode_inbox ) {
+            m_decode_inbox = std::make_shared< DecodeInbox >( this );
         }
+        pool.decode( m_decode_inbox, datagram );
+        return;
+    }
+    processIncommingDatagram( datagram );
+}
 
-        if ( size > max_datagram_size ) {
-            qDebug() << tr( "Too big UDP packet has been received.\n"
-                            "There was an UDP packet with declared size %1 has been received from %2." )
-                            .arg( size )
-                            .arg( m_agent_address.toString() );
-        }
+void Session::processDecodedResponses() {
+    // NOTE: the session may be deleted by a callback of a job
+    const QPointer< Session > guard( this );
+    ResponseDecoder::Result result;
+    while ( guard && m_decode_inbox->take( &result ) ) {
+        processResponse( std::move( result ) );
+        result = ResponseDecoder::Result();
+    }
+}
 
+bool Session::event( QEvent*const event ) {
+    if ( QEvent::ThreadChange == event->type() ) {
+        // NOTE: the transport belongs to the thread the session leaves,
+        //       the one of the new thread is taken by the next request
+        detachTransport();
+    } else if ( DecodeInbox::eventType() == event->type() ) {
+        processDecodedResponses();
+        return true;
+    }
+    return QObject::event( event );
+}
 
-        QByteArray datagram;
-        datagram.reserve( size );
-        datagram.append( size, '\x0' );
-        const auto read_size = m_socket.readDatagram( datagram.data(), size );
-        if ( size != read_size ) {
-            qDebug() << tr( "SNMP response reading error.\n"
-                            "Only %1 bytes of %2 have been read from UDP packet from %3.\n"
-                            "Cause: %4" )
-                            .arg( read_size )
-                            .arg( size )
-                            .arg( m_agent_address.toString(), m_socket.errorString() );
-            continue;
+Transport& Session::transport() {
+    if ( ! m_transport ) {
+        m_transport = Transport::forCurrentThread();
+        m_transport->setAgent( this, m_agent_address, m_agent_port );
+        for ( const auto id : m_request_history_queue ) {
+            m_transport->addRequestId( id, this );
         }
-        processIncommingDatagram( datagram );
     }
+    Q_ASSERT( m_transport->thread() == thread() );
+    return *m_transport;
 }
 
-void Session::processIncommingDatagram( const QByteArray& datagram ) {
-    QtSnmpDataList valid_list;
-    valid_list.reserve( 1024 );
-    QList< AbstractJob::ErrorResponse > error_list;
-    QtSnmpDataList raw_list;
-    QtSnmpData::parseData( datagram, &raw_list );
-    for ( const auto& packet : raw_list ) {
-        const auto& resp_list = packet.children();
-        if ( 3 != resp_list.size() ) {
-            qDebug() << tr( "An invalid SNMP response has been received.\n" ) +
-                        tr( "Unexpected top packet's children count: %1 (expected 3)\n"
-                            "in a response from %2" )
-                            .arg( resp_list.size() )
-                            .arg( m_agent_address.toString() );
-            continue;
-        }
+void Session::detachTransport() {
+    if ( ! m_transport ) {
+        return;
+    }
+    // NOTE: the timers are in the wheel of the transport too
+    cancelTimer( &m_response_timer );
+    cancelTimer( &m_pacing_timer );
+    cancelTimer( &m_probe_timer );
+    for ( const auto id : m_request_history_queue ) {
+        m_transport->removeRequestId( id, this );
+    }
+    m_transport->removeSession( this );
+    m_transport.reset();
+}
 
-        const auto& resp = resp_list.at( 2 );
-        if ( QtSnmpData::GET_RESPONSE_TYPE != resp.type() ) {
-            qDebug() << tr( "An invalid SNMP response has been received.\n" ) +
-                        tr( "Unexpected response's type: %1 (expected GET_RESPONSE_TYPE as %2 ) "
-                            "in a response from %3" )
-                            .arg( resp.type() )
-                            .arg( QtSnmpData::GET_RESPONSE_TYPE )
-                            .arg( m_agent_address.toString() );
-            continue;
-        }
+void Session::setTimer( TimerWheel::TimerId*const timer,
+                        const qint64 delay_ms,
+                        void ( Session::*handler )() )
+{
+    cancelTimer( timer );
+    *timer = transport().addTimer( delay_ms, [this, timer, handler]() {
+        *timer = 0;
+        ( this->*handler )();
+    } );
+}
 
-        const auto& children = resp.children();
-        if ( 4 != children.size() ) {
-            qDebug() << tr( "An invalid SNMP response has been received.\n" ) +
-                        tr( "Unexpected child count: %1 (expected 4) "
-                            "in a response from %2" )
-                            .arg( children.size() )
-                            .arg( m_agent_address.toString() );
-            continue;
+void Session::cancelTimer( TimerWheel::TimerId*const timer ) {
+    if ( 0 == *timer ) {
+        return;
+    }
+    if ( m_transport ) {
+        m_transport->cancelTimer( *timer );
+    }
+    *timer = 0;
+}
+
+void Session::processIncommingDatagram( const QByteArray& datagram ) {
+    // NOTE: the messages of the last datagram of the thread are reused;
+    //       the session may be deleted by processResponse, so they are kept
+    //       apart from it, and a nested call just gets new ones
+    thread_local std::vector< ResponseDecoder::Message > spare_messages;
+    ResponseDecoder::Result result;
+    result.messages.swap( spare_messages );
+    ResponseDecoder::decode( datagram,
+                             &m_arena,
+                             &m_scoped_pdu_arena,
+                             ( QtSnmpClient::SNMPv3 == m_protocol_version ) ? &m_usm : nullptr,
+                             &result );
+    processResponse( std::move( result ) );
+    result.messages.clear();
+    spare_messages.swap( result.messages );
+}
+
+void Session::logInvalidResponse( const ResponseDecoder::Invalid& invalid,
+                                  const int count )
+{
+    if ( isLogAllowed( LogThrottle::INVALID_RESPONSE ) ) {
+        auto reason = ResponseDecoder::reasonText( invalid );
+        if ( count > 1 ) {
+            reason += tr( " (and %1 more)" ).arg( count - 1 );
         }
+        qCDebug( lcSession ) << tr( "An invalid SNMP response has been received.\n" ) +
+                    tr( "%1 in a response from %2" )
+                        .arg( reason, m_agent_address.toString() );
+    }
+}
 
-        const auto& request_id_data = children.at( 0 );
-        if ( QtSnmpData::INTEGER_TYPE != request_id_data.type() ) {
-            qDebug() << tr( "An invalid SNMP response has been received.\n" ) +
-                        tr( "Unexpected request id's type: %1 (expected INTEGER_TYPE as %2) "
-                            "in a response from %3" )
-                            .arg( request_id_data.type() )
-                            .arg( QtSnmpData::INTEGER_TYPE )
+void Session::processResponse( ResponseDecoder::Result&& result ) {
+    if ( ! result.is_parsed ) {
+        if ( isLogAllowed( LogThrottle::INVALID_RESPONSE ) ) {
+            qCDebug( lcSession ) << tr( "An invalid SNMP response has been received.\n" ) +
+                        tr( "Malformed BER encoding of a response from %1" )
                             .arg( m_agent_address.toString() );
-            continue;
         }
+        return;
+    }
+    if ( result.invalid_count > 0 ) {
+        logInvalidResponse( result.invalid, result.invalid_count );
+    }
 
-        const int response_req_id = request_id_data.intValue();
-        if ( response_req_id != m_request_id ) {
-            QStringList history;
-            for ( const auto item : m_request_history_queue ) {
-                history << "0x" + QString::number( item, 16 );
+    bool is_matched = false;
+    QtSnmpDataList valid_list;
+    QList< AbstractJob::ErrorResponse > error_list;
+    for ( auto& message : result.messages ) {
+        // NOTE: a response to any attempt of the current request is accepted,
+        //       since a late response to an earlier attempt is still valid.
+        //       Responses to the already answered requests are duplicates.
+        const auto response_req_id = message.request_id;
+        if ( ! m_request_attempts.contains( response_req_id ) ) {
+            if ( m_request_history_queue.contains( response_req_id ) ) {
+                m_metrics.add( Metrics::DUPLICATES );
+                continue;
             }
 
-            qDebug() << tr( "An invalid SNMP response has been received.\n" ) +
-                        tr( "Unexpected request id: 0x%1 (expected 0x%2 ) in a response from %3.\n"
-                            "History (request id list): %4" )
-                            .arg( QString::number( response_req_id, 16 ),
-                                  QString::number( m_request_id, 16 ),
-                                  m_agent_address.toString(),
-                                  history.join( ", " ) );
+            m_metrics.add( Metrics::UNEXPECTED_REQUEST_IDS );
+            if ( isLogAllowed( LogThrottle::UNEXPECTED_REQUEST_ID ) ) {
+                QStringList history;
+                for ( const auto item : m_request_history_queue ) {
+                    history << "0x" + QString::number( item, 16 );
+                }
+
+                qCDebug( lcSession ) << tr( "An invalid SNMP response has been received.\n" ) +
+                            tr( "Unexpected request id: 0x%1 (expected 0x%2 ) in a response from %3.\n"
+                                "History (request id list): %4" )
+                                .arg( QString::number( response_req_id, 16 ),
+                                      QString::number( m_request_id, 16 ),
+                                      m_agent_address.toString(),
+                                      history.join( ", " ) );
+            }
             continue;
         }
 
         m_request_id = -1;
+        m_request_attempts.clear();
+        cancelTimer( &m_response_timer );
+        is_matched = true;
+        m_breaker.addSuccess();
+
+        // NOTE: the round trip time is ambiguous for a retransmitted request
+        //       (Karn's algorithm), so only the first attempts are sampled.
+        if ( ( 0 == m_timeout_cnt ) && ( 0 == m_report_cnt ) ) {
+            m_metrics.addRtt( Metrics::now() - m_send_time );
+        }
 
-        const auto& error_state_data = children.at( 1 );
-        if ( QtSnmpData::INTEGER_TYPE != error_state_data.type() ) {
-            qDebug() << tr( "An invalid SNMP response has been received.\n" ) +
-                        tr( "Unexpected error state's type: %1 (expected INTEGER_TYPE as %2) "
-                            "in a response from %3" )
-                            .arg( error_state_data.type() )
-                            .arg( QtSnmpData::INTEGER_TYPE )
-                            .arg( m_agent_address.toString() );
+        if ( message.is_report ) {
+            // NOTE: engine discovery and time synchronization are done by reports,
+            //       after them the same request is sent again with the actual parameters.
+            if ( ( ++m_report_cnt <= 3 ) &&
+                 m_usm.processReport( message.pdu, message.engine_id, message.is_authenticated ) )
+            {
+                resendRequest();
+                return;
+            }
+
+            if ( isLogAllowed( LogThrottle::ERROR_RESPONSE ) ) {
+                qCDebug( lcSession ) << tr( "An SNMPv3 report has been received from %1.\n"
+                                "Current job: %2" )
+                                .arg( m_agent_address.toString(), m_current_work->description() );
+            }
+            AbstractJob::ErrorResponse error;
+            error.request = m_current_work->description();
+            error.status = "Report";
+            error_list << error;
             continue;
         }
 
-        const auto& error_index_data = children.at( 2 );
-        if ( QtSnmpData::INTEGER_TYPE != error_index_data.type() ) {
-            qDebug() << tr( "An invalid SNMP response has been received.\n" ) +
-                        tr( "Unexpected error index's type: %1 (expected INTEGER_TYPE as %2) "
-                            "in a response from %3" )
-                            .arg( error_index_data.type() )
-                            .arg( QtSnmpData::INTEGER_TYPE )
-                            .arg( m_agent_address.toString() );
+        if ( ! message.is_valid ) {
+            logInvalidResponse( message.invalid );
             continue;
         }
 
-        const int err_st = error_state_data.intValue();
-        const int err_in =  error_index_data.intValue();
+        const auto err_st = message.error_status;
+        const auto err_in = message.error_index;
+        if ( 1 == err_st ) {
+            m_metrics.add( Metrics::TOO_BIG );
+        }
         if ( err_st || err_in ) {
-            qDebug() << tr( "An error message received from %1.\n"
-                            "Error's status: %2. Error's index: %3\n"
-                            "Current job: %4" )
-                            .arg( m_agent_address.toString() )
-                            .arg( errorStatusText( err_st ) )
-                            .arg( err_in )
-                            .arg( m_current_work->description() );
+            if ( isLogAllowed( LogThrottle::ERROR_RESPONSE ) ) {
+                qCDebug( lcSession ) << tr( "An error message received from %1.\n"
+                                "Error's status: %2. Error's index: %3\n"
+                                "Current job: %4" )
+                                .arg( m_agent_address.toString() )
+                                .arg( errorStatusText( err_st ) )
+                                .arg( err_in )
+                                .arg( m_current_work->description() );
+            }
             AbstractJob::ErrorResponse error;
             error.request = m_current_work->description();
             error.status = errorStatusText( err_st );
+            error.code = err_st;
             error.index = err_in;
             error_list << error;
             continue;
         }
 
-        const auto& variable_list_data = children.at( 3 );
-        Q_ASSERT( QtSnmpData::SEQUENCE_TYPE == variable_list_data.type() );
-        if ( QtSnmpData::SEQUENCE_TYPE != variable_list_data.type() ) {
-            qDebug() << tr( "An invalid SNMP response has been received.\n" ) +
-                        tr( "Unexpected variable list's type %1 (expected SEQUENCE_TYPE as %2) "
-                            "in a response from %3" )
-                            .arg( variable_list_data.type() )
-                            .arg( QtSnmpData::SEQUENCE_TYPE )
-                            .arg( m_agent_address.toString() );
-            continue;
+        if ( message.invalid_value_count > 0 ) {
+            logInvalidResponse( message.invalid_value, message.invalid_value_count );
         }
-
-        const auto& variable_list = variable_list_data.children();
-        for ( const auto& variable : variable_list ) {
-            if ( QtSnmpData::SEQUENCE_TYPE != variable.type() ) {
-                qDebug() << tr( "An invalid SNMP response has been received.\n" ) +
-                            tr( "Unexpected variable's type %1 (expected SEQUENCE_TYPE as %2) "
-                                "in a response from %3" )
-                                .arg( variable.type() )
-                                .arg( QtSnmpData::SEQUENCE_TYPE )
-                                .arg( m_agent_address.toString() );
-                continue;
-            }
-
-            const auto& items = variable.children();
-            if ( 2 != items.size() ) {
-                qDebug() << tr( "An invalid SNMP response has been received.\n" ) +
-                            tr( "Unexpected item count %1 (expected 2) "
-                                "in a response from %3" )
-                                .arg( items.size() )
-                                .arg( m_agent_address.toString() );
-                continue;
-            }
-
-            const auto& object = items.at( 0 );
-            if ( QtSnmpData::OBJECT_TYPE != object.type() ) {
-                qDebug() << tr( "An invalid SNMP response has been received.\n" ) +
-                            tr( "Unexpected object's type %1 (expected OBJECT_TYPE as %2) "
-                                "in a response from %3" )
-                                .arg( object.type() )
-                                .arg( QtSnmpData::OBJECT_TYPE )
-                                .arg( m_agent_address.toString() );
-                continue;
-            }
-
-            auto result_item = items.at( 1 );
-            result_item.setAddress( object.data() );
-            valid_list.push_back( result_item );
-
-            if ( m_response_wait_timer.isActive() ) {
-                m_response_wait_timer.stop();
-            }
+        if ( ! message.values.empty() ) {
             m_timeout_cnt = 0;
         }
+        if ( valid_list.empty() ) {
+            valid_list = std::move( message.values );
+        } else {
+            valid_list.insert( valid_list.end(),
+                               std::make_move_iterator( message.values.begin() ),
+                               std::make_move_iterator( message.values.end() ) );
+        }
     }
 
-    if ( m_current_work ) {
-        m_current_work->processData( valid_list, error_list );
+    if ( m_current_work && is_matched ) {
+        // NOTE: the job is finished (and released by the session) inside
+        //       of processData, so it is kept alive till it returns
+        const auto work = m_current_work;
+        work->processData( std::move( valid_list ), error_list );
     }
 }
 
 bool Session::writeDatagram( const QByteArray& datagram ) {
-    const auto res = m_socket.writeDatagram( datagram, m_agent_address, m_agent_port );
+    const auto res = transport().writeDatagram( datagram, m_agent_address, m_agent_port );
     if ( -1 == res ) {
-        qDebug() << tr( "Unable to send a datagram to %1."
-                        "Cause: %2" )
-                        .arg( m_agent_address.toString() )
-                        .arg( m_socket.errorString() );
+        if ( isLogAllowed( LogThrottle::IO_ERROR ) ) {
+            qCDebug( lcSession ) << tr( "Unable to send a datagram to %1."
+                            "Cause: %2" )
+                            .arg( m_agent_address.toString() )
+                            .arg( transport().errorString() );
+        }
         return false;
     }
 
+    m_metrics.add( Metrics::PDUS_SENT );
+    m_metrics.add( Metrics::BYTES_SENT, static_cast< quint64 >( res ) );
+
     if ( res < datagram.size() ) {
-        qDebug() << tr( "Only %1 bytes of %2 have been sent to %3.\n"
-                        "Cause: %4")
-                        .arg( res )
-                        .arg( datagram.size() )
-                        .arg( m_agent_address.toString() )
-                        .arg( m_socket.errorString() );
+        if ( isLogAllowed( LogThrottle::IO_ERROR ) ) {
+            qCDebug( lcSession ) << tr( "Only %1 bytes of %2 have been sent to %3.\n"
+                            "Cause: %4")
+                            .arg( res )
+                            .arg( datagram.size() )
+                            .arg( m_agent_address.toString() )
+                            .arg( transport().errorString() );
+        }
         return false;
     }
 
     return ( res == datagram.size() );
 }
 
-void Session::sendRequest( const QtSnmpData& request ) {
-    const auto datagram = request.makeSnmpChunk();
-    if ( writeDatagram( datagram ) ) {
-        m_last_request_data = request;
-        Q_ASSERT( ! m_response_wait_timer.isActive() );
-        m_response_wait_timer.start();
+QByteArray Session::makeDatagram( const QtSnmpData& pdu,
+                                  const QByteArray& community )
+{
+    if ( QtSnmpClient::SNMPv3 == m_protocol_version ) {
+        // NOTE: while the agent's engine is unknown, it is a discovery message
+        return m_usm.makeMessage( m_request_id, pdu );
+    }
+
+    auto message = QtSnmpData::sequence();
+    message.addChild( QtSnmpData::integer( m_protocol_version ) );
+    message.addChild( QtSnmpData::string( community ) );
+    message.addChild( pdu );
+    return message.makeSnmpChunk();
+}
+
+void Session::sendRequest( const QtSnmpData& pdu,
+                           const QByteArray& community )
+{
+    m_last_request_data = pdu;
+    m_last_request_community = community;
+    m_last_request_datagram.clear();
+    m_last_request_id_offset = -1;
+    m_report_cnt = 0;
+    transmitDatagram( makeDatagram( pdu, community ), false );
+}
+
+void Session::resendRequest() {
+    updateRequestId();
+    if ( m_last_request_id_offset >= 0 ) {
+        transmitDatagram( changeRequestId( m_last_request_datagram, m_last_request_id_offset, m_request_id ), true );
+        return;
+    }
+    m_last_request_data = changeRequestId( m_last_request_data, m_request_id );
+    transmitDatagram( makeDatagram( m_last_request_data, m_last_request_community ), true );
+}
+
+void Session::transmitDatagram( const QByteArray& datagram,
+                                const bool is_retransmission )
+{
+    cancelTimer( &m_response_timer );
+    cancelTimer( &m_pacing_timer );
+    m_paced_datagram.clear();
+
+    const auto delay = takeSendToken();
+    if ( delay > 0 ) {
+        // NOTE: the response time is counted from the actual sending
+        m_metrics.add( Metrics::PACED_PDUS );
+        m_paced_datagram = datagram;
+        m_is_paced_retransmission = is_retransmission;
+        setTimer( &m_pacing_timer, ( delay + 999 ) / 1000, &Session::onPacingTimeExpired );
+        return;
+    }
+
+    m_send_time = Metrics::now();
+    if ( writeDatagram( datagram ) || is_retransmission ) {
+        setTimer( &m_response_timer, m_response_timeout, &Session::onResponseTimeExpired );
     } else {
         // NOTE: If we can't send a datagram at once,
         //       then we wont try to resend it again.
@@ -577,6 +1093,65 @@ void Session::sendRequest( const QtSnmpData& request ) {
     }
 }
 
+void Session::onPacingTimeExpired() {
+    if ( m_paced_datagram.isEmpty() ) {
+        return;
+    }
+    const auto datagram = m_paced_datagram;
+    transmitDatagram( datagram, m_is_paced_retransmission );
+}
+
+qint64 Session::takeSendToken() {
+    // NOTE: the token of the agent is taken only when the global one
+    //       is available too, so a session waiting for the global limit
+    //       does not lose its own tokens
+    const auto now = Metrics::now();
+    const auto agent_delay = m_rate_limit.waitTime( now );
+    if ( agent_delay > 0 ) {
+        return agent_delay;
+    }
+    const auto global_delay = TokenBucket::global().take( now );
+    if ( global_delay > 0 ) {
+        return global_delay;
+    }
+    m_rate_limit.take( now );
+    return 0;
+}
+
+bool Session::findWalk( const QString& oid,
+                        const QString& guard_oid,
+                        CachedWalk*const cached ) const
+{
+    Q_ASSERT( cached );
+    const auto iter = m_walk_cache.constFind( oid + " " + guard_oid );
+    if ( m_walk_cache.constEnd() == iter ) {
+        return false;
+    }
+    *cached = iter.value();
+    return true;
+}
+
+void Session::storeWalk( const QString& oid,
+                         const QString& guard_oid,
+                         const QtSnmpData& guard,
+                         const QtSnmpDataListPtr& values )
+{
+    CachedWalk cached;
+    cached.guard = guard;
+    cached.values = values;
+    m_walk_cache.insert( oid + " " + guard_oid, cached );
+}
+
+void Session::updateAgent() {
+    m_walk_cache.clear();
+    m_breaker.addSuccess();
+    cancelTimer( &m_probe_timer );
+    m_usm.setAgent( m_agent_address.toString().toLatin1() + ':' + QByteArray::number( m_agent_port ) );
+    if ( m_transport ) {
+        m_transport->setAgent( this, m_agent_address, m_agent_port );
+    }
+}
+
 qint32 Session::createWorkId() {
     ++m_work_id;
     if ( m_work_id < 1 ) {
@@ -588,16 +1163,30 @@ qint32 Session::createWorkId() {
 }
 
 void Session::updateRequestId() {
-    const auto prev = m_request_id;
-    do {
-        m_request_id = 1 + abs( rand() ) % 0x7FFF;
-    } while ( prev == m_request_id );
-
+    m_request_id = transport().allocateRequestId( this );
+    m_request_attempts.append( m_request_id );
     m_request_history_queue.enqueue( m_request_id );
 
+    // NOTE: an id is kept (and routed to the session by the transport)
+    //       while it is in the history, so a late response to the session
+    //       is never taken for a response to another one
     while ( m_request_history_queue.count() > 10 ) {
-        m_request_history_queue.dequeue();
+        forgetRequestId( m_request_history_queue.dequeue() );
+    }
+}
+
+void Session::forgetRequestId( const qint32 id ) {
+    if ( m_transport ) {
+        m_transport->removeRequestId( id, this );
+    }
+}
+
+void Session::releaseRequestIds() {
+    for ( const auto id : m_request_history_queue ) {
+        forgetRequestId( id );
     }
+    m_request_history_queue.clear();
+    m_request_attempts.clear();
 }
 
 } // namespace qtsnmpclient
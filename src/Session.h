@@ -1,28 +1,43 @@
 #pragma once
 
 #include "AbstractJob.h"
+#include "Usm.h"
+#include "Metrics.h"
+#include "Logging.h"
+#include "BerArena.h"
+#include "QtSnmpTable.h"
+#include "TokenBucket.h"
+#include "CircuitBreaker.h"
+#include "TimerWheel.h"
+#include "ResponseDecoder.h"
+#include "QtSnmpAgentConfig.h"
+#include "QtSnmpPreparedRequest.h"
 #include <QObject>
 #include <QByteArray>
 #include <QSharedPointer>
 #include <QList>
 #include <QString>
 #include <QStringList>
-#include <QUdpSocket>
-#include <QSharedPointer>
 #include <QPair>
-#include <QTimer>
 #include <QHostAddress>
+#include <QHash>
 #include <QQueue>
+#include <QVector>
 #include <atomic>
+#include <memory>
 #include "win_export.h"
 
 namespace qtsnmpclient {
 
+class Transport;
+class DecodeInbox;
+
 class Session : public QObject {
     Q_OBJECT
     Q_DISABLE_COPY( Session )
 public:
     Session( QObject*const parent = nullptr );
+    ~Session() override;
 
     QHostAddress agentAddress() const;
     void setAgentAddress( const QHostAddress& );
@@ -36,66 +51,202 @@ public:
     QByteArray community() const;
     void setCommunity( const QByteArray& );
 
+    QByteArray userName() const;
+    void setUserName( const QByteArray& );
+
+    int securityLevel() const;
+    void setSecurityLevel( const int );
+
+    void setAuthPassword( const QByteArray& );
+    void setPrivPassword( const QByteArray& );
+
     int responseTimeout() const;
     void setResponseTimeout( const int );
 
     int getRequestLimit() const;
     void setGetRequestLimit( const int );
 
+    int setRequestLimit() const;
+    void setSetRequestLimit( const int );
+
+    double rateLimit() const;
+    int rateBurst() const;
+    void setRateLimit( const double pdus_per_second,
+                       const int burst );
+
+    int circuitBreakerThreshold() const;
+    int circuitBreakerProbeInterval() const;
+    void setCircuitBreaker( const int failures,
+                            const int probe_interval_ms );
+    bool isAgentAvailable() const;
+
+    int walkRowLimit() const;
+    int walkTimeLimit() const;
+    void setWalkLimits( const int max_rows,
+                        const int max_duration_ms );
+
+    // NOTE: applies all the settings at once, the agent is registered
+    //       by the shared transport without any socket operation
+    void setConfig( const QtSnmpAgentConfig& );
+
     bool isBusy() const;
 
-    qint32 requestValues( const QStringList& oid_list );
+    QtSnmpMetrics metrics() const;
+
+    // NOTE: the result of a request with a callback is passed only to it
+    qint32 requestValues( const QStringList& oid_list,
+                          const QtSnmpCallback& = QtSnmpCallback() );
+
+    qint32 requestValues( const QtSnmpPreparedRequest&,
+                          const QtSnmpCallback& = QtSnmpCallback() );
 
-    qint32 requestSubValues( const QString& oid );
+    qint32 requestSubValues( const QString& oid,
+                             const QtSnmpCallback& = QtSnmpCallback() );
+
+    qint32 requestSubValuesIfChanged( const QString& oid,
+                                      const QString& guard_oid,
+                                      const QtSnmpCallback& = QtSnmpCallback() );
+
+    qint32 requestTable( const QString& entry_oid,
+                         const QtSnmpCallback& = QtSnmpCallback() );
 
     qint32 setValue( const QByteArray& community,
                      const QString& oid,
                      const int type,
-                     const QByteArray& value );
+                     const QByteArray& value,
+                     const QtSnmpCallback& = QtSnmpCallback() );
+
+    qint32 setValues( const QByteArray& community,
+                      const QtSnmpDataList& values,
+                      const QtSnmpCallback& = QtSnmpCallback() );
 
     void sendRequestGetValues( const QStringList& names );
+    void sendPreparedGetValues( const QtSnmpPreparedRequest::Chunk& );
     void sendRequestGetNextValue( const QString& name );
     void sendRequestSetValue( const QByteArray& community,
                               const QString& name,
                               const int type,
                               const QByteArray& value );
-    void completeWork( const QtSnmpDataList& );
-    void failWork();
+    void sendRequestSetValues( const QByteArray& community,
+                               const QtSnmpDataList& values,
+                               const size_t first,
+                               const size_t count );
+    void completeWork( QtSnmpDataList&& );
+    void completeWork( const QtSnmpDataListPtr& );
+    void completeTable( QtSnmpTable&& );
+    void completeSet( QtSnmpDataList&&,
+                      std::vector< int >&& status );
+    void failWork( const int error = QtSnmpResult::RequestFailed );
+
+    // NOTE: the last walks of the conditional requests,
+    //       they are dropped when the agent is changed
+    struct CachedWalk {
+        QtSnmpData guard;
+        QtSnmpDataListPtr values;
+    };
+    bool findWalk( const QString& oid,
+                   const QString& guard_oid,
+                   CachedWalk*const ) const;
+    void storeWalk( const QString& oid,
+                    const QString& guard_oid,
+                    const QtSnmpData& guard,
+                    const QtSnmpDataListPtr& values );
+
+    // NOTE: called by the transport for the datagrams of the session
+    void receiveDatagram( const QByteArray& );
+
+protected:
+    bool event( QEvent* ) override;
 
 private:
     Q_SIGNAL void responseReceived( const qint32 request_id,
-                                    const QtSnmpDataList& );
+                                    const QtSnmpDataListPtr& );
+    Q_SIGNAL void tableReceived( const qint32 request_id,
+                                 const QtSnmpTablePtr& );
     Q_SIGNAL void requestFailed( const qint32 request_id );
+    Q_SIGNAL void walkAborted( const qint32 request_id,
+                               const int error );
 
 private:
     void addWork( const JobPointer& );
+    void deliverFailure( const JobPointer&,
+                         const int error = QtSnmpResult::RequestFailed );
     void startNextWork();
-    void finishWork();
-    Q_SLOT void onResponseTimeExpired();
+    JobPointer finishWork();
+    void onResponseTimeExpired();
     void cancelWork();
-    Q_SLOT void onReadyRead();
+    void openCircuit();
+    void scheduleProbe();
+    void onProbeTime();
+    Q_SLOT void rejectQueuedWork();
+    void addJobLatency();
+    bool isLogAllowed( const LogThrottle::Kind );
+    Transport& transport();
+    void detachTransport();
+    void setTimer( TimerWheel::TimerId*const,
+                   const qint64 delay_ms,
+                   void ( Session::*handler )() );
+    void cancelTimer( TimerWheel::TimerId*const );
     void processIncommingDatagram( const QByteArray& );
+    void processResponse( ResponseDecoder::Result&& );
+    void processDecodedResponses();
+    void logInvalidResponse( const ResponseDecoder::Invalid&,
+                             const int count = 1 );
+    void transmitDatagram( const QByteArray&,
+                           const bool is_retransmission );
+    void onPacingTimeExpired();
+    qint64 takeSendToken();
     bool writeDatagram( const QByteArray& );
-    void sendRequest( const QtSnmpData& );
+    QByteArray makeDatagram( const QtSnmpData& pdu,
+                             const QByteArray& community );
+    void sendRequest( const QtSnmpData& pdu,
+                      const QByteArray& community );
+    void resendRequest();
+    void updateAgent();
     qint32 createWorkId();
     void updateRequestId();
+    void forgetRequestId( const qint32 );
+    void releaseRequestIds();
 
 private:
     QHostAddress m_agent_address;
     quint16 m_agent_port = 161; // default SNMP port
     int m_protocol_version = 1; // v2c is default protocol version
     QByteArray m_community;
-    QUdpSocket m_socket;
-    QTimer m_response_wait_timer;
+    Usm m_usm;
+    std::shared_ptr< Transport > m_transport;
+    std::atomic_int m_response_timeout;
+    TimerWheel::TimerId m_response_timer = 0;
+    TimerWheel::TimerId m_pacing_timer = 0;
+    TokenBucket m_rate_limit;
+    CircuitBreaker m_breaker;
+    TimerWheel::TimerId m_probe_timer = 0;
+    bool m_is_rejection_posted = false;
+    QByteArray m_paced_datagram;
+    bool m_is_paced_retransmission = false;
     qint32 m_work_id = 1;
     qint32 m_request_id = -1;
+    QVector< qint32 > m_request_attempts;
     QQueue< qint32 > m_request_history_queue;
     QtSnmpData m_last_request_data;
-    QByteArray m_last_request_datagram;
+    QByteArray m_last_request_community;
+    QByteArray m_last_request_datagram; // of a prepared request
+    int m_last_request_id_offset = -1;
+    QHash< QString, CachedWalk > m_walk_cache;
     SnmpJobList m_work_queue;
     JobPointer m_current_work;
     int m_timeout_cnt = 0;
+    int m_report_cnt = 0;
+    qint64 m_send_time = 0;
+    Metrics m_metrics;
+    LogThrottle m_log_throttle;
+    BerArena m_arena;
+    BerArena m_scoped_pdu_arena;
+    std::shared_ptr< DecodeInbox > m_decode_inbox;
     std::atomic_int m_get_limit = {0};
+    std::atomic_int m_set_limit = {0};
+    std::atomic_int m_walk_row_limit = {0};
+    std::atomic_int m_walk_time_limit = {0};
 };
 
 } // namespace qtsnmpclient
@@ -0,0 +1,107 @@
+#include "SetValuesJob.h"
+#include "Session.h"
+
+namespace qtsnmpclient {
+
+namespace {
+    const int too_big = 1;
+
+    // NOTE: the encoded var binds of a PDU, the rest of the message
+    //       (the header, the community or the USM parameters) still
+    //       fits into 1472 bytes of a datagram of 1500 bytes MTU
+    const int max_var_binds_size = 1200;
+}
+
+SetValuesJob::SetValuesJob( Session*const session,
+                            const qint32 id,
+                            const QByteArray& community,
+                            const QtSnmpDataList& values,
+                            const int limit )
+    : AbstractJob( session, id )
+    , m_community( community )
+    , m_values( values )
+    , m_limit( limit )
+{
+}
+
+void SetValuesJob::start() {
+    m_sizes.clear();
+    m_sizes.reserve( m_values.size() );
+    for ( const auto& value : m_values ) {
+        auto var_bind = QtSnmpData::sequence();
+        var_bind.addChild( QtSnmpData::oid( value.address() ) );
+        var_bind.emplaceChild( value.type(), value.data() );
+        m_sizes.push_back( var_bind.makeSnmpChunk().size() );
+    }
+    m_status.assign( m_values.size(), 0 );
+    m_results.clear();
+    m_results.reserve( m_values.size() );
+    m_next = 0;
+    m_chunk_size = ( m_limit > 0 ) ? static_cast< size_t >( m_limit ) : m_values.size();
+
+    if ( m_values.empty() ) {
+        m_session->completeSet( std::move( m_results ), std::move( m_status ) );
+        return;
+    }
+    makeRequest();
+}
+
+void SetValuesJob::processData( QtSnmpDataList&& values,
+                                const QList< ErrorResponse >& error )
+{
+    if ( ! error.isEmpty() ) {
+        const auto& response = error.first();
+        if ( 0 == response.code ) {
+            // NOTE: a report is not about the values
+            m_session->failWork();
+            return;
+        }
+        if ( ( too_big == response.code ) && ( m_sent > 1 ) ) {
+            m_chunk_size = m_sent / 2;
+            makeRequest();
+            return;
+        }
+
+        const auto index = static_cast< size_t >( response.index );
+        for ( size_t i = 0; i < m_sent; ++i ) {
+            const bool is_failed = ( 0 == index ) || ( index == i + 1 ) || ( index > m_sent );
+            m_status[ m_next + i ] = is_failed ? response.code : int( QtSnmpResult::SetNotApplied );
+        }
+    } else {
+        m_results.insert( m_results.end(),
+                          std::make_move_iterator( values.begin() ),
+                          std::make_move_iterator( values.end() ) );
+    }
+
+    m_next += m_sent;
+    if ( m_next < m_values.size() ) {
+        makeRequest();
+        return;
+    }
+    m_session->completeSet( std::move( m_results ), std::move( m_status ) );
+}
+
+void SetValuesJob::makeRequest() {
+    const size_t rest = m_values.size() - m_next;
+    size_t count = 0;
+    int size = 0;
+    while ( ( count < rest ) && ( count < m_chunk_size ) ) {
+        size += m_sizes.at( m_next + count );
+        if ( ( count > 0 ) && ( size > max_var_binds_size ) ) {
+            break;
+        }
+        ++count;
+    }
+    m_sent = count;
+    m_session->sendRequestSetValues( m_community, m_values, m_next, m_sent );
+}
+
+QString SetValuesJob::description() const {
+    QStringList oid_list;
+    for ( const auto& value : m_values ) {
+        oid_list << QString::fromLatin1( value.address() );
+    }
+    return "requestSetValues: " + oid_list.join( "; " );
+}
+
+} // namespace qtsnmpclient
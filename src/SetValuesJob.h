@@ -0,0 +1,41 @@
+#pragma once
+
+#include "AbstractJob.h"
+
+namespace qtsnmpclient {
+
+// NOTE: Sets many values (the OIDs are their addresses) with as few PDUs
+//       as possible. A PDU takes the values up to the request limit and
+//       up to the size which fits a datagram of the usual MTU; after
+//       a tooBig response its values are sent again in two halves.
+//       A PDU with an error is applied by the agent entirely or not at all,
+//       so the value of the error index gets the error status and the other
+//       values of the PDU get SetNotApplied, the next PDUs are still sent.
+class SetValuesJob : public AbstractJob {
+    Q_DISABLE_COPY( SetValuesJob )
+public:
+    explicit SetValuesJob( Session*const,
+                           const qint32 id,
+                           const QByteArray& community,
+                           const QtSnmpDataList& values,
+                           const int limit );
+    virtual void start() override final;
+    virtual void processData( QtSnmpDataList&&, const QList< ErrorResponse >& ) override final;
+    virtual QString description() const override final;
+
+private:
+    void makeRequest();
+
+private:
+    const QByteArray m_community;
+    const QtSnmpDataList m_values;
+    const int m_limit = 0;
+    std::vector< int > m_sizes;
+    std::vector< int > m_status;
+    QtSnmpDataList m_results;
+    size_t m_next = 0;
+    size_t m_sent = 0;
+    size_t m_chunk_size = 0;
+};
+
+} // namespace qtsnmpclient
@@ -0,0 +1,157 @@
+#include "TimerWheel.h"
+#include <limits>
+
+namespace qtsnmpclient {
+
+const qint64 TimerWheel::MAX_DELTA;
+
+TimerWheel::TimerWheel( const qint64 now )
+    : m_current( now )
+{
+}
+
+TimerWheel::TimerId TimerWheel::add( const qint64 deadline,
+                                     const Callback& callback )
+{
+    const auto id = ++m_last_id;
+    Entry entry;
+    entry.deadline = deadline;
+    entry.callback = callback;
+    m_entries.insert( id, entry );
+    place( id, deadline );
+    return id;
+}
+
+bool TimerWheel::cancel( const TimerId id ) {
+    // NOTE: the id is left in its slot and skipped when the slot is processed
+    return m_entries.remove( id ) > 0;
+}
+
+bool TimerWheel::isActive( const TimerId id ) const {
+    return m_entries.contains( id );
+}
+
+int TimerWheel::count() const {
+    return m_entries.size();
+}
+
+void TimerWheel::advance( const qint64 now ) {
+    while ( m_current <= now ) {
+        if ( m_entries.isEmpty() ) {
+            m_current = now + 1;
+            return;
+        }
+        const auto next_tick = nextEventTick();
+        if ( next_tick > now ) {
+            m_current = now + 1;
+            return;
+        }
+        m_current = next_tick;
+        processTick();
+    }
+}
+
+qint64 TimerWheel::nextWakeUp() const {
+    if ( m_entries.isEmpty() ) {
+        return -1;
+    }
+    return nextEventTick();
+}
+
+qint64 TimerWheel::currentTime() const {
+    return m_current;
+}
+
+void TimerWheel::place( const TimerId id, const qint64 deadline ) {
+    qint64 expires = qMax( deadline, m_current );
+    qint64 delta = expires - m_current;
+    if ( delta >= MAX_DELTA ) {
+        delta = MAX_DELTA - 1;
+        expires = m_current + delta;
+    }
+
+    int level = 0;
+    while ( delta >= ( static_cast< qint64 >( 1 ) << ( SLOT_BITS * ( level + 1 ) ) ) ) {
+        ++level;
+    }
+    const auto slot = static_cast< size_t >( ( expires >> ( SLOT_BITS * level ) ) & ( SLOT_COUNT - 1 ) );
+    m_wheels[ static_cast< size_t >( level ) ][ slot ].push_back( id );
+}
+
+void TimerWheel::cascade( const int level, const int slot ) {
+    Slot ids;
+    ids.swap( m_wheels[ static_cast< size_t >( level ) ][ static_cast< size_t >( slot ) ] );
+    for ( const auto id : ids ) {
+        const auto iter = m_entries.constFind( id );
+        if ( m_entries.constEnd() != iter ) {
+            place( id, iter->deadline );
+        }
+    }
+}
+
+qint64 TimerWheel::nextEventTick() const {
+    // NOTE: a slot of the lowest level has to be processed at its tick,
+    //       a slot of an upper level at the tick it is cascaded at
+    //       (the turn of the level below); the empty slots are skipped.
+    const int index = static_cast< int >( m_current & ( SLOT_COUNT - 1 ) );
+    qint64 result = std::numeric_limits< qint64 >::max();
+    for ( int i = 0; i < SLOT_COUNT; ++i ) {
+        const int slot = ( index + i ) & ( SLOT_COUNT - 1 );
+        if ( ! m_wheels[ 0 ][ static_cast< size_t >( slot ) ].empty() ) {
+            result = m_current + i;
+            break;
+        }
+    }
+
+    for ( int level = 1; level < LEVEL_COUNT; ++level ) {
+        const int shift = SLOT_BITS * level;
+        const qint64 span = static_cast< qint64 >( 1 ) << shift;
+        const qint64 turn = ( ( m_current + span - 1 ) >> shift ) << shift;
+        if ( turn >= result ) {
+            break;
+        }
+        const int position = static_cast< int >( ( turn >> shift ) & ( SLOT_COUNT - 1 ) );
+        for ( int i = 0; i < SLOT_COUNT; ++i ) {
+            const int slot = ( position + i ) & ( SLOT_COUNT - 1 );
+            if ( ! m_wheels[ static_cast< size_t >( level ) ][ static_cast< size_t >( slot ) ].empty() ) {
+                result = qMin( result, turn + i * span );
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+void TimerWheel::processTick() {
+    const qint64 tick = m_current;
+    const int index = static_cast< int >( tick & ( SLOT_COUNT - 1 ) );
+    if ( 0 == index ) {
+        for ( int level = 1; level < LEVEL_COUNT; ++level ) {
+            const int slot = static_cast< int >( ( tick >> ( SLOT_BITS * level ) ) & ( SLOT_COUNT - 1 ) );
+            cascade( level, slot );
+            if ( 0 != slot ) {
+                break;
+            }
+        }
+    }
+
+    Slot ids;
+    ids.swap( m_wheels[ 0 ][ static_cast< size_t >( index ) ] );
+    // NOTE: the timers added by the callbacks are placed after this tick
+    m_current = tick + 1;
+    for ( const auto id : ids ) {
+        auto iter = m_entries.find( id );
+        if ( m_entries.end() == iter ) {
+            continue;
+        }
+        if ( iter->deadline > tick ) {
+            place( id, iter->deadline );
+            continue;
+        }
+        const auto callback = iter->callback;
+        m_entries.erase( iter );
+        callback();
+    }
+}
+
+} // namespace qtsnmpclient
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QHash>
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace qtsnmpclient {
+
+// NOTE: A hierarchical timer wheel: LEVEL_COUNT wheels of SLOT_COUNT slots,
+//       a slot of the level N covers SLOT_COUNT^N ticks. Adding and
+//       cancelling a timer are O(1), a timer is moved to a lower level
+//       at most LEVEL_COUNT - 1 times before it fires. The wheel does not
+//       read any clock, the time is given in ticks by the owner; a tick is
+//       a millisecond for all users of the library. Timers more than
+//       MAX_DELTA ticks ahead are parked at the top level and re-placed
+//       when it turns around.
+class TimerWheel {
+    Q_DISABLE_COPY( TimerWheel )
+public:
+    typedef quint64 TimerId;
+    typedef std::function< void() > Callback;
+
+    enum : int {
+        SLOT_BITS = 6,
+        SLOT_COUNT = 1 << SLOT_BITS,
+        LEVEL_COUNT = 5,
+    };
+    static const qint64 MAX_DELTA = static_cast< qint64 >( 1 ) << ( SLOT_BITS * LEVEL_COUNT );
+
+    explicit TimerWheel( const qint64 now = 0 );
+
+    // NOTE: a deadline before currentTime() fires at the next tick
+    TimerId add( const qint64 deadline,
+                 const Callback& );
+    bool cancel( const TimerId );
+    bool isActive( const TimerId ) const;
+    int count() const;
+
+    // NOTE: fires the timers with deadlines up to 'now' inclusively;
+    //       the callbacks may add and cancel timers
+    void advance( const qint64 now );
+
+    // NOTE: the tick to call advance() at, the timers never fire
+    //       before it, -1 if there are no timers
+    qint64 nextWakeUp() const;
+
+    qint64 currentTime() const;
+
+private:
+    struct Entry {
+        qint64 deadline = 0;
+        Callback callback;
+    };
+    typedef std::vector< TimerId > Slot;
+
+    void place( const TimerId, const qint64 deadline );
+    void cascade( const int level, const int slot );
+    qint64 nextEventTick() const;
+    void processTick();
+
+private:
+    // NOTE: the next tick to process
+    qint64 m_current = 0;
+    TimerId m_last_id = 0;
+    QHash< TimerId, Entry > m_entries;
+    std::array< std::array< Slot, SLOT_COUNT >, LEVEL_COUNT > m_wheels;
+};
+
+} // namespace qtsnmpclient
@@ -0,0 +1,71 @@
+#include "TokenBucket.h"
+#include <QMutexLocker>
+#include <cmath>
+
+namespace qtsnmpclient {
+
+double TokenBucket::rate() const {
+    QMutexLocker locker( &m_mutex );
+    return m_rate;
+}
+
+int TokenBucket::burst() const {
+    QMutexLocker locker( &m_mutex );
+    return m_burst;
+}
+
+void TokenBucket::setRate( const double per_second,
+                           const int burst )
+{
+    QMutexLocker locker( &m_mutex );
+    m_rate = qMax( 0.0, per_second );
+    m_burst = qMax( 1, burst );
+    m_tokens = m_burst;
+    m_last_time = 0;
+}
+
+qint64 TokenBucket::take( const qint64 now ) {
+    QMutexLocker locker( &m_mutex );
+    if ( m_rate <= 0 ) {
+        return 0;
+    }
+    refill( now );
+    if ( m_tokens >= 1 ) {
+        m_tokens -= 1;
+        return 0;
+    }
+    return waitTimeUnlocked();
+}
+
+qint64 TokenBucket::waitTime( const qint64 now ) const {
+    QMutexLocker locker( &m_mutex );
+    if ( m_rate <= 0 ) {
+        return 0;
+    }
+    refill( now );
+    return ( m_tokens >= 1 ) ? 0 : waitTimeUnlocked();
+}
+
+TokenBucket& TokenBucket::global() { // static
+    static TokenBucket bucket;
+    return bucket;
+}
+
+void TokenBucket::refill( const qint64 now ) const {
+    if ( 0 == m_last_time ) {
+        m_last_time = now;
+        return;
+    }
+    if ( now > m_last_time ) {
+        m_tokens = qMin( static_cast< double >( m_burst ),
+                         m_tokens + static_cast< double >( now - m_last_time ) * m_rate / 1000000.0 );
+        m_last_time = now;
+    }
+}
+
+qint64 TokenBucket::waitTimeUnlocked() const {
+    Q_ASSERT( m_rate > 0 );
+    return qMax< qint64 >( 1, static_cast< qint64 >( std::ceil( ( 1 - m_tokens ) * 1000000.0 / m_rate ) ) );
+}
+
+} // namespace qtsnmpclient
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QMutex>
+
+namespace qtsnmpclient {
+
+// NOTE: A token bucket which limits the rate of outgoing PDUs: the tokens
+//       are refilled at 'rate' per second up to 'burst', every PDU takes
+//       one token. A zero rate means no limit. The time is given
+//       in microseconds of a steady clock (see Metrics::now()).
+//       The methods are thread safe, so one bucket may be shared by all
+//       the sessions of the process (see global()).
+class TokenBucket {
+    Q_DISABLE_COPY( TokenBucket )
+public:
+    TokenBucket() = default;
+
+    double rate() const;
+    int burst() const;
+    void setRate( const double per_second,
+                  const int burst );
+
+    // NOTE: returns 0 if a token has been taken, otherwise how many
+    //       microseconds are left until the next token
+    qint64 take( const qint64 now );
+    qint64 waitTime( const qint64 now ) const;
+
+    static TokenBucket& global();
+
+private:
+    void refill( const qint64 now ) const;
+    qint64 waitTimeUnlocked() const;
+
+private:
+    mutable QMutex m_mutex;
+    double m_rate = 0;
+    int m_burst = 1;
+    mutable double m_tokens = 1;
+    mutable qint64 m_last_time = 0;
+};
+
+} // namespace qtsnmpclient
@@ -0,0 +1,383 @@
+#include "Transport.h"
+#include "Session.h"
+#include "Metrics.h"
+#include "QtSnmpData.h"
+#include <QThread>
+
+namespace qtsnmpclient {
+
+namespace {
+    // NOTE: the socket buffer has to hold the responses of many agents
+    //       received between two passes of the event loop
+    const int receive_buffer_size = 4 * 1024 * 1024;
+    const int read_interval = 300;
+
+    // NOTE: the received datagrams are read into a ring of buffers, which
+    //       are reused while nobody else refers to them (e.g. a datagram
+    //       being decoded by the pool), so the steady reading allocates nothing
+    const int receive_buffer_count = 8;
+    const int receive_buffer_capacity = 4096;
+
+    const int snmp_v3 = 3;
+
+    // NOTE: returns the offset of the content of the item at the offset
+    //       or -1 if the item does not fit into the data
+    int readHeader( const QByteArray& data,
+                    const int offset,
+                    const int end,
+                    int*const type,
+                    int*const length )
+    {
+        if ( offset + 2 > end ) {
+            return -1;
+        }
+        *type = static_cast< quint8 >( data.at( offset ) );
+        int pos = offset + 1;
+        int size = static_cast< quint8 >( data.at( pos++ ) );
+        if ( size & 0x80 ) {
+            const int bytes = size & 0x7F;
+            if ( ( bytes < 1 ) || ( bytes > 3 ) || ( pos + bytes > end ) ) {
+                return -1;
+            }
+            size = 0;
+            for ( int i = 0; i < bytes; ++i ) {
+                size = ( size << 8 ) | static_cast< quint8 >( data.at( pos++ ) );
+            }
+        }
+        if ( pos + size > end ) {
+            return -1;
+        }
+        *length = size;
+        return pos;
+    }
+
+    bool readInteger( const QByteArray& data,
+                      const int offset,
+                      const int end,
+                      qint64*const value,
+                      int*const next,
+                      int*const content = nullptr )
+    {
+        int type = 0;
+        int length = 0;
+        const int pos = readHeader( data, offset, end, &type, &length );
+        if ( ( pos < 0 ) || ( QtSnmpData::INTEGER_TYPE != type ) || ( length < 1 ) || ( length > 5 ) ) {
+            return false;
+        }
+        qint64 result = static_cast< qint8 >( data.at( pos ) );
+        for ( int i = 1; i < length; ++i ) {
+            result = ( result << 8 ) | static_cast< quint8 >( data.at( pos + i ) );
+        }
+        *value = result;
+        *next = pos + length;
+        if ( content ) {
+            *content = pos;
+        }
+        return true;
+    }
+}
+
+std::shared_ptr< Transport > Transport::forCurrentThread() { // static
+    thread_local std::weak_ptr< Transport > current;
+    auto transport = current.lock();
+    if ( ! transport ) {
+        // NOTE: the last session may be deleted by a slot called
+        //       from onReadyRead, so the transport is deleted later
+        transport.reset( new Transport, []( Transport*const object ) { object->deleteLater(); } );
+        current = transport;
+    }
+    return transport;
+}
+
+Transport::Transport()
+    : m_receive_buffers( receive_buffer_count )
+{
+    m_clock.start();
+    m_wheel_timer.setSingleShot( true );
+    m_wheel_timer.setTimerType( Qt::PreciseTimer );
+    connect( &m_wheel_timer, SIGNAL(timeout()), SLOT(onTimer()) );
+
+    connect( &m_socket, SIGNAL(readyRead()), SLOT(onReadyRead()) );
+    if ( m_socket.bind( QHostAddress::AnyIPv4 ) ) {
+        m_socket.setSocketOption( QAbstractSocket::ReceiveBufferSizeSocketOption, receive_buffer_size );
+    } else {
+        qCDebug( lcSession ) << tr( "Unable to bind the SNMP socket: %1" ).arg( m_socket.errorString() );
+    }
+
+    scheduleRead();
+}
+
+Transport::~Transport() = default;
+
+void Transport::setAgent( Session*const session,
+                          const QHostAddress& address,
+                          const quint16 port )
+{
+    Q_ASSERT( thread() == QThread::currentThread() );
+    removeSession( session );
+    AgentKey key;
+    key.address = address;
+    key.port = port;
+    m_session_agents.insert( session, key );
+    m_agent_sessions.insert( key, session );
+}
+
+void Transport::removeSession( Session*const session ) {
+    const auto iter = m_session_agents.find( session );
+    if ( m_session_agents.end() == iter ) {
+        return;
+    }
+    // NOTE: another session of the same agent may have been set later
+    const auto agent_iter = m_agent_sessions.find( iter.value() );
+    if ( ( m_agent_sessions.end() != agent_iter ) && ( session == agent_iter.value() ) ) {
+        m_agent_sessions.erase( agent_iter );
+    }
+    m_session_agents.erase( iter );
+}
+
+qint32 Transport::allocateRequestId( Session*const session ) {
+    Q_ASSERT( thread() == QThread::currentThread() );
+    const auto id = m_request_ids.allocate();
+    m_request_sessions.insert( id, session );
+    return id;
+}
+
+void Transport::addRequestId( const qint32 id,
+                              Session*const session )
+{
+    Q_ASSERT( thread() == QThread::currentThread() );
+    if ( m_request_ids.reserve( id ) ) {
+        m_request_sessions.insert( id, session );
+    }
+}
+
+void Transport::removeRequestId( const qint32 id,
+                                 Session*const session )
+{
+    // NOTE: the id may belong to another session, if it has been
+    //       outstanding here when the session has come to the thread
+    const auto iter = m_request_sessions.find( id );
+    if ( ( m_request_sessions.end() == iter ) || ( session != iter.value() ) ) {
+        return;
+    }
+    m_request_sessions.erase( iter );
+    m_request_ids.release( id );
+}
+
+qint64 Transport::writeDatagram( const QByteArray& datagram,
+                                 const QHostAddress& address,
+                                 const quint16 port )
+{
+    return m_socket.writeDatagram( datagram, address, port );
+}
+
+QString Transport::errorString() const {
+    return m_socket.errorString();
+}
+
+TimerWheel::TimerId Transport::addTimer( const qint64 delay_ms,
+                                         const TimerWheel::Callback& callback )
+{
+    Q_ASSERT( thread() == QThread::currentThread() );
+    const auto id = m_wheel.add( now() + qMax( qint64( 0 ), delay_ms ), callback );
+    updateTimer();
+    return id;
+}
+
+void Transport::cancelTimer( const TimerWheel::TimerId id ) {
+    // NOTE: the QTimer is left as is, an extra wake up is cheaper
+    m_wheel.cancel( id );
+}
+
+void Transport::scheduleRead() {
+    // NOTE: readyRead is not emitted again while there are unread
+    //       datagrams, so the socket is also polled
+    m_wheel.add( now() + read_interval, [this]() {
+        onReadyRead();
+        scheduleRead();
+    } );
+    updateTimer();
+}
+
+qint64 Transport::now() const {
+    return m_clock.elapsed();
+}
+
+void Transport::updateTimer() {
+    const auto wake_up = m_wheel.nextWakeUp();
+    if ( -1 == wake_up ) {
+        m_wheel_timer.stop();
+        m_wake_up = -1;
+        return;
+    }
+    // NOTE: the QTimer is restarted only for an earlier wake up,
+    //       most of the timers are cancelled before they are due
+    if ( m_wheel_timer.isActive() && ( m_wake_up <= wake_up ) ) {
+        return;
+    }
+    m_wake_up = wake_up;
+    m_wheel_timer.start( static_cast< int >( qMax( qint64( 0 ), wake_up - now() ) ) );
+}
+
+void Transport::onTimer() {
+    m_wake_up = -1;
+    m_wheel.advance( now() );
+    updateTimer();
+}
+
+bool Transport::peekMessageId( const QByteArray& datagram,
+                               qint32*const id ) // static
+{
+    Q_ASSERT( id );
+    int offset = 0;
+    int length = 0;
+    if ( ! findMessageId( datagram, &offset, &length ) ) {
+        return false;
+    }
+    qint64 value = static_cast< qint8 >( datagram.at( offset ) );
+    for ( int i = 1; i < length; ++i ) {
+        value = ( value << 8 ) | static_cast< quint8 >( datagram.at( offset + i ) );
+    }
+    *id = static_cast< qint32 >( value );
+    return true;
+}
+
+bool Transport::findMessageId( const QByteArray& datagram,
+                               int*const offset,
+                               int*const id_length ) // static
+{
+    Q_ASSERT( offset && id_length );
+    int type = 0;
+    int length = 0;
+    const int end = datagram.size();
+    int pos = readHeader( datagram, 0, end, &type, &length );
+    if ( ( pos < 0 ) || ( QtSnmpData::SEQUENCE_TYPE != type ) ) {
+        return false;
+    }
+
+    qint64 version = 0;
+    if ( ! readInteger( datagram, pos, end, &version, &pos ) ) {
+        return false;
+    }
+
+    if ( snmp_v3 == version ) {
+        // NOTE: the message id is the first item of the global data
+        pos = readHeader( datagram, pos, end, &type, &length );
+        if ( ( pos < 0 ) || ( QtSnmpData::SEQUENCE_TYPE != type ) ) {
+            return false;
+        }
+    } else {
+        // NOTE: the request id is the first item of the PDU after the community
+        pos = readHeader( datagram, pos, end, &type, &length );
+        if ( ( pos < 0 ) || ( QtSnmpData::STRING_TYPE != type ) ) {
+            return false;
+        }
+        pos = readHeader( datagram, pos + length, end, &type, &length );
+        if ( pos < 0 ) {
+            return false;
+        }
+    }
+
+    qint64 value = 0;
+    int content = 0;
+    if ( ! readInteger( datagram, pos, end, &value, &pos, &content ) ) {
+        return false;
+    }
+    *offset = content;
+    *id_length = pos - content;
+    return true;
+}
+
+Session* Transport::findSession( const QByteArray& datagram,
+                                 const QHostAddress& sender,
+                                 const quint16 sender_port ) const
+{
+    qint32 id = 0;
+    if ( peekMessageId( datagram, &id ) ) {
+        const auto iter = m_request_sessions.constFind( id );
+        if ( m_request_sessions.constEnd() != iter ) {
+            return iter.value();
+        }
+    }
+
+    AgentKey key;
+    key.address = sender;
+    key.port = sender_port;
+    return m_agent_sessions.value( key, nullptr );
+}
+
+bool Transport::isLogAllowed( const LogThrottle::Kind kind ) {
+    if ( ! lcSession().isDebugEnabled() ) {
+        return false;
+    }
+
+    int suppressed = 0;
+    if ( ! m_log_throttle.allow( kind, Metrics::now(), &suppressed ) ) {
+        Metrics::global().add( Metrics::SUPPRESSED_MESSAGES );
+        return false;
+    }
+
+    if ( suppressed > 0 ) {
+        qCDebug( lcSession ) << tr( "%1 similar messages about the SNMP socket have been suppressed." )
+                                    .arg( suppressed );
+    }
+    return true;
+}
+
+QByteArray& Transport::receiveBuffer( const int size ) {
+    auto& buffer = m_receive_buffers[ m_next_receive_buffer ];
+    m_next_receive_buffer = ( m_next_receive_buffer + 1 ) % m_receive_buffers.size();
+    if ( ! buffer.isDetached() || ( buffer.capacity() < size ) ) {
+        buffer = QByteArray();
+        buffer.reserve( qMax( size, receive_buffer_capacity ) );
+    }
+    // NOTE: the bytes are overwritten by the datagram, so they are not filled
+    buffer.resize( size );
+    return buffer;
+}
+
+void Transport::onReadyRead() {
+    if ( QUdpSocket::BoundState != m_socket.state() ) {
+        return;
+    }
+
+    while ( m_socket.hasPendingDatagrams() ) {
+        const int size = static_cast< int >( m_socket.pendingDatagramSize() );
+        if ( size < 0 ) {
+            break;
+        }
+
+        auto& datagram = receiveBuffer( size );
+        auto& sender = m_sender;
+        quint16 sender_port = 0;
+        const auto read_size = m_socket.readDatagram( datagram.data(), size, &sender, &sender_port );
+        if ( size != read_size ) {
+            if ( isLogAllowed( LogThrottle::IO_ERROR ) ) {
+                qCDebug( lcSession ) << tr( "SNMP response reading error.\n"
+                                "Only %1 bytes of %2 have been read from UDP packet from %3.\n"
+                                "Cause: %4" )
+                                .arg( read_size )
+                                .arg( size )
+                                .arg( sender.toString(), m_socket.errorString() );
+            }
+            continue;
+        }
+
+        Session*const session = findSession( datagram, sender, sender_port );
+        if ( ! session ) {
+            auto& metrics = Metrics::global();
+            metrics.add( Metrics::PDUS_RECEIVED );
+            metrics.add( Metrics::BYTES_RECEIVED, static_cast< quint64 >( read_size ) );
+            metrics.add( Metrics::UNEXPECTED_REQUEST_IDS );
+            if ( isLogAllowed( LogThrottle::UNEXPECTED_REQUEST_ID ) ) {
+                qCDebug( lcSession ) << tr( "A datagram from unknown agent %1:%2 has been ignored." )
+                                        .arg( sender.toString() )
+                                        .arg( sender_port );
+            }
+            continue;
+        }
+        session->receiveDatagram( datagram );
+    }
+}
+
+} // namespace qtsnmpclient
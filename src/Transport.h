@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Logging.h"
+#include "RequestIdAllocator.h"
+#include "TimerWheel.h"
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QHostAddress>
+#include <QTimer>
+#include <QUdpSocket>
+#include <memory>
+#include <vector>
+
+namespace qtsnmpclient {
+
+class Session;
+
+struct AgentKey {
+    QHostAddress address;
+    quint16 port = 0;
+
+    bool operator==( const AgentKey& other ) const {
+        return ( port == other.port ) && ( address == other.address );
+    }
+};
+
+inline uint qHash( const AgentKey& key, uint seed = 0 ) {
+    return qHash( key.address, seed ) ^ key.port;
+}
+
+// NOTE: One UDP socket shared by all sessions of a thread. It is bound once,
+//       so a new agent costs no socket, no bind and no timer. A response is
+//       routed to its session by the request id (the message id of SNMPv3),
+//       which is unique among the requests of the socket, and by the agent's
+//       address if the id is unknown, so the stray datagrams are still
+//       accounted by the session of their agent. The transport is created
+//       by the first session of a thread and deleted after the last one.
+//       The timers of the thread (the response timeouts, the pacing delays,
+//       the poll cycles) share one timer wheel driven by one QTimer, so
+//       a timer costs no Qt timer registration.
+class Transport : public QObject {
+    Q_OBJECT
+    Q_DISABLE_COPY( Transport )
+public:
+    static std::shared_ptr< Transport > forCurrentThread();
+    ~Transport() override;
+
+    void setAgent( Session*const,
+                   const QHostAddress&,
+                   const quint16 port );
+    void removeSession( Session*const );
+    // NOTE: a new id unique among the outstanding ids of the socket,
+    //       the responses with it are routed to the session
+    qint32 allocateRequestId( Session*const );
+    // NOTE: an id allocated by the transport of another thread,
+    //       it is ignored if it is outstanding here
+    void addRequestId( const qint32,
+                       Session*const );
+    void removeRequestId( const qint32,
+                          Session*const );
+
+    qint64 writeDatagram( const QByteArray&,
+                          const QHostAddress&,
+                          const quint16 port );
+    QString errorString() const;
+
+    // NOTE: the callback is called by the event loop of the thread
+    //       after the delay in milliseconds
+    TimerWheel::TimerId addTimer( const qint64 delay_ms,
+                                  const TimerWheel::Callback& );
+    void cancelTimer( const TimerWheel::TimerId );
+
+    // NOTE: reads the request id of SNMPv1/v2c message
+    //       or the message id of SNMPv3 one without decoding the rest
+    static bool peekMessageId( const QByteArray& datagram,
+                               qint32*const id );
+
+    // NOTE: finds the bytes of the id read by peekMessageId
+    static bool findMessageId( const QByteArray& datagram,
+                               int*const offset,
+                               int*const length );
+
+private:
+    Transport();
+    Session* findSession( const QByteArray& datagram,
+                          const QHostAddress& sender,
+                          const quint16 sender_port ) const;
+    bool isLogAllowed( const LogThrottle::Kind );
+    Q_SLOT void onReadyRead();
+    QByteArray& receiveBuffer( const int size );
+    void scheduleRead();
+    qint64 now() const;
+    void updateTimer();
+    Q_SLOT void onTimer();
+
+private:
+    QUdpSocket m_socket;
+    QElapsedTimer m_clock;
+    TimerWheel m_wheel;
+    QTimer m_wheel_timer;
+    qint64 m_wake_up = -1;
+    std::vector< QByteArray > m_receive_buffers;
+    size_t m_next_receive_buffer = 0;
+    QHostAddress m_sender;
+    RequestIdAllocator m_request_ids;
+    QHash< qint32, Session* > m_request_sessions;
+    QHash< AgentKey, Session* > m_agent_sessions;
+    QHash< Session*, AgentKey > m_session_agents;
+    LogThrottle m_log_throttle;
+};
+
+} // namespace qtsnmpclient
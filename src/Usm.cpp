@@ -0,0 +1,611 @@
+#include "Usm.h"
+#include <QCryptographicHash>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <chrono>
+#include <random>
+#include <string.h>
+
+namespace qtsnmpclient {
+
+namespace {
+    const int message_version = 3;
+    const int max_message_size = 65507;
+    const int usm_security_model = 3;
+    const int auth_parameters_size = 12;
+    const int salt_size = 8;
+    const int password_to_key_size = 1048576;
+    const qint32 max_engine_boots = 2147483647;
+    const qint32 time_window = 150; // seconds (RFC 3414 2.2.3)
+
+    const auto unknown_engine_ids_oid = QByteArray( ".1.3.6.1.6.3.15.1.1.4" );
+    const auto not_in_time_windows_oid = QByteArray( ".1.3.6.1.6.3.15.1.1.2" );
+
+    qint64 monotonicSeconds() {
+        using namespace std::chrono;
+        return duration_cast< seconds >( steady_clock::now().time_since_epoch() ).count();
+    }
+
+    void writeBigEndian( const quint64 value,
+                         const int size,
+                         quint8*const dest )
+    {
+        for ( int i = 0; i < size; ++i ) {
+            dest[ i ] = static_cast< quint8 >( value >> ( 8*( size - i - 1 ) ) );
+        }
+    }
+
+    bool readHeader( const QByteArray& data,
+                     const int pos,
+                     int*const content_pos,
+                     int*const content_length )
+    {
+        const int total_size = data.size();
+        if ( pos + 2 > total_size ) {
+            return false;
+        }
+
+        int length = static_cast< quint8 >( data.at( pos + 1 ) );
+        int header_size = 2;
+        if ( length & 0x80 ) {
+            const int size_of_size = length & 0x7F;
+            if ( ( size_of_size < 1 ) ||
+                 ( size_of_size > 3 ) ||
+                 ( pos + 2 + size_of_size > total_size ) )
+            {
+                return false;
+            }
+            length = 0;
+            for ( int i = 0; i < size_of_size; ++i ) {
+                length = ( length << 8 ) | static_cast< quint8 >( data.at( pos + 2 + i ) );
+            }
+            header_size += size_of_size;
+        }
+
+        if ( pos + header_size + length > total_size ) {
+            return false;
+        }
+        *content_pos = pos + header_size;
+        *content_length = length;
+        return true;
+    }
+
+    // NOTE: the message authentication parameters are placed at:
+    //       SEQUENCE{ version, globalData, OCTET STRING{ SEQUENCE{
+    //       engineID, boots, time, userName, authParameters, ... } }, ... }
+    int authParametersOffset( const QByteArray& datagram ) {
+        int pos = 0;
+        int length = 0;
+        if ( ! readHeader( datagram, 0, &pos, &length ) ) {
+            return -1;
+        }
+
+        // skip the message version and the global data
+        for ( int i = 0; i < 2; ++i ) {
+            if ( ! readHeader( datagram, pos, &pos, &length ) ) {
+                return -1;
+            }
+            pos += length;
+        }
+
+        // enter the security parameters' octet string and sequence
+        for ( int i = 0; i < 2; ++i ) {
+            if ( ! readHeader( datagram, pos, &pos, &length ) ) {
+                return -1;
+            }
+        }
+
+        // skip engine id, boots, time and user name
+        for ( int i = 0; i < 4; ++i ) {
+            if ( ! readHeader( datagram, pos, &pos, &length ) ) {
+                return -1;
+            }
+            pos += length;
+        }
+
+        if ( ! readHeader( datagram, pos, &pos, &length ) ) {
+            return -1;
+        }
+        return ( auth_parameters_size == length ) ? pos : -1;
+    }
+
+    // NOTE: the time of the comparison doesn't depend on the first
+    //       different byte, so a forged digest can't be guessed byte by byte
+    bool isSameDigest( const char*const digest,
+                       const char*const received_digest )
+    {
+        int difference = 0;
+        for ( int i = 0; i < auth_parameters_size; ++i ) {
+            difference |= digest[ i ] ^ received_digest[ i ];
+        }
+        return 0 == difference;
+    }
+
+    QByteArray passwordToKey( const QByteArray& password ) {
+        QCryptographicHash hash( QCryptographicHash::Sha1 );
+        const int password_size = password.size();
+        const int chunk_size = 64;
+        char chunk[ chunk_size ];
+        int index = 0;
+        for ( int count = 0; count < password_to_key_size; count += chunk_size ) {
+            for ( int i = 0; i < chunk_size; ++i ) {
+                chunk[ i ] = password.at( index++ % password_size );
+            }
+            hash.addData( chunk, chunk_size );
+        }
+        return hash.result();
+    }
+}
+
+QByteArray UsmCache::localizedKey( const QByteArray& password,
+                                   const QByteArray& engine_id ) // static
+{
+    if ( password.isEmpty() || engine_id.isEmpty() ) {
+        return {};
+    }
+
+    static QMutex mutex;
+    static QHash< QByteArray, QByteArray > master_keys;
+    static QHash< QByteArray, QByteArray > localized_keys;
+
+    QMutexLocker locker( &mutex );
+    const QByteArray cache_key = engine_id.toHex() + ':' + password;
+    const auto iter = localized_keys.constFind( cache_key );
+    if ( localized_keys.constEnd() != iter ) {
+        return iter.value();
+    }
+
+    auto master_key = master_keys.value( password );
+    if ( master_key.isEmpty() ) {
+        master_key = passwordToKey( password );
+        master_keys.insert( password, master_key );
+    }
+
+    QCryptographicHash hash( QCryptographicHash::Sha1 );
+    hash.addData( master_key );
+    hash.addData( engine_id );
+    hash.addData( master_key );
+    const auto key = hash.result();
+    localized_keys.insert( cache_key, key );
+    return key;
+}
+
+namespace {
+    QMutex engine_mutex;
+    QHash< QByteArray, UsmCache::EngineState > engine_states;
+}
+
+bool UsmCache::findEngine( const QByteArray& agent,
+                           EngineState*const state ) // static
+{
+    Q_ASSERT( state );
+    QMutexLocker locker( &engine_mutex );
+    const auto iter = engine_states.constFind( agent );
+    if ( engine_states.constEnd() == iter ) {
+        return false;
+    }
+    *state = iter.value();
+    return true;
+}
+
+void UsmCache::storeEngine( const QByteArray& agent,
+                            const EngineState& state ) // static
+{
+    QMutexLocker locker( &engine_mutex );
+    engine_states.insert( agent, state );
+}
+
+Usm::Usm()
+    : m_hmac( QCryptographicHash::Sha1 )
+{
+    std::random_device device;
+    m_salt = ( static_cast< quint64 >( device() ) << 32 ) | device();
+}
+
+QByteArray Usm::userName() const {
+    return m_user_name;
+}
+
+void Usm::setUserName( const QByteArray& value ) {
+    m_user_name = value;
+}
+
+int Usm::securityLevel() const {
+    return m_security_level;
+}
+
+void Usm::setSecurityLevel( const int value ) {
+    m_security_level = value & ( FLAG_AUTH | FLAG_PRIV );
+    if ( m_security_level & FLAG_PRIV ) {
+        // NOTE: there is no privacy without authentication (RFC 3412 6.4)
+        m_security_level |= FLAG_AUTH;
+    }
+}
+
+void Usm::setAuthPassword( const QByteArray& value ) {
+    if ( value != m_auth_password ) {
+        m_auth_password = value;
+        updateKeys();
+    }
+}
+
+void Usm::setPrivPassword( const QByteArray& value ) {
+    if ( value != m_priv_password ) {
+        m_priv_password = value;
+        updateKeys();
+    }
+}
+
+void Usm::setAgent( const QByteArray& agent ) {
+    m_agent = agent;
+    UsmCache::EngineState state;
+    UsmCache::findEngine( agent, &state );
+    setEngine( state );
+}
+
+QByteArray Usm::engineId() const {
+    return m_engine.engine_id;
+}
+
+bool Usm::isDiscovered() const {
+    return ! m_engine.engine_id.isEmpty();
+}
+
+QByteArray Usm::makeMessage( const qint32 request_id,
+                             const QtSnmpData& pdu )
+{
+    if ( ! isDiscovered() ) {
+        return makeDiscoveryMessage( request_id );
+    }
+
+    const bool auth = ( m_security_level & FLAG_AUTH ) && ! m_auth_key.isEmpty();
+    const bool priv = auth && ( m_security_level & FLAG_PRIV );
+    const qint32 time = engineTime();
+
+    auto scoped_pdu = QtSnmpData::sequence();
+    scoped_pdu.addChild( QtSnmpData::string( m_engine.engine_id ) );
+    scoped_pdu.addChild( QtSnmpData::string( QByteArray() ) );
+    scoped_pdu.addChild( pdu );
+
+    QByteArray salt;
+    QtSnmpData message_data;
+    if ( priv ) {
+        // NOTE: IV is concatenation of the engine boots, the engine time
+        //       and the 64-bit salt (RFC 3826 3.1.2.1)
+        quint8 iv[ Aes128::BLOCK_SIZE ];
+        writeBigEndian( static_cast< quint32 >( m_engine.boots ), 4, iv );
+        writeBigEndian( static_cast< quint32 >( time ), 4, iv + 4 );
+        writeBigEndian( ++m_salt, salt_size, iv + 8 );
+        salt = QByteArray( reinterpret_cast< const char* >( iv + 8 ), salt_size );
+
+        const auto plain_text = scoped_pdu.makeSnmpChunk();
+        m_crypt_buffer.resize( plain_text.size() );
+        m_cipher.cfbEncrypt( iv,
+                             reinterpret_cast< const quint8* >( plain_text.constData() ),
+                             plain_text.size(),
+                             reinterpret_cast< quint8* >( m_crypt_buffer.data() ) );
+        message_data = QtSnmpData::string( QByteArray::fromRawData( m_crypt_buffer.constData(),
+                                                                    m_crypt_buffer.size() ) );
+    } else {
+        message_data = scoped_pdu;
+    }
+
+    auto security_parameters = QtSnmpData::sequence();
+    security_parameters.addChild( QtSnmpData::string( m_engine.engine_id ) );
+    security_parameters.addChild( QtSnmpData::integer( m_engine.boots ) );
+    security_parameters.addChild( QtSnmpData::integer( time ) );
+    security_parameters.addChild( QtSnmpData::string( m_user_name ) );
+    security_parameters.addChild( QtSnmpData::string( auth ? QByteArray( auth_parameters_size, '\x0' )
+                                                           : QByteArray() ) );
+    security_parameters.addChild( QtSnmpData::string( salt ) );
+
+    int flags = FLAG_REPORTABLE;
+    flags |= auth ? FLAG_AUTH : 0;
+    flags |= priv ? FLAG_PRIV : 0;
+    auto datagram = packMessage( request_id, flags, security_parameters, message_data );
+    if ( auth ) {
+        const int offset = authParametersOffset( datagram );
+        Q_ASSERT( offset > 0 );
+        m_hmac.reset();
+        m_hmac.addData( datagram );
+        const auto digest = m_hmac.result();
+        memcpy( datagram.data() + offset, digest.constData(), auth_parameters_size );
+    }
+    return datagram;
+}
+
+bool Usm::processMessage( const QByteArray& datagram,
+                          const BerArena& arena,
+                          const int message,
+                          BerArena*const scoped_pdu_arena,
+                          MessageInfo*const info,
+                          const char**const error )
+{
+    Q_ASSERT( scoped_pdu_arena && info && error );
+    Q_ASSERT( 4 == arena.childCount( message ) );
+
+    const int global_data = arena.child( message, 1 );
+    if ( ( QtSnmpData::SEQUENCE_TYPE != arena.type( global_data ) ) ||
+         ( 4 != arena.childCount( global_data ) ) )
+    {
+        *error = "Invalid global data of SNMPv3 message";
+        return false;
+    }
+
+    const int msg_id_data = arena.firstChild( global_data );
+    if ( QtSnmpData::INTEGER_TYPE != arena.type( msg_id_data ) ) {
+        *error = "Invalid message id of SNMPv3 message";
+        return false;
+    }
+    info->msg_id = static_cast< qint32 >( arena.integerValue( msg_id_data ) );
+
+    const int flags_data = arena.child( global_data, 2 );
+    if ( ( QtSnmpData::STRING_TYPE != arena.type( flags_data ) ) || ( 1 != arena.size( flags_data ) ) ) {
+        *error = "Invalid flags of SNMPv3 message";
+        return false;
+    }
+    const int flags = static_cast< quint8 >( arena.rawData( flags_data ).at( 0 ) );
+
+    const int model_data = arena.next( flags_data );
+    if ( ( QtSnmpData::INTEGER_TYPE != arena.type( model_data ) ) ||
+         ( usm_security_model != arena.integerValue( model_data ) ) )
+    {
+        *error = "Unsupported security model of SNMPv3 message";
+        return false;
+    }
+
+    // NOTE: the security parameters are encoded inside of an octet string,
+    //       so their own arena parses the same bytes of the datagram
+    const int security_data = arena.next( global_data );
+    int security_list = -1;
+    if ( ( QtSnmpData::STRING_TYPE == arena.type( security_data ) ) &&
+         m_security_arena.parse( arena.rawData( security_data ) ) )
+    {
+        security_list = m_security_arena.first();
+    }
+    if ( ( security_list < 0 ) ||
+         ( m_security_arena.next( security_list ) >= 0 ) ||
+         ( QtSnmpData::SEQUENCE_TYPE != m_security_arena.type( security_list ) ) ||
+         ( 6 != m_security_arena.childCount( security_list ) ) )
+    {
+        *error = "Invalid security parameters of SNMPv3 message";
+        return false;
+    }
+
+    const int expected_types[] = { QtSnmpData::STRING_TYPE,
+                                   QtSnmpData::INTEGER_TYPE,
+                                   QtSnmpData::INTEGER_TYPE,
+                                   QtSnmpData::STRING_TYPE,
+                                   QtSnmpData::STRING_TYPE,
+                                   QtSnmpData::STRING_TYPE };
+    int parameters[ 6 ];
+    int parameter = m_security_arena.firstChild( security_list );
+    for ( int i = 0; i < 6; ++i ) {
+        if ( expected_types[ i ] != m_security_arena.type( parameter ) ) {
+            *error = "Invalid security parameters of SNMPv3 message";
+            return false;
+        }
+        parameters[ i ] = parameter;
+        parameter = m_security_arena.next( parameter );
+    }
+
+    UsmCache::EngineState message_engine;
+    message_engine.engine_id = m_security_arena.rawData( parameters[ 0 ] );
+    message_engine.boots = static_cast< qint32 >( m_security_arena.integerValue( parameters[ 1 ] ) );
+    message_engine.time = static_cast< qint32 >( m_security_arena.integerValue( parameters[ 2 ] ) );
+    message_engine.sync_point = monotonicSeconds();
+
+    if ( flags & FLAG_AUTH ) {
+        const auto received_digest = m_security_arena.rawData( parameters[ 4 ] );
+        const int offset = authParametersOffset( datagram );
+        bool ok = ! m_auth_key.isEmpty();
+        ok = ok && ( message_engine.engine_id == m_engine.engine_id );
+        ok = ok && ( offset > 0 );
+        ok = ok && ( auth_parameters_size == received_digest.size() );
+        if ( ok ) {
+            // NOTE: the digest is computed over the datagram with zeroed
+            //       authentication parameters, without a copy of it
+            const char zero_digest[ auth_parameters_size ] = {};
+            const int tail_offset = offset + auth_parameters_size;
+            m_hmac.reset();
+            m_hmac.addData( datagram.constData(), offset );
+            m_hmac.addData( zero_digest, auth_parameters_size );
+            m_hmac.addData( datagram.constData() + tail_offset, datagram.size() - tail_offset );
+            const auto digest = m_hmac.result();
+            ok = isSameDigest( digest.constData(), received_digest.constData() );
+        }
+        if ( ! ok ) {
+            *error = "Authentication failure of SNMPv3 message";
+            return false;
+        }
+
+        // NOTE: only an authenticated message can move the engine clock forward,
+        //       and a message behind the time window is a replay (RFC 3414 3.2.7.b)
+        const bool newer = ( message_engine.boots > m_engine.boots ) ||
+                           ( ( message_engine.boots == m_engine.boots ) &&
+                             ( message_engine.time > engineTime() ) );
+        const bool outdated = ( message_engine.boots == max_engine_boots ) ||
+                              ( message_engine.boots < m_engine.boots ) ||
+                              ( ( message_engine.boots == m_engine.boots ) &&
+                                ( message_engine.time < m_engine.time - time_window ) );
+        if ( outdated ) {
+            *error = "SNMPv3 message is not in the time window";
+            return false;
+        }
+        if ( newer ) {
+            m_engine.boots = message_engine.boots;
+            m_engine.time = message_engine.time;
+            m_engine.sync_point = message_engine.sync_point;
+            UsmCache::storeEngine( m_agent, m_engine );
+        }
+        info->is_authenticated = true;
+    }
+
+    // NOTE: a plaintext scoped PDU is already parsed by the arena of the datagram,
+    //       only a decrypted one is parsed (once) by the scoped PDU arena
+    const int message_data = arena.next( security_data );
+    int scoped_pdu = message_data;
+    info->pdu_arena = &arena;
+    if ( flags & FLAG_PRIV ) {
+        const auto salt = m_security_arena.rawData( parameters[ 5 ] );
+        bool ok = ( flags & FLAG_AUTH );
+        ok = ok && ( QtSnmpData::STRING_TYPE == arena.type( message_data ) );
+        ok = ok && ( salt_size == salt.size() );
+        if ( ! ok ) {
+            *error = "Invalid privacy parameters of SNMPv3 message";
+            return false;
+        }
+
+        quint8 iv[ Aes128::BLOCK_SIZE ];
+        writeBigEndian( static_cast< quint32 >( message_engine.boots ), 4, iv );
+        writeBigEndian( static_cast< quint32 >( message_engine.time ), 4, iv + 4 );
+        memcpy( iv + 8, salt.constData(), salt_size );
+
+        const auto cipher_text = arena.rawData( message_data );
+        m_crypt_buffer.resize( cipher_text.size() );
+        m_cipher.cfbDecrypt( iv,
+                             reinterpret_cast< const quint8* >( cipher_text.constData() ),
+                             cipher_text.size(),
+                             reinterpret_cast< quint8* >( m_crypt_buffer.data() ) );
+
+        // NOTE: the bytes after the scoped PDU (if any) are ignored
+        int content_pos = 0;
+        int content_length = 0;
+        bool is_decrypted = readHeader( m_crypt_buffer, 0, &content_pos, &content_length );
+        if ( is_decrypted ) {
+            m_crypt_buffer.truncate( content_pos + content_length );
+            is_decrypted = scoped_pdu_arena->parse( m_crypt_buffer );
+        }
+        if ( ! is_decrypted ) {
+            *error = "Decryption failure of SNMPv3 message";
+            return false;
+        }
+        info->pdu_arena = scoped_pdu_arena;
+        scoped_pdu = scoped_pdu_arena->first();
+    }
+
+    const auto pdu_arena = info->pdu_arena;
+    if ( ( QtSnmpData::SEQUENCE_TYPE != pdu_arena->type( scoped_pdu ) ) ||
+         ( 3 != pdu_arena->childCount( scoped_pdu ) ) )
+    {
+        *error = "Invalid scoped PDU of SNMPv3 message";
+        return false;
+    }
+    info->pdu = pdu_arena->child( scoped_pdu, 2 );
+
+    // NOTE: an unauthenticated report is taken only for the discovery
+    const bool is_report = ( QtSnmpData::REPORT_TYPE == pdu_arena->type( info->pdu ) );
+    const bool is_auth_expected = ( m_security_level & FLAG_AUTH ) && ( ! is_report || isDiscovered() );
+    if ( is_auth_expected && ! info->is_authenticated ) {
+        *error = is_report ? "Unauthenticated report to authenticated SNMPv3 request"
+                           : "Unauthenticated response to authenticated SNMPv3 request";
+        return false;
+    }
+    if ( is_report ) {
+        // NOTE: the engine id may be stored, so it is not a view of the datagram
+        info->engine_id = QByteArray( message_engine.engine_id.constData(), message_engine.engine_id.size() );
+    }
+    return true;
+}
+
+bool Usm::processReport( const QtSnmpData& report,
+                         const QByteArray& engine_id,
+                         const bool is_authenticated )
+{
+    Q_ASSERT( QtSnmpData::REPORT_TYPE == report.type() );
+    const auto& report_children = report.children();
+    if ( 4 != report_children.size() ) {
+        return false;
+    }
+
+    const auto& variable_list = report_children.at( 3 ).children();
+    if ( variable_list.empty() || variable_list.at( 0 ).children().empty() ) {
+        return false;
+    }
+
+    const auto oid = variable_list.at( 0 ).children().at( 0 ).data();
+    if ( oid.startsWith( unknown_engine_ids_oid ) ) {
+        // NOTE: a discovery report is not authenticated, so it is taken only
+        //       while the engine is unknown and it gives only the engine id;
+        //       the clock is set by the next authenticated message
+        if ( isDiscovered() || engine_id.isEmpty() ) {
+            return false;
+        }
+        UsmCache::EngineState state;
+        state.engine_id = engine_id;
+        state.sync_point = monotonicSeconds();
+        setEngine( state );
+        return true;
+    }
+
+    // NOTE: the clock is already synchronized by processMessage
+    return oid.startsWith( not_in_time_windows_oid ) && is_authenticated;
+}
+
+void Usm::setEngine( const UsmCache::EngineState& state ) {
+    const bool engine_changed = ( state.engine_id != m_engine.engine_id );
+    m_engine = state;
+    if ( engine_changed ) {
+        updateKeys();
+    }
+}
+
+void Usm::updateKeys() {
+    m_auth_key = UsmCache::localizedKey( m_auth_password, m_engine.engine_id );
+    m_hmac.setKey( m_auth_key );
+
+    const auto priv_key = UsmCache::localizedKey( m_priv_password, m_engine.engine_id );
+    if ( priv_key.size() >= Aes128::KEY_SIZE ) {
+        m_cipher.setKey( reinterpret_cast< const quint8* >( priv_key.constData() ) );
+    }
+}
+
+qint32 Usm::engineTime() const {
+    const qint64 time = m_engine.time + monotonicSeconds() - m_engine.sync_point;
+    return static_cast< qint32 >( qBound( qint64( 0 ), time, qint64( 0x7FFFFFFF ) ) );
+}
+
+QByteArray Usm::makeDiscoveryMessage( const qint32 request_id ) {
+    auto request = QtSnmpData( QtSnmpData::GET_REQUEST_TYPE );
+    request.addChild( QtSnmpData::integer( request_id ) );
+    request.addChild( QtSnmpData::integer( 0 ) );
+    request.addChild( QtSnmpData::integer( 0 ) );
+    request.addChild( QtSnmpData::sequence() );
+
+    auto scoped_pdu = QtSnmpData::sequence();
+    scoped_pdu.addChild( QtSnmpData::string( QByteArray() ) );
+    scoped_pdu.addChild( QtSnmpData::string( QByteArray() ) );
+    scoped_pdu.addChild( request );
+
+    auto security_parameters = QtSnmpData::sequence();
+    security_parameters.addChild( QtSnmpData::string( QByteArray() ) );
+    security_parameters.addChild( QtSnmpData::integer( 0 ) );
+    security_parameters.addChild( QtSnmpData::integer( 0 ) );
+    security_parameters.addChild( QtSnmpData::string( QByteArray() ) );
+    security_parameters.addChild( QtSnmpData::string( QByteArray() ) );
+    security_parameters.addChild( QtSnmpData::string( QByteArray() ) );
+
+    return packMessage( request_id, FLAG_REPORTABLE, security_parameters, scoped_pdu );
+}
+
+QByteArray Usm::packMessage( const qint32 request_id,
+                             const int flags,
+                             const QtSnmpData& security_parameters,
+                             const QtSnmpData& message_data )
+{
+    auto global_data = QtSnmpData::sequence();
+    global_data.addChild( QtSnmpData::integer( request_id ) );
+    global_data.addChild( QtSnmpData::integer( max_message_size ) );
+    global_data.addChild( QtSnmpData::string( QByteArray( 1, static_cast< char >( flags ) ) ) );
+    global_data.addChild( QtSnmpData::integer( usm_security_model ) );
+
+    auto message = QtSnmpData::sequence();
+    message.addChild( QtSnmpData::integer( message_version ) );
+    message.addChild( global_data );
+    message.addChild( QtSnmpData::string( security_parameters.makeSnmpChunk() ) );
+    message.addChild( message_data );
+    return message.makeSnmpChunk();
+}
+
+} // namespace qtsnmpclient
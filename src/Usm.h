@@ -0,0 +1,111 @@
+#pragma once
+
+#include "QtSnmpData.h"
+#include "Aes128.h"
+#include "BerArena.h"
+#include <QByteArray>
+#include <QMessageAuthenticationCode>
+#include <QString>
+
+namespace qtsnmpclient {
+
+// NOTE: The password to key transformation (RFC 3414 A.2) hashes 1MB of data,
+//       so both the master and the localized keys are computed only once per
+//       password (and engine) for the whole process. The cache also keeps
+//       the last known engine parameters of each agent, so a new session
+//       to the same agent doesn't need the discovery round trip.
+class UsmCache {
+public:
+    struct EngineState {
+        QByteArray engine_id;
+        qint32 boots = 0;
+        qint32 time = 0;
+        qint64 sync_point = 0; // seconds of the monotonic clock
+    };
+
+    static QByteArray localizedKey( const QByteArray& password,
+                                    const QByteArray& engine_id );
+    static bool findEngine( const QByteArray& agent,
+                            EngineState*const );
+    static void storeEngine( const QByteArray& agent,
+                             const EngineState& );
+};
+
+// NOTE: User-based Security Model (RFC 3414) with HMAC-SHA-96 authentication
+//       and AES-128 privacy (RFC 3826) for a single agent.
+class Usm {
+    Q_DISABLE_COPY( Usm )
+public:
+    enum {
+        FLAG_AUTH = 0x01,
+        FLAG_PRIV = 0x02,
+        FLAG_REPORTABLE = 0x04,
+    };
+
+    Usm();
+
+    QByteArray userName() const;
+    void setUserName( const QByteArray& );
+
+    int securityLevel() const;
+    void setSecurityLevel( const int );
+
+    void setAuthPassword( const QByteArray& );
+    void setPrivPassword( const QByteArray& );
+
+    void setAgent( const QByteArray& agent );
+    QByteArray engineId() const;
+    bool isDiscovered() const;
+
+    struct MessageInfo {
+        const BerArena* pdu_arena = nullptr;
+        int pdu = -1;
+        qint32 msg_id = 0;
+        bool is_authenticated = false;
+        QByteArray engine_id; // of a report
+    };
+
+    QByteArray makeMessage( const qint32 request_id,
+                            const QtSnmpData& pdu );
+    // NOTE: the message is a node of the arena over the datagram; its PDU is
+    //       found in the same arena or, when encrypted, in the scoped PDU arena.
+    //       Only an authenticated message changes the engine's clock here,
+    //       a report changes nothing before it is matched with a request.
+    bool processMessage( const QByteArray& datagram,
+                         const BerArena& arena,
+                         const int message,
+                         BerArena*const scoped_pdu_arena,
+                         MessageInfo*const,
+                         const char**const error );
+    // NOTE: applies a report matched with a request, it is true if
+    //       the request has to be sent again (discovery or time synchronization)
+    bool processReport( const QtSnmpData& report,
+                        const QByteArray& engine_id,
+                        const bool is_authenticated );
+
+private:
+    void setEngine( const UsmCache::EngineState& );
+    void updateKeys();
+    qint32 engineTime() const;
+    QByteArray makeDiscoveryMessage( const qint32 request_id );
+    QByteArray packMessage( const qint32 request_id,
+                            const int flags,
+                            const QtSnmpData& security_parameters,
+                            const QtSnmpData& message_data );
+
+private:
+    QByteArray m_user_name;
+    QByteArray m_auth_password;
+    QByteArray m_priv_password;
+    int m_security_level = 0;
+    QByteArray m_agent;
+    UsmCache::EngineState m_engine;
+    QByteArray m_auth_key;
+    Aes128 m_cipher;
+    QMessageAuthenticationCode m_hmac;
+    quint64 m_salt = 0;
+    QByteArray m_crypt_buffer;
+    BerArena m_security_arena;
+};
+
+} // namespace qtsnmpclient
@@ -0,0 +1,87 @@
+#include "WalkCursor.h"
+#include <algorithm>
+
+namespace qtsnmpclient {
+
+namespace {
+    const int end_of_mib_view = 0x82;
+}
+
+WalkCursor::WalkCursor( const QByteArray& base_oid )
+    : m_prefix( base_oid + "." )
+{
+}
+
+void WalkCursor::start( const int max_rows,
+                        const qint64 max_duration,
+                        const qint64 now )
+{
+    m_last.clear();
+    m_row_count = 0;
+    m_max_rows = max_rows;
+    m_deadline = ( max_duration > 0 ) ? now + max_duration : 0;
+}
+
+WalkCursor::Step WalkCursor::step( const QtSnmpData& value,
+                                   const qint64 now )
+{
+    const auto oid = value.address();
+    if ( ( end_of_mib_view == value.type() ) || ! oid.startsWith( m_prefix ) || ! parseOid( oid, &m_current ) ) {
+        return END;
+    }
+
+    if ( ! m_last.empty() && ! std::lexicographical_compare( m_last.cbegin(), m_last.cend(),
+                                                             m_current.cbegin(), m_current.cend() ) )
+    {
+        return NOT_INCREASING;
+    }
+    m_last.swap( m_current );
+
+    ++m_row_count;
+    if ( ( m_max_rows > 0 ) && ( m_row_count > m_max_rows ) ) {
+        return LIMIT_EXCEEDED;
+    }
+    if ( ( m_deadline > 0 ) && ( now > m_deadline ) ) {
+        return LIMIT_EXCEEDED;
+    }
+    return NEXT;
+}
+
+bool WalkCursor::parseOid( const QByteArray& oid,
+                           std::vector< quint32 >*const arcs ) // static
+{
+    Q_ASSERT( arcs );
+    arcs->clear();
+    const char* pos = oid.constData();
+    const char*const end = pos + oid.size();
+    if ( ( pos < end ) && ( '.' == *pos ) ) {
+        ++pos;
+    }
+    while ( pos < end ) {
+        quint64 value = 0;
+        const char*const first = pos;
+        while ( ( pos < end ) && ( *pos >= '0' ) && ( *pos <= '9' ) ) {
+            value = value * 10 + static_cast< quint64 >( *pos - '0' );
+            if ( value > 0xFFFFFFFFu ) {
+                return false;
+            }
+            ++pos;
+        }
+        if ( first == pos ) {
+            return false;
+        }
+        arcs->push_back( static_cast< quint32 >( value ) );
+        if ( pos < end ) {
+            if ( '.' != *pos ) {
+                return false;
+            }
+            ++pos;
+            if ( pos == end ) {
+                return false;
+            }
+        }
+    }
+    return ! arcs->empty();
+}
+
+} // namespace qtsnmpclient
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "QtSnmpData.h"
+#include <QByteArray>
+#include <vector>
+
+namespace qtsnmpclient {
+
+// NOTE: Checks the OIDs returned by the GetNext requests of a walk. They have
+//       to be in the subtree of the base OID and strictly increasing, compared
+//       arc by arc as numbers; a buggy agent which returns the same or a lower
+//       OID would loop the walk forever. The walk is also limited by the count
+//       of values and by its duration (in microseconds of Metrics::now()),
+//       zero means no limit.
+class WalkCursor {
+    Q_DISABLE_COPY( WalkCursor )
+public:
+    enum Step {
+        NEXT,           // the row is valid, the walk goes on
+        END,            // the OID is out of the subtree or the MIB view is over
+        NOT_INCREASING,
+        LIMIT_EXCEEDED,
+    };
+
+    explicit WalkCursor( const QByteArray& base_oid );
+
+    void start( const int max_rows,
+                const qint64 max_duration,
+                const qint64 now );
+    Step step( const QtSnmpData& value,
+               const qint64 now );
+
+    // NOTE: the arcs of a dotted OID (the leading dot is optional)
+    static bool parseOid( const QByteArray&,
+                          std::vector< quint32 >*const arcs );
+
+private:
+    const QByteArray m_prefix;
+    std::vector< quint32 > m_last;
+    std::vector< quint32 > m_current;
+    int m_row_count = 0;
+    int m_max_rows = 0;
+    qint64 m_deadline = 0;
+};
+
+} // namespace qtsnmpclient
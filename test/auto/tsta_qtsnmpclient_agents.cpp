@@ -0,0 +1,135 @@
+#include <QTest>
+#include <QDebug>
+#include <QtSnmpClient.h>
+#include <QtSnmpAgentConfig.h>
+#include <QtSnmpFanOut.h>
+#include <Simulator.h>
+
+using namespace qtsnmpsimulator;
+
+namespace {
+    const quint16 TestPort = 65100;
+    const int AgentCount = 8;
+
+    const QByteArray walk =
+        ".1.3.6.1.2.1.1.3.0 = Timeticks: (123456) 0:20:34.56\n";
+}
+
+class TestQtSnmpAgents : public QObject {
+    Q_OBJECT
+    Simulator m_simulator;
+    QScopedPointer< QtSnmpClient > m_client;
+    int m_response_count = 0;
+    int m_fail_count = 0;
+
+    void connectClient( QtSnmpClient*const client ) {
+        connect( client, &QtSnmpClient::responseReceived,
+                 [this]( const qint32, const QtSnmpDataList& ) { ++m_response_count; } );
+        connect( client, &QtSnmpClient::requestFailed,
+                 [this]( const qint32 ) { ++m_fail_count; } );
+    }
+
+private slots:
+    void initTestCase() {
+        Mib mib;
+        mib.loadWalk( walk );
+        m_simulator.setMib( mib );
+        QString error;
+        QVERIFY2( m_simulator.start( QHostAddress::LocalHost, TestPort, AgentCount, &error ),
+                  qPrintable( error ) );
+    }
+
+    void init() {
+        m_simulator.setConfig( AgentConfig() );
+        m_simulator.setSeed( 1 );
+        m_response_count = 0;
+        m_fail_count = 0;
+
+        m_client.reset( new QtSnmpClient );
+        m_client->setAgentAddress( QHostAddress::LocalHost );
+        m_client->setAgentPort( TestPort );
+        m_client->setReponseTimeout( 100 );
+        connectClient( m_client.data() );
+    }
+
+    void testBulkConfig() {
+        QByteArray json = "[";
+        for ( int i = 0; i < AgentCount; ++i ) {
+            json += QString( "{\"address\": \"127.0.0.1\", \"port\": %1, \"version\": \"v2c\", "
+                             "\"community\": \"public\", \"timeout\": 500},\n" )
+                    .arg( m_simulator.agentPort( i ) ).toLatin1();
+        }
+        json += "{\"address\": \"localhost\"},\n"
+                "{\"address\": \"127.0.0.1\", \"version\": \"v4\"}]";
+
+        QStringList errors;
+        const auto configs = QtSnmpAgentConfig::fromJson( json, &errors );
+        QCOMPARE( configs.size(), AgentCount );
+        QCOMPARE( errors.size(), 2 );
+        QVERIFY( errors.at( 0 ).startsWith( QString( "#%1:" ).arg( AgentCount ) ) );
+        QCOMPARE( configs.first().protocol_version, static_cast< int >( QtSnmpClient::SNMPv2c ) );
+
+        QObject parent;
+        const auto clients = QtSnmpClient::createClients( configs, &parent );
+        QCOMPARE( clients.size(), AgentCount );
+        for ( auto client : clients ) {
+            QCOMPARE( client->responseTimeout(), 500 );
+            connectClient( client );
+            client->requestValue( ".1.3.6.1.2.1.1.3.0" );
+        }
+        QTRY_COMPARE( m_response_count, AgentCount );
+        QCOMPARE( m_fail_count, 0 );
+    }
+
+    void testFanOut() {
+        QtSnmpAgentConfigList configs;
+        for ( int i = 0; i < AgentCount; ++i ) {
+            QtSnmpAgentConfig config;
+            config.address = QHostAddress::LocalHost;
+            config.port = m_simulator.agentPort( i );
+            config.response_timeout = 100;
+            configs << config;
+        }
+        // NOTE: an agent which never responds
+        configs[ 3 ].port = static_cast< quint16 >( TestPort - 1 );
+
+        QtSnmpFanOut fan_out;
+        QCOMPARE( fan_out.setAgents( configs ), AgentCount );
+        fan_out.setConcurrency( 3 );
+        fan_out.setBatchSize( 2 );
+
+        QVector< int > replies( AgentCount, 0 );
+        int batch_count = 0;
+        int last_finished = 0;
+        int succeeded = -1;
+        int failed = -1;
+        const bool is_started = fan_out.requestValues( QStringList( ".1.3.6.1.2.1.1.3.0" ),
+            [&]( const QtSnmpFanOut::ReplyList& batch, const int finished_count, const int agent_count ) {
+                QVERIFY( batch.size() <= 2 );
+                QCOMPARE( agent_count, AgentCount );
+                ++batch_count;
+                for ( const auto& reply : batch ) {
+                    ++replies[ reply.agent ];
+                    QCOMPARE( reply.result.is_ok, 3 != reply.agent );
+                }
+                last_finished = finished_count;
+            },
+            [&]( const int succeeded_count, const int failed_count ) {
+                succeeded = succeeded_count;
+                failed = failed_count;
+            } );
+        QVERIFY( is_started );
+        QVERIFY( fan_out.isRunning() );
+        QVERIFY( ! fan_out.requestValues( QStringList( ".1.3.6.1.2.1.1.3.0" ),
+                                          []( const QtSnmpFanOut::ReplyList&, int, int ) {} ) );
+        QTRY_COMPARE_WITH_TIMEOUT( succeeded, AgentCount - 1, 5000 );
+        QCOMPARE( failed, 1 );
+        QCOMPARE( last_finished, AgentCount );
+        QVERIFY( batch_count >= AgentCount / 2 );
+        QCOMPARE( replies, QVector< int >( AgentCount, 1 ) );
+        QVERIFY( ! fan_out.isRunning() );
+    }
+};
+
+QTEST_MAIN( TestQtSnmpAgents )
+#include "tsta_qtsnmpclient_agents.moc"
@@ -0,0 +1,103 @@
+#include <QTest>
+#include <QDebug>
+#include <QtSnmpData.h>
+#include "BerArena.h"
+
+using namespace qtsnmpclient;
+
+namespace {
+    QByteArray makeResponse( const int request_id,
+                             const int value_count )
+    {
+        auto var_bind_list = QtSnmpData::sequence();
+        for ( int i = 0; i < value_count; ++i ) {
+            auto var_bind = QtSnmpData::sequence();
+            var_bind.addChild( QtSnmpData::oid( ".1.3.6.1.2.1.2.2.1.10." + QByteArray::number( 1000 + i ) ) );
+            var_bind.addChild( QtSnmpData::string( "value #" + QByteArray::number( i ) ) );
+            var_bind_list.addChild( var_bind );
+        }
+
+        auto pdu = QtSnmpData( QtSnmpData::GET_RESPONSE_TYPE );
+        pdu.addChild( QtSnmpData::integer( request_id ) );
+        pdu.addChild( QtSnmpData::integer( 0 ) );
+        pdu.addChild( QtSnmpData::integer( 0 ) );
+        pdu.addChild( var_bind_list );
+
+        auto message = QtSnmpData::sequence();
+        message.addChild( QtSnmpData::integer( 1 ) );
+        message.addChild( QtSnmpData::string( "public" ) );
+        message.addChild( pdu );
+        return message.makeSnmpChunk();
+    }
+}
+
+class TestBerArena : public QObject {
+    Q_OBJECT
+private slots:
+    void testResponse() {
+        const int value_count = 60;
+        const auto datagram = makeResponse( -123456, value_count );
+
+        BerArena arena;
+        QVERIFY( arena.parse( datagram ) );
+        const int message = arena.first();
+        QVERIFY( message >= 0 );
+        QVERIFY( arena.next( message ) < 0 );
+        QCOMPARE( arena.type( message ), static_cast< int >( QtSnmpData::SEQUENCE_TYPE ) );
+        QCOMPARE( arena.childCount( message ), 3 );
+
+        const int pdu = arena.child( message, 2 );
+        QCOMPARE( arena.type( pdu ), static_cast< int >( QtSnmpData::GET_RESPONSE_TYPE ) );
+        QCOMPARE( arena.integerValue( arena.firstChild( pdu ) ), qint64( -123456 ) );
+        const int var_bind_list = arena.child( pdu, 3 );
+        QCOMPARE( arena.childCount( var_bind_list ), value_count );
+
+        // NOTE: the copies have to be the same as the ones of QtSnmpData
+        QtSnmpDataList expected;
+        QtSnmpData::parseData( datagram, &expected );
+        const auto& expected_list = expected.at( 0 ).children().at( 2 ).children().at( 3 ).children();
+        int index = 0;
+        for ( int var_bind = arena.firstChild( var_bind_list ); var_bind >= 0; var_bind = arena.next( var_bind ) ) {
+            const auto& expected_var_bind = expected_list.at( static_cast< size_t >( index++ ) ).children();
+            QCOMPARE( arena.toData( arena.firstChild( var_bind ) ).data(), expected_var_bind.at( 0 ).data() );
+            QCOMPARE( arena.toData( arena.child( var_bind, 1 ) ), expected_var_bind.at( 1 ) );
+        }
+        QCOMPARE( index, value_count );
+    }
+
+    void testCopiesOutliveDatagram() {
+        BerArena arena;
+        QtSnmpData value;
+        {
+            const auto datagram = makeResponse( 1, 1 );
+            QVERIFY( arena.parse( datagram ) );
+            const int var_bind = arena.firstChild( arena.child( arena.child( arena.first(), 2 ), 3 ) );
+            value = arena.toData( arena.child( var_bind, 1 ) );
+        }
+        QVERIFY( arena.parse( makeResponse( 2, 2 ) ) );
+        QCOMPARE( value.data(), QByteArray( "value #0" ) );
+    }
+
+    void testMalformedData() {
+        const auto datagram = makeResponse( 1, 3 );
+        BerArena arena;
+        for ( int size = 1; size < datagram.size(); ++size ) {
+            QVERIFY( ! arena.parse( datagram.left( size ) ) );
+            QVERIFY( arena.first() < 0 );
+        }
+        QVERIFY( ! arena.parse( QByteArray::fromHex( "3084ffffffff" ) ) );
+        QVERIFY( ! arena.parse( QByteArray::fromHex( "3080" ) ) );
+        QVERIFY( ! arena.parse( QByteArray() ) );
+
+        // NOTE: deeply nested containers are rejected instead of a stack overflow
+        QByteArray nested = QByteArray::fromHex( "0500" );
+        for ( int i = 0; i < 40; ++i ) {
+            nested.prepend( static_cast< char >( nested.size() ) );
+            nested.prepend( '\x30' );
+        }
+        QVERIFY( ! arena.parse( nested ) );
+    }
+};
+
+QTEST_MAIN( TestBerArena )
+#include "tsta_qtsnmpclient_arena.moc"
@@ -0,0 +1,104 @@
+#include <QTest>
+#include <QtSnmpClient.h>
+#include <QtSnmpAwait.h>
+#include <Simulator.h>
+
+using namespace qtsnmpsimulator;
+
+namespace {
+    const quint16 TestPort = 65030;
+
+    const QByteArray walk =
+        ".1.3.6.1.2.1.1.3.0 = Timeticks: (123456) 0:20:34.56\n"
+        ".1.3.6.1.2.1.2.1.0 = INTEGER: 2\n"
+        ".1.3.6.1.2.1.2.2.1.2.1 = STRING: \"lo\"\n"
+        ".1.3.6.1.2.1.2.2.1.2.2 = STRING: \"eth0\"\n"
+        ".1.3.6.1.2.1.2.2.1.10.1 = Counter32: 100\n"
+        ".1.3.6.1.2.1.2.2.1.10.2 = Counter32: 200\n";
+
+#if defined( __cpp_impl_coroutine )
+    struct Collected {
+        int if_number = 0;
+        int walk_size = 0;
+        int table_rows = 0;
+        bool is_failed = false;
+        bool is_finished = false;
+    };
+
+    QtSnmpTask collect( QtSnmpClient*const client,
+                        Collected*const collected )
+    {
+        const auto if_number = co_await QtSnmpOperation::requestValue( client, ".1.3.6.1.2.1.2.1.0" );
+        if ( ! if_number.is_ok ) {
+            collected->is_failed = true;
+            collected->is_finished = true;
+            co_return;
+        }
+        collected->if_number = if_number.values->at( 0 ).intValue();
+
+        const auto results = co_await whenAll(
+                    QtSnmpOperation::requestSubValues( client, ".1.3.6.1.2.1.2.2.1.2" ),
+                    QtSnmpOperation::requestTable( client, ".1.3.6.1.2.1.2.2.1" ) );
+        collected->is_failed = ! results.at( 0 ).is_ok || ! results.at( 1 ).is_ok;
+        if ( ! collected->is_failed ) {
+            collected->walk_size = static_cast< int >( results.at( 0 ).values->size() );
+            collected->table_rows = results.at( 1 ).table->rowCount();
+        }
+        collected->is_finished = true;
+    }
+#endif
+}
+
+class TestQtSnmpAwait : public QObject {
+    Q_OBJECT
+    Simulator m_simulator;
+
+private slots:
+    void initTestCase() {
+        Mib mib;
+        mib.loadWalk( walk );
+        m_simulator.setMib( mib );
+        QString error;
+        QVERIFY2( m_simulator.start( QHostAddress::LocalHost, TestPort, 1, &error ),
+                  qPrintable( error ) );
+    }
+
+    void testDependentQueries() {
+#if defined( __cpp_impl_coroutine )
+        QtSnmpClient client;
+        client.setAgentAddress( QHostAddress::LocalHost );
+        client.setAgentPort( TestPort );
+        client.setReponseTimeout( 100 );
+
+        Collected collected;
+        collect( &client, &collected );
+        QVERIFY( ! collected.is_finished );
+        QTRY_VERIFY( collected.is_finished );
+        QVERIFY( ! collected.is_failed );
+        QCOMPARE( collected.if_number, 2 );
+        QCOMPARE( collected.walk_size, 2 );
+        QCOMPARE( collected.table_rows, 2 );
+#else
+        QSKIP( "The compiler does not support coroutines" );
+#endif
+    }
+
+    void testFailure() {
+#if defined( __cpp_impl_coroutine )
+        QtSnmpClient client;
+        client.setAgentAddress( QHostAddress::LocalHost );
+        client.setAgentPort( TestPort + 1 );
+        client.setReponseTimeout( 50 );
+
+        Collected collected;
+        collect( &client, &collected );
+        QTRY_VERIFY_WITH_TIMEOUT( collected.is_finished, 5000 );
+        QVERIFY( collected.is_failed );
+#else
+        QSKIP( "The compiler does not support coroutines" );
+#endif
+    }
+};
+
+QTEST_MAIN( TestQtSnmpAwait )
+#include "tsta_qtsnmpclient_await.moc"
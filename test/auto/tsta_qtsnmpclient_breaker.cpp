@@ -0,0 +1,120 @@
+#include <QTest>
+#include <QDebug>
+#include <QtSnmpClient.h>
+#include <QtSnmpMetrics.h>
+#include <Simulator.h>
+
+using namespace qtsnmpsimulator;
+
+namespace {
+    const quint16 TestPort = 65070;
+
+    const QByteArray walk =
+        ".1.3.6.1.2.1.1.1.0 = STRING: \"Simulated agent\"\n"
+        ".1.3.6.1.2.1.1.3.0 = Timeticks: (123456) 0:20:34.56\n";
+}
+
+class TestQtSnmpCircuitBreaker : public QObject {
+    Q_OBJECT
+    Simulator m_simulator;
+    QScopedPointer< QtSnmpClient > m_client;
+    int m_response_count = 0;
+    int m_fail_count = 0;
+
+    void connectClient( QtSnmpClient*const client ) {
+        connect( client, &QtSnmpClient::responseReceived,
+                 [this]( const qint32, const QtSnmpDataList& ) { ++m_response_count; } );
+        connect( client, &QtSnmpClient::requestFailed,
+                 [this]( const qint32 ) { ++m_fail_count; } );
+    }
+
+private slots:
+    void initTestCase() {
+        Mib mib;
+        mib.loadWalk( walk );
+        m_simulator.setMib( mib );
+        QString error;
+        QVERIFY2( m_simulator.start( QHostAddress::LocalHost, TestPort, 1, &error ),
+                  qPrintable( error ) );
+    }
+
+    void init() {
+        m_simulator.setConfig( AgentConfig() );
+        m_simulator.setSeed( 1 );
+        m_response_count = 0;
+        m_fail_count = 0;
+
+        m_client.reset( new QtSnmpClient );
+        m_client->setAgentAddress( QHostAddress::LocalHost );
+        m_client->setAgentPort( TestPort );
+        m_client->setReponseTimeout( 100 );
+        connectClient( m_client.data() );
+    }
+
+    void testCircuitBreaker() {
+        AgentConfig config;
+        config.loss_rate = 1;
+        m_simulator.setConfig( config );
+        m_client->setReponseTimeout( 20 );
+        m_client->setCircuitBreaker( 2, 1000 );
+        QVERIFY( m_client->isAgentAvailable() );
+
+        m_client->requestValue( ".1.3.6.1.2.1.1.1.0" );
+        m_client->requestValue( ".1.3.6.1.2.1.1.1.0" );
+        QTRY_COMPARE( m_fail_count, 2 );
+        QVERIFY( ! m_client->isAgentAvailable() );
+
+        // the requests to the agent which is down fail at once
+        const auto before = m_simulator.statistics();
+        for ( int i = 0; i < 5; ++i ) {
+            m_client->requestValue( ".1.3.6.1.2.1.1.1.0" );
+        }
+        QCOMPARE( m_fail_count, 2 );
+        QTRY_COMPARE( m_fail_count, 7 );
+        QCOMPARE( m_client->metrics().rejects, quint64( 5 ) );
+        QCOMPARE( m_simulator.statistics().requests, before.requests );
+
+        // the agent is available again after a probe
+        m_simulator.setConfig( AgentConfig() );
+        QTRY_VERIFY( m_client->isAgentAvailable() );
+        QCOMPARE( m_simulator.statistics().requests - before.requests, quint64( 1 ) );
+        QCOMPARE( m_client->metrics().rejects, quint64( 5 ) );
+        m_client->requestValue( ".1.3.6.1.2.1.1.1.0" );
+        QTRY_COMPARE( m_response_count, 1 );
+        QCOMPARE( m_fail_count, 7 );
+    }
+
+    void testEarlyProbe() {
+        // NOTE: the probe timer counts whole milliseconds of another clock
+        //       than the breaker, so with the interval of 1 ms it often
+        //       expires before the probe time and has to be scheduled again
+        AgentConfig config;
+        config.loss_rate = 1;
+        m_client->setReponseTimeout( 20 );
+        m_client->setCircuitBreaker( 1, 1 );
+        QObject context;
+        const int cycle_count = 10;
+        int open_count = 0;
+        for ( int i = 0; i < cycle_count; ++i ) {
+            m_simulator.setConfig( config );
+            const auto before = m_simulator.statistics();
+            bool is_failed = false;
+            m_client->requestValue( ".1.3.6.1.2.1.1.1.0", &context, [&]( const QtSnmpResult& result ) {
+                is_failed = ! result.is_ok;
+                if ( ! m_client->isAgentAvailable() ) {
+                    ++open_count;
+                }
+                // NOTE: the agent responds to the probe
+                m_simulator.setConfig( AgentConfig() );
+            } );
+            QTRY_VERIFY_WITH_TIMEOUT( is_failed, 5000 );
+            QTRY_VERIFY( m_client->isAgentAvailable() );
+            QCOMPARE( m_simulator.statistics().requests - before.requests, quint64( 7 ) );
+        }
+        QCOMPARE( open_count, cycle_count );
+        QCOMPARE( m_client->metrics().rejects, quint64( 0 ) );
+    }
+};
+
+QTEST_MAIN( TestQtSnmpCircuitBreaker )
+#include "tsta_qtsnmpclient_breaker.moc"
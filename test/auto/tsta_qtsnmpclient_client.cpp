@@ -1,5 +1,6 @@
 #include <QTest>
 #include <QDebug>
+#include <QLoggingCategory>
 #include <QtSnmpClient.h>
 #include <QUdpSocket>
 #include <QUuid>
@@ -314,6 +315,9 @@ private slots:
                                                  m_client->community(),
                                                  oid,
                                                  &internal_request_id ) );
+            // NOTE: the request id always takes 4 bytes
+            QVERIFY( 4 == internal_request_id.data().size() );
+            QVERIFY( internal_request_id.intValue() >= 0x800000 );
 
             // make response
             auto response_value = QtSnmpData::string( QUuid::createUuid().toByteArray() );
@@ -600,9 +604,147 @@ private slots:
         QCOMPARE( m_fail_count, 1 );
         QCOMPARE( m_failed_request_id, req_id );
 
+        const auto metrics = m_client->metrics();
+        QVERIFY( metrics.pdus_sent == 6 );
+        QVERIFY( metrics.retransmits == 5 );
+        QVERIFY( metrics.timeouts == 1 );
+        QVERIFY( metrics.pdus_received == 0 );
+        QVERIFY( metrics.rtt.count == 0 );
+        QVERIFY( metrics.job_latency.count == 1 );
+
         cleanResponseData();
     }
 
+    void testMetrics() {
+        const auto global_before = QtSnmpClient::globalMetrics();
+        const auto oid = generateOID();
+        m_client->requestValue( oid );
+        QTest::qWait( default_delay_ms.count() );
+        QVERIFY( m_received_request_data_list.size() == 1 );
+        QtSnmpData internal_request_id;
+        QVERIFY( checkSingleVariableRequest( *m_received_request_data_list.rbegin(),
+                                             QtSnmpData::GET_REQUEST_TYPE,
+                                             m_client->community(),
+                                             oid,
+                                             &internal_request_id ) );
+
+        auto response_value = QtSnmpData::integer( 42 );
+        response_value.setAddress( oid );
+        const auto response = makeResponse( internal_request_id.intValue(),
+                                            m_client->community(),
+                                            { response_value } );
+        const auto chunk = response.makeSnmpChunk();
+        m_socket->writeDatagram( chunk, m_client_address, m_client_port );
+        QTest::qWait( default_delay_ms.count() );
+        QCOMPARE( m_response_count, 1 );
+
+        // a late duplicate has to be counted and ignored
+        m_socket->writeDatagram( chunk, m_client_address, m_client_port );
+        QTest::qWait( default_delay_ms.count() );
+        QCOMPARE( m_response_count, 1 );
+
+        const auto metrics = m_client->metrics();
+        QVERIFY( metrics.pdus_sent == 1 );
+        QVERIFY( metrics.pdus_received == 2 );
+        QVERIFY( metrics.unexpected_request_ids == 0 );
+        QVERIFY( metrics.duplicates == 1 );
+        QVERIFY( metrics.retransmits == 0 );
+        QVERIFY( metrics.bytes_received >= static_cast< quint64 >( chunk.size() ) );
+        QVERIFY( metrics.rtt.count == 1 );
+        QVERIFY( metrics.job_latency.count == 1 );
+        QVERIFY( metrics.job_latency.max >= metrics.rtt.max );
+
+        const auto global_after = QtSnmpClient::globalMetrics();
+        QVERIFY( global_after.pdus_sent >= global_before.pdus_sent + 1 );
+        QVERIFY( global_after.rtt.count >= global_before.rtt.count + 1 );
+
+        // the counters of a destroyed client are kept by the global metrics
+        QScopedPointer< QtSnmpClient > client( new QtSnmpClient );
+        client->setAgentAddress( QHostAddress::LocalHost );
+        client->setAgentPort( TestPort + 99 );
+        client->requestValue( oid );
+        QTRY_VERIFY( client->metrics().pdus_sent == 1 );
+        const auto global_with_client = QtSnmpClient::globalMetrics();
+        QVERIFY( global_with_client.pdus_sent >= global_after.pdus_sent + 1 );
+        client.reset();
+        QVERIFY( QtSnmpClient::globalMetrics().pdus_sent >= global_with_client.pdus_sent );
+
+        const auto map = metrics.toVariantMap();
+        QCOMPARE( map.value( "pdus_sent" ).toULongLong(), Q_UINT64_C( 1 ) );
+        QCOMPARE( map.value( "rtt" ).toMap().value( "buckets" ).toList().size(),
+                  static_cast< int >( QtSnmpHistogram::BUCKET_COUNT ) );
+    }
+
+    void testLogThrottling() {
+        QLoggingCategory::setFilterRules( "qtsnmpclient.session.debug=true" );
+        const auto oid = generateOID();
+        m_client->requestValue( oid );
+        QTest::qWait( default_delay_ms.count() );
+        QVERIFY( m_received_request_data_list.size() == 1 );
+        QtSnmpData internal_request_id;
+        QVERIFY( checkSingleVariableRequest( *m_received_request_data_list.rbegin(),
+                                             QtSnmpData::GET_REQUEST_TYPE,
+                                             m_client->community(),
+                                             oid,
+                                             &internal_request_id ) );
+
+        auto response_value = QtSnmpData::integer( 42 );
+        response_value.setAddress( oid );
+        const auto chunk = makeResponse( internal_request_id.intValue(),
+                                         m_client->community(),
+                                         { response_value } ).makeSnmpChunk();
+        m_socket->writeDatagram( chunk, m_client_address, m_client_port );
+
+        // NOTE: the client never uses these request ids
+        const int stale_count = 20;
+        for ( int i = 0; i < stale_count; ++i ) {
+            const auto stale = makeResponse( 0x10000 + i,
+                                             m_client->community(),
+                                             { response_value } );
+            m_socket->writeDatagram( stale.makeSnmpChunk(), m_client_address, m_client_port );
+        }
+        QTest::qWait( default_delay_ms.count() );
+        QLoggingCategory::setFilterRules( QString() );
+
+        // NOTE: only the first five messages of the same kind are reported per second
+        const auto metrics = m_client->metrics();
+        QCOMPARE( m_response_count, 1 );
+        QVERIFY( metrics.unexpected_request_ids == stale_count );
+        QVERIFY( metrics.suppressed_messages == stale_count - 5 );
+    }
+
+    void testLateResponseToRetransmittedRequest() {
+        m_client->setReponseTimeout( 200 );
+        const auto oid = generateOID();
+        const auto req_id = m_client->requestValue( oid );
+        QTRY_COMPARE( m_request_count, 2 );
+        QtSnmpData first_request_id;
+        QVERIFY( checkSingleVariableRequest( m_received_request_data_list.at( 0 ),
+                                             QtSnmpData::GET_REQUEST_TYPE,
+                                             m_client->community(),
+                                             oid,
+                                             &first_request_id ) );
+
+        // the response to the first attempt is accepted and only once
+        auto response_value = QtSnmpData::integer( 7 );
+        response_value.setAddress( oid );
+        const auto chunk = makeResponse( first_request_id.intValue(),
+                                         m_client->community(),
+                                         { response_value } ).makeSnmpChunk();
+        m_socket->writeDatagram( chunk, m_client_address, m_client_port );
+        m_socket->writeDatagram( chunk, m_client_address, m_client_port );
+        QTest::qWait( default_delay_ms.count() );
+        QCOMPARE( m_response_count, 1 );
+        QCOMPARE( m_received_request_id, req_id );
+        QCOMPARE( m_fail_count, 0 );
+        QCOMPARE( m_client->isBusy(), false );
+
+        const auto metrics = m_client->metrics();
+        QVERIFY( metrics.duplicates == 1 );
+        QVERIFY( metrics.unexpected_request_ids == 0 );
+        QVERIFY( metrics.rtt.count == 0 );
+    }
+
     void testErrorResponses() {
         // Check that client do not resend request after a valid error response
 
@@ -0,0 +1,90 @@
+#include <QTest>
+#include <QDebug>
+#include <QtSnmpClient.h>
+#include <QtSnmpMetrics.h>
+#include <Simulator.h>
+#include <QElapsedTimer>
+
+using namespace qtsnmpsimulator;
+
+namespace {
+    const quint16 TestPort = 65060;
+    const int AgentCount = 2;
+
+    const QByteArray walk =
+        ".1.3.6.1.2.1.1.1.0 = STRING: \"Simulated agent\"\n";
+}
+
+class TestQtSnmpPacing : public QObject {
+    Q_OBJECT
+    Simulator m_simulator;
+    QScopedPointer< QtSnmpClient > m_client;
+    int m_response_count = 0;
+    int m_fail_count = 0;
+
+    void connectClient( QtSnmpClient*const client ) {
+        connect( client, &QtSnmpClient::responseReceived,
+                 [this]( const qint32, const QtSnmpDataList& ) { ++m_response_count; } );
+        connect( client, &QtSnmpClient::requestFailed,
+                 [this]( const qint32 ) { ++m_fail_count; } );
+    }
+
+private slots:
+    void initTestCase() {
+        Mib mib;
+        mib.loadWalk( walk );
+        m_simulator.setMib( mib );
+        QString error;
+        QVERIFY2( m_simulator.start( QHostAddress::LocalHost, TestPort, AgentCount, &error ),
+                  qPrintable( error ) );
+    }
+
+    void init() {
+        m_simulator.setConfig( AgentConfig() );
+        m_simulator.setSeed( 1 );
+        m_response_count = 0;
+        m_fail_count = 0;
+
+        m_client.reset( new QtSnmpClient );
+        m_client->setAgentAddress( QHostAddress::LocalHost );
+        m_client->setAgentPort( TestPort );
+        m_client->setReponseTimeout( 100 );
+        connectClient( m_client.data() );
+    }
+
+    void testRateLimit() {
+        m_client->setRateLimit( 20 );
+        QCOMPARE( m_client->rateLimit(), 20.0 );
+        QElapsedTimer timer;
+        timer.start();
+        const int request_count = 6;
+        for ( int i = 0; i < request_count; ++i ) {
+            m_client->requestValue( ".1.3.6.1.2.1.1.1.0" );
+        }
+        QTRY_COMPARE_WITH_TIMEOUT( m_response_count, request_count, 5000 );
+        QVERIFY( timer.elapsed() >= ( request_count - 1 ) * 50 - 10 );
+        QVERIFY( m_client->metrics().paced_pdus >= request_count - 2 );
+    }
+
+    void testGlobalRateLimit() {
+        QtSnmpClient::setGlobalRateLimit( 20, 2 );
+        QtSnmpClient other_client;
+        other_client.setAgentAddress( QHostAddress::LocalHost );
+        other_client.setAgentPort( m_simulator.agentPort( 1 ) );
+        connectClient( &other_client );
+
+        QElapsedTimer timer;
+        timer.start();
+        const int request_count = 3;
+        for ( int i = 0; i < request_count; ++i ) {
+            m_client->requestValue( ".1.3.6.1.2.1.1.1.0" );
+            other_client.requestValue( ".1.3.6.1.2.1.1.1.0" );
+        }
+        QTRY_COMPARE_WITH_TIMEOUT( m_response_count, 2 * request_count, 5000 );
+        QtSnmpClient::setGlobalRateLimit( 0 );
+        QVERIFY( timer.elapsed() >= ( 2 * request_count - 2 ) * 50 - 10 );
+    }
+};
+
+QTEST_MAIN( TestQtSnmpPacing )
+#include "tsta_qtsnmpclient_pacing.moc"
@@ -0,0 +1,216 @@
+#include <QTest>
+#include <QDebug>
+#include <QSet>
+#include <QtSnmpClient.h>
+#include <QtSnmpMetrics.h>
+#include <QtSnmpPollScheduler.h>
+#include <Simulator.h>
+
+using namespace qtsnmpsimulator;
+
+namespace {
+    const quint16 TestPort = 65080;
+    const int AgentCount = 8;
+
+    const QByteArray walk =
+        ".1.3.6.1.2.1.1.1.0 = STRING: \"Simulated agent\"\n"
+        ".1.3.6.1.2.1.2.1.0 = INTEGER: 3\n"
+        ".1.3.6.1.2.1.2.2.1.2.1 = STRING: \"lo\"\n"
+        ".1.3.6.1.2.1.2.2.1.2.2 = STRING: \"eth0\"\n"
+        ".1.3.6.1.2.1.2.2.1.2.10 = STRING: \"eth1\"\n";
+}
+
+class TestQtSnmpPollScheduler : public QObject {
+    Q_OBJECT
+    Simulator m_simulator;
+    QScopedPointer< QtSnmpClient > m_client;
+    int m_response_count = 0;
+    int m_fail_count = 0;
+
+    void connectClient( QtSnmpClient*const client ) {
+        connect( client, &QtSnmpClient::responseReceived,
+                 [this]( const qint32, const QtSnmpDataList& ) { ++m_response_count; } );
+        connect( client, &QtSnmpClient::requestFailed,
+                 [this]( const qint32 ) { ++m_fail_count; } );
+    }
+
+private slots:
+    void initTestCase() {
+        QString error;
+        QVERIFY2( m_simulator.start( QHostAddress::LocalHost, TestPort, AgentCount, &error ),
+                  qPrintable( error ) );
+    }
+
+    void init() {
+        // NOTE: the MIB changed by the SET requests of a test is not shared
+        //       with the next one
+        Mib mib;
+        mib.loadWalk( walk );
+        m_simulator.setMib( mib );
+        m_simulator.setConfig( AgentConfig() );
+        m_simulator.setSeed( 1 );
+        m_response_count = 0;
+        m_fail_count = 0;
+
+        m_client.reset( new QtSnmpClient );
+        m_client->setAgentAddress( QHostAddress::LocalHost );
+        m_client->setAgentPort( TestPort );
+        m_client->setReponseTimeout( 100 );
+        connectClient( m_client.data() );
+    }
+
+    void testPollScheduler() {
+        std::vector< std::unique_ptr< QtSnmpClient > > clients;
+        QtSnmpPollScheduler scheduler;
+        QHash< int, int > result_counts;
+        QSet< int > walk_polls;
+        int fail_count = 0;
+        connect( &scheduler, &QtSnmpPollScheduler::pollResultReady,
+                 [&result_counts, &walk_polls]( const int poll_id, const QtSnmpDataListPtr& values ) {
+                     QVERIFY( ( walk_polls.contains( poll_id ) ? 3u : 1u ) == values->size() );
+                     ++result_counts[ poll_id ];
+                 } );
+        connect( &scheduler, &QtSnmpPollScheduler::pollFailed,
+                 [&fail_count]( const int ) { ++fail_count; } );
+
+        for ( int i = 0; i < AgentCount; ++i ) {
+            clients.emplace_back( new QtSnmpClient );
+            auto& client = *clients.back();
+            client.setAgentAddress( QHostAddress::LocalHost );
+            client.setAgentPort( m_simulator.agentPort( i ) );
+            scheduler.addPoll( &client, { ".1.3.6.1.2.1.1.1.0" }, 100 );
+            walk_polls.insert( scheduler.addPoll( &client, { ".1.3.6.1.2.1.2.2.1.2" }, 200, QtSnmpPollScheduler::WalkPoll ) );
+        }
+        QCOMPARE( scheduler.pollCount(), 2 * AgentCount );
+
+        QTest::qWait( 1000 );
+        QCOMPARE( fail_count, 0 );
+        QCOMPARE( scheduler.overrunCount(), quint64( 0 ) );
+        QCOMPARE( result_counts.size(), 2 * AgentCount );
+        for ( auto iter = result_counts.cbegin(); iter != result_counts.cend(); ++iter ) {
+            QVERIFY( iter.value() >= 3 );
+        }
+
+        // the cycles of the deleted clients are not started anymore
+        clients.clear();
+        QCOMPARE( scheduler.pollCount(), 0 );
+    }
+
+    void testWalkPollCycle() {
+        QtSnmpPollScheduler scheduler;
+        scheduler.setJitter( 0 );
+        QList< QtSnmpDataListPtr > results;
+        int fail_count = 0;
+        connect( &scheduler, &QtSnmpPollScheduler::pollResultReady,
+                 [&results]( const int, const QtSnmpDataListPtr& values ) { results << values; } );
+        connect( &scheduler, &QtSnmpPollScheduler::pollFailed,
+                 [&fail_count]( const int ) { ++fail_count; } );
+
+        // one result per cycle with the values of all the OIDs in their order
+        scheduler.addPoll( m_client.data(), { ".1.3.6.1.2.1.2.2.1.2", ".1.3.6.1.2.1.1.1" },
+                           100, QtSnmpPollScheduler::WalkPoll );
+        QTRY_VERIFY( results.size() >= 2 );
+        QVERIFY( 4 == results.at( 0 )->size() );
+        QCOMPARE( results.at( 0 )->at( 2 ).data(), QByteArray( "eth1" ) );
+        QCOMPARE( results.at( 0 )->at( 3 ).data(), QByteArray( "Simulated agent" ) );
+        QVERIFY( *results.at( 0 ) == *results.at( 1 ) );
+        QCOMPARE( fail_count, 0 );
+
+        // a failed walk fails its cycle once, the other walk is not reported
+        m_client->setWalkLimits( 2, 0 );
+        const int result_count = results.size();
+        QTRY_VERIFY( fail_count >= 2 );
+        QVERIFY( results.size() <= result_count + 1 );
+
+        // the requests of the scheduler emit no signals of the client
+        QCOMPARE( m_response_count, 0 );
+        QCOMPARE( m_fail_count, 0 );
+    }
+
+    void testFullQueue() {
+        // NOTE: the walks over the queue of the client are dropped,
+        //       they fail the cycle instead of keeping it running for good
+        QtSnmpPollScheduler scheduler;
+        scheduler.setJitter( 0 );
+        int result_count = 0;
+        int fail_count = 0;
+        connect( &scheduler, &QtSnmpPollScheduler::pollResultReady,
+                 [&result_count]( const int, const QtSnmpDataListPtr& ) { ++result_count; } );
+        connect( &scheduler, &QtSnmpPollScheduler::pollFailed,
+                 [&fail_count]( const int ) { ++fail_count; } );
+
+        QStringList oid_list;
+        for ( int i = 0; i < 150; ++i ) {
+            oid_list << ".1.3.6.1.2.1.1.1";
+        }
+        scheduler.addPoll( m_client.data(), oid_list, 1000, QtSnmpPollScheduler::WalkPoll );
+        QTRY_COMPARE_WITH_TIMEOUT( fail_count, 2, 5000 );
+        QCOMPARE( result_count, 0 );
+        QCOMPARE( scheduler.overrunCount(), quint64( 0 ) );
+        QVERIFY( m_client->metrics().drops > 0 );
+        QCOMPARE( m_fail_count, 0 );
+    }
+
+    void testPollOverrun() {
+        AgentConfig config;
+        config.latency_ms = 250;
+        m_simulator.setConfig( config );
+        m_client->setReponseTimeout( 1000 );
+
+        QtSnmpPollScheduler scheduler;
+        scheduler.setJitter( 0 );
+        int overrun_count = 0;
+        connect( &scheduler, &QtSnmpPollScheduler::cycleOverrun,
+                 [&overrun_count]( const int ) { ++overrun_count; } );
+        const int poll_id = scheduler.addPoll( m_client.data(), { ".1.3.6.1.2.1.1.1.0" }, 100 );
+        QVERIFY( scheduler.hasPoll( poll_id ) );
+
+        QTRY_VERIFY( overrun_count >= 2 );
+        QCOMPARE( scheduler.overrunCount(), quint64( overrun_count ) );
+        scheduler.removePoll( poll_id );
+        QVERIFY( ! scheduler.hasPoll( poll_id ) );
+    }
+
+    void testTablePoll() {
+        QtSnmpPollScheduler scheduler;
+        scheduler.setJitter( 0 );
+        QList< QtSnmpDataListPtr > results;
+        QList< quint64 > request_counts;
+        int discovery_count = 0;
+        connect( &scheduler, &QtSnmpPollScheduler::pollResultReady,
+                 [this, &results, &request_counts]( const int, const QtSnmpDataListPtr& values ) {
+                     results << values;
+                     request_counts << m_simulator.statistics().requests;
+                 } );
+        connect( &scheduler, &QtSnmpPollScheduler::instancesDiscovered,
+                 [&discovery_count]( const int, const int ) { ++discovery_count; } );
+
+        const auto if_number = QString( ".1.3.6.1.2.1.2.1.0" );
+        const int poll_id = scheduler.addPoll( m_client.data(), { ".1.3.6.1.2.1.2.2.1.2" },
+                                               100, QtSnmpPollScheduler::TablePoll );
+        scheduler.setRediscovery( poll_id, if_number );
+        QTRY_VERIFY( results.size() >= 3 );
+        QCOMPARE( discovery_count, 1 );
+        QCOMPARE( scheduler.instanceCount( poll_id ), 3 );
+        QCOMPARE( m_fail_count, 0 );
+
+        // the walk and the GET requests return the same values,
+        // the value of the change OID is the last one
+        QVERIFY( 4 == results.at( 0 )->size() );
+        QVERIFY( *results.at( 0 ) == *results.at( 1 ) );
+        QCOMPARE( results.at( 1 )->back().address(), if_number.toLatin1() );
+        QCOMPARE( results.at( 1 )->at( 2 ).data(), QByteArray( "eth1" ) );
+
+        // a cycle after the discovery is one request
+        QCOMPARE( request_counts.at( 2 ) - request_counts.at( 1 ), quint64( 1 ) );
+
+        // a change of the change OID triggers the next walk
+        m_client->setValue( "public", if_number, QtSnmpData::INTEGER_TYPE, QByteArray( 1, '\x4' ) );
+        QTRY_COMPARE( discovery_count, 2 );
+        QCOMPARE( scheduler.instanceCount( poll_id ), 3 );
+        QCOMPARE( m_fail_count, 0 );
+    }
+};
+
+QTEST_MAIN( TestQtSnmpPollScheduler )
+#include "tsta_qtsnmpclient_poll.moc"
@@ -0,0 +1,103 @@
+#include <QTest>
+#include <QDebug>
+#include <QtSnmpClient.h>
+#include <QtSnmpPreparedRequest.h>
+#include <Simulator.h>
+
+using namespace qtsnmpsimulator;
+
+namespace {
+    const quint16 TestPort = 65050;
+
+    const QByteArray walk =
+        ".1.3.6.1.2.1.1.1.0 = STRING: \"Simulated agent\"\n"
+        ".1.3.6.1.2.1.1.3.0 = Timeticks: (123456) 0:20:34.56\n"
+        ".1.3.6.1.2.1.2.1.0 = INTEGER: 3\n";
+}
+
+class TestQtSnmpPreparedRequest : public QObject {
+    Q_OBJECT
+    Simulator m_simulator;
+    QScopedPointer< QtSnmpClient > m_client;
+    int m_response_count = 0;
+    int m_fail_count = 0;
+    QtSnmpDataList m_response_list;
+
+    void connectClient( QtSnmpClient*const client ) {
+        connect( client, &QtSnmpClient::responseReceived,
+                 [this]( const qint32, const QtSnmpDataList& list )
+        {
+            ++m_response_count;
+            m_response_list = list;
+        });
+        connect( client, &QtSnmpClient::requestFailed,
+                 [this]( const qint32 ) { ++m_fail_count; } );
+    }
+
+private slots:
+    void initTestCase() {
+        Mib mib;
+        mib.loadWalk( walk );
+        m_simulator.setMib( mib );
+        QString error;
+        QVERIFY2( m_simulator.start( QHostAddress::LocalHost, TestPort, 1, &error ),
+                  qPrintable( error ) );
+    }
+
+    void init() {
+        m_simulator.setConfig( AgentConfig() );
+        m_simulator.setSeed( 1 );
+        m_response_count = 0;
+        m_fail_count = 0;
+        m_response_list.clear();
+
+        m_client.reset( new QtSnmpClient );
+        m_client->setAgentAddress( QHostAddress::LocalHost );
+        m_client->setAgentPort( TestPort );
+        m_client->setReponseTimeout( 100 );
+        connectClient( m_client.data() );
+    }
+
+    void testPreparedRequest() {
+        const QStringList oid_list = { ".1.3.6.1.2.1.1.1.0",
+                                       ".1.3.6.1.2.1.1.3.0",
+                                       ".1.3.6.1.2.1.2.1.0" };
+        const QtSnmpPreparedRequest prepared( oid_list );
+        const auto chunks = prepared.encode( QtSnmpClient::SNMPv2c, "public", 2 );
+        QVERIFY( chunks );
+        QVERIFY( 2 == chunks->size() );
+        QCOMPARE( chunks->at( 0 ).oid_count, 2 );
+        QCOMPARE( chunks->at( 1 ).oid_count, 1 );
+        QVERIFY( chunks == QtSnmpPreparedRequest( prepared ).encode( QtSnmpClient::SNMPv2c, "public", 2 ) );
+        QVERIFY( chunks != prepared.encode( QtSnmpClient::SNMPv1, "public", 2 ) );
+        QVERIFY( ! prepared.encode( QtSnmpClient::SNMPv3, QByteArray(), 2 ) );
+
+        m_client->setGetRequestLimit( 2 );
+        m_client->requestValues( prepared );
+        QTRY_COMPARE( m_response_count, 1 );
+        QVERIFY( 3 == m_response_list.size() );
+        QCOMPARE( m_response_list.at( 0 ).data(), QByteArray( "Simulated agent" ) );
+        QCOMPARE( m_response_list.at( 2 ).address(), QByteArray( ".1.3.6.1.2.1.2.1.0" ) );
+        QCOMPARE( m_response_list.at( 2 ).intValue(), 3 );
+        const auto first_list = m_response_list;
+
+        // the next requests get new ids, so their responses are matched
+        m_client->requestValues( prepared );
+        m_client->requestValues( prepared );
+        QTRY_COMPARE( m_response_count, 3 );
+        QVERIFY( first_list == m_response_list );
+        QCOMPARE( m_fail_count, 0 );
+
+        // every retransmission is sent as well
+        AgentConfig config;
+        config.loss_rate = 1;
+        m_simulator.setConfig( config );
+        const auto before = m_simulator.statistics();
+        m_client->requestValues( prepared );
+        QTRY_COMPARE_WITH_TIMEOUT( m_fail_count, 1, 5000 );
+        QVERIFY( m_simulator.statistics().lost - before.lost == 6 );
+    }
+};
+
+QTEST_MAIN( TestQtSnmpPreparedRequest )
+#include "tsta_qtsnmpclient_prepared.moc"
@@ -0,0 +1,108 @@
+#include <QTest>
+#include <QDebug>
+#include <QtSnmpRateEngine.h>
+
+namespace {
+    const QString Agent = "127.0.0.1:161";
+    const QByteArray EntryOid = ".1.3.6.1.2.1.31.1.1.1";
+
+    QByteArray unsignedData( const quint64 value ) {
+        QByteArray data;
+        quint64 rest = value;
+        do {
+            data.prepend( static_cast< char >( rest & 0xFF ) );
+            rest >>= 8;
+        } while ( rest );
+        if ( data.at( 0 ) & 0x80 ) {
+            data.prepend( '\0' );
+        }
+        return data;
+    }
+
+    QtSnmpData makeCounter( const int type,
+                            const QByteArray& oid,
+                            const quint64 value )
+    {
+        QtSnmpData counter( type, unsignedData( value ) );
+        counter.setAddress( oid );
+        return counter;
+    }
+
+    QtSnmpTable makeTable( const std::vector< std::pair< QByteArray, quint64 > >& rows ) {
+        QtSnmpTable table( EntryOid );
+        for ( const auto& row : rows ) {
+            table.append( makeCounter( QtSnmpData::COUNTER64_TYPE,
+                                       EntryOid + ".6." + row.first,
+                                       row.second ) );
+        }
+        return table;
+    }
+}
+
+class TestQtSnmpRateEngine : public QObject {
+    Q_OBJECT
+private slots:
+    void testCounter32Wrap() {
+        const QByteArray oid = ".1.3.6.1.2.1.2.2.1.10.1";
+        QtSnmpRateEngine engine;
+        auto rates = engine.update( Agent, 1000, { makeCounter( QtSnmpData::COUNTER_TYPE, oid, 4294967000u ) } );
+        QVERIFY( 1 == rates.size() );
+        QCOMPARE( rates.at( 0 ).status, QtSnmpRateEngine::RATE_FIRST_SAMPLE );
+
+        rates = engine.update( Agent, 1500, { makeCounter( QtSnmpData::COUNTER_TYPE, oid, 704 ) } );
+        QCOMPARE( rates.at( 0 ).status, QtSnmpRateEngine::RATE_VALID );
+        QCOMPARE( rates.at( 0 ).delta, Q_UINT64_C( 1000 ) );
+        QCOMPARE( rates.at( 0 ).per_second, 200.0 );
+
+        rates = engine.update( Agent, 1500, { QtSnmpData::string( "text" ) } );
+        QCOMPARE( rates.at( 0 ).status, QtSnmpRateEngine::RATE_NOT_COUNTER );
+        QCOMPARE( engine.sampleCount(), 1 );
+    }
+
+    void testRestart() {
+        const QByteArray oid = ".1.3.6.1.2.1.31.1.1.1.6.1";
+        QtSnmpRateEngine engine;
+        engine.update( Agent, 100000, { makeCounter( QtSnmpData::COUNTER64_TYPE, oid, 5000 ) } );
+
+        // sysUpTime goes back
+        auto rates = engine.update( Agent, 200, { makeCounter( QtSnmpData::COUNTER64_TYPE, oid, 9000 ) } );
+        QCOMPARE( rates.at( 0 ).status, QtSnmpRateEngine::RATE_DISCONTINUITY );
+
+        rates = engine.update( Agent, 300, { makeCounter( QtSnmpData::COUNTER64_TYPE, oid, 9500 ) } );
+        QCOMPARE( rates.at( 0 ).status, QtSnmpRateEngine::RATE_VALID );
+        QCOMPARE( rates.at( 0 ).per_second, 500.0 );
+
+        // a Counter64 does not wrap, so it was reset
+        rates = engine.update( Agent, 400, { makeCounter( QtSnmpData::COUNTER64_TYPE, oid, 10 ) } );
+        QCOMPARE( rates.at( 0 ).status, QtSnmpRateEngine::RATE_DISCONTINUITY );
+
+        engine.removeAgent( Agent );
+        QCOMPARE( engine.agentCount(), 0 );
+    }
+
+    void testColumn() {
+        QtSnmpRateEngine engine;
+        auto table = makeTable( { { "1", 100 }, { "2", 1000 } } );
+        auto rates = engine.update( Agent, 1000, table, 0 );
+        QVERIFY( 2 == rates.status.size() );
+        QCOMPARE( rates.status.at( 1 ), static_cast< quint8 >( QtSnmpRateEngine::RATE_FIRST_SAMPLE ) );
+
+        table = makeTable( { { "1", 300 }, { "2", 1100 } } );
+        rates = engine.update( Agent, 1200, table, 0 );
+        QCOMPARE( rates.status.at( 0 ), static_cast< quint8 >( QtSnmpRateEngine::RATE_VALID ) );
+        QCOMPARE( rates.per_second.at( 0 ), 100.0 );
+        QCOMPARE( rates.per_second.at( 1 ), 50.0 );
+
+        // a new row appears and an old one is reset
+        table = makeTable( { { "1", 400 }, { "3", 10 }, { "2", 0 } } );
+        rates = engine.update( Agent, 1400, table, 0 );
+        QCOMPARE( rates.status.at( 0 ), static_cast< quint8 >( QtSnmpRateEngine::RATE_VALID ) );
+        QCOMPARE( rates.delta.at( 0 ), Q_UINT64_C( 100 ) );
+        QCOMPARE( rates.status.at( 1 ), static_cast< quint8 >( QtSnmpRateEngine::RATE_FIRST_SAMPLE ) );
+        QCOMPARE( rates.status.at( 2 ), static_cast< quint8 >( QtSnmpRateEngine::RATE_DISCONTINUITY ) );
+        QCOMPARE( engine.sampleCount(), 3 );
+    }
+};
+
+QTEST_MAIN( TestQtSnmpRateEngine )
+#include "tsta_qtsnmpclient_rate.moc"
@@ -0,0 +1,223 @@
+#include <QTest>
+#include <QDebug>
+#include <QtSnmpClient.h>
+#include <Simulator.h>
+
+using namespace qtsnmpsimulator;
+
+namespace {
+    const quint16 TestPort = 65040;
+    const int AgentCount = 8;
+
+    const QByteArray walk =
+        ".1.3.6.1.2.1.1.1.0 = STRING: \"Simulated agent\"\n"
+        ".1.3.6.1.2.1.1.3.0 = Timeticks: (123456) 0:20:34.56\n"
+        ".1.3.6.1.2.1.2.2.1.2.1 = STRING: \"lo\"\n"
+        ".1.3.6.1.2.1.2.2.1.2.2 = STRING: \"eth0\"\n"
+        ".1.3.6.1.2.1.2.2.1.2.10 = STRING: \"eth1\"\n"
+        ".1.3.6.1.2.1.2.2.1.5.2 = Gauge32: 1000000000\n"
+        ".1.3.6.1.2.1.2.2.1.6.2 = Hex-STRING: 52 54 00 12 34 56 \n"
+        ".1.3.6.1.2.1.2.2.1.8.2 = INTEGER: up(1)\n"
+        ".1.3.6.1.2.1.2.2.1.10.2 = Counter32: 4294967295\n";
+}
+
+class TestQtSnmpResults : public QObject {
+    Q_OBJECT
+    Simulator m_simulator;
+    QScopedPointer< QtSnmpClient > m_client;
+    int m_response_count = 0;
+    int m_fail_count = 0;
+    QtSnmpDataList m_response_list;
+
+    void connectClient( QtSnmpClient*const client ) {
+        connect( client, &QtSnmpClient::responseReceived,
+                 [this]( const qint32, const QtSnmpDataList& list )
+        {
+            ++m_response_count;
+            m_response_list = list;
+        });
+        connect( client, &QtSnmpClient::requestFailed,
+                 [this]( const qint32 ) { ++m_fail_count; } );
+    }
+
+private slots:
+    void initTestCase() {
+        Mib mib;
+        mib.loadWalk( walk );
+        m_simulator.setMib( mib );
+        QString error;
+        QVERIFY2( m_simulator.start( QHostAddress::LocalHost, TestPort, AgentCount, &error ),
+                  qPrintable( error ) );
+    }
+
+    void init() {
+        m_simulator.setConfig( AgentConfig() );
+        m_simulator.setSeed( 1 );
+        m_response_count = 0;
+        m_fail_count = 0;
+        m_response_list.clear();
+
+        m_client.reset( new QtSnmpClient );
+        m_client->setAgentAddress( QHostAddress::LocalHost );
+        m_client->setAgentPort( TestPort );
+        m_client->setReponseTimeout( 100 );
+        connectClient( m_client.data() );
+    }
+
+    void testSharedResult() {
+        QtSnmpDataListPtr first;
+        QtSnmpDataListPtr second;
+        connect( m_client.data(), &QtSnmpClient::resultReady,
+                 [&first]( const qint32, const QtSnmpDataListPtr& list ) { first = list; } );
+        connect( m_client.data(), &QtSnmpClient::resultReady,
+                 [&second]( const qint32, const QtSnmpDataListPtr& list ) { second = list; } );
+
+        m_client->requestSubValues( ".1.3.6.1.2.1.2.2.1.2" );
+        QTRY_COMPARE( m_response_count, 1 );
+        QVERIFY( first );
+        QVERIFY( first == second );
+        QVERIFY( 3 == first->size() );
+        QVERIFY( *first == m_response_list );
+        QCOMPARE( first->at( 1 ).address(), QByteArray( ".1.3.6.1.2.1.2.2.1.2.2" ) );
+    }
+
+    void testTable() {
+        QtSnmpTablePtr table;
+        connect( m_client.data(), &QtSnmpClient::tableReceived,
+                 [&table]( const qint32, const QtSnmpTablePtr& result ) { table = result; } );
+
+        m_client->requestTable( ".1.3.6.1.2.1.2.2.1" );
+        QTRY_VERIFY( table );
+        QCOMPARE( table->rowCount(), 3 );
+        QCOMPARE( table->columnCount(), 5 );
+        const int row = table->findRow( "2" );
+        QCOMPARE( table->bytesValue( row, table->findColumn( 2 ) ), QByteArray( "eth0" ) );
+        QCOMPARE( table->int64Column( table->findColumn( 8 ) ).at( static_cast< size_t >( row ) ), Q_INT64_C( 1 ) );
+        QCOMPARE( table->uint64Column( table->findColumn( 10 ) ).at( static_cast< size_t >( row ) ),
+                  Q_UINT64_C( 4294967295 ) );
+        QVERIFY( ! table->hasValue( table->findRow( "10" ), table->findColumn( 10 ) ) );
+    }
+
+    void testCallbacks() {
+        QList< QtSnmpResult > results;
+        auto callback = [&results]( const QtSnmpResult& result ) { results << result; };
+        QObject context;
+        const auto get_id = m_client->requestValue( ".1.3.6.1.2.1.1.3.0", &context, callback );
+        const auto walk_id = m_client->requestSubValues( ".1.3.6.1.2.1.2.2.1.2", nullptr, callback );
+        const auto table_id = m_client->requestTable( ".1.3.6.1.2.1.2.2.1", &context, callback );
+        QTRY_COMPARE( results.size(), 3 );
+        QCOMPARE( results.at( 0 ).request_id, get_id );
+        QVERIFY( results.at( 0 ).is_ok );
+        QVERIFY( 1 == results.at( 0 ).values->size() );
+        QCOMPARE( results.at( 1 ).request_id, walk_id );
+        QVERIFY( 3 == results.at( 1 ).values->size() );
+        QCOMPARE( results.at( 2 ).request_id, table_id );
+        QVERIFY( results.at( 2 ).table );
+        QCOMPARE( results.at( 2 ).table->rowCount(), 3 );
+
+        // the signals are not emitted for the requests with callbacks
+        QCOMPARE( m_response_count, 0 );
+
+        // the callback of a destroyed context is not called
+        bool is_called = false;
+        {
+            QObject short_context;
+            m_client->requestValue( ".1.3.6.1.2.1.1.3.0", &short_context,
+                                    [&is_called]( const QtSnmpResult& ) { is_called = true; } );
+        }
+        m_client->requestValue( ".1.3.6.1.2.1.1.3.0", &context, callback );
+        QTRY_COMPARE( results.size(), 4 );
+        QVERIFY( ! is_called );
+
+        AgentConfig config;
+        config.loss_rate = 1;
+        m_simulator.setConfig( config );
+        m_client->requestValue( ".1.3.6.1.2.1.1.3.0", &context, callback );
+        QTRY_COMPARE_WITH_TIMEOUT( results.size(), 5, 5000 );
+        QVERIFY( ! results.last().is_ok );
+        QVERIFY( ! results.last().values );
+        QCOMPARE( m_fail_count, 0 );
+    }
+
+    void testDeleteInCallback() {
+        // NOTE: the client (and its session) is deleted by the callback of every
+        //       kind of the result, the next request is not started by a deleted
+        //       session; it is checked by a build with the address sanitizer
+        //       (qmake CONFIG+=sanitizer CONFIG+=sanitize_address)
+        int result_count = 0;
+        auto deleter = [this, &result_count]( const QtSnmpResult& ) {
+            ++result_count;
+            m_client.reset();
+        };
+        const auto next = []( const QtSnmpResult& ) { QFAIL( "the next request of a deleted client" ); };
+
+        m_client->requestValue( ".1.3.6.1.2.1.1.3.0", nullptr, deleter );
+        m_client->requestValue( ".1.3.6.1.2.1.1.3.0", nullptr, next );
+        QTRY_COMPARE( result_count, 1 );
+        QVERIFY( m_client.isNull() );
+
+        init();
+        m_client->requestTable( ".1.3.6.1.2.1.2.2.1", nullptr, deleter );
+        m_client->requestValue( ".1.3.6.1.2.1.1.3.0", nullptr, next );
+        QTRY_COMPARE( result_count, 2 );
+        QVERIFY( m_client.isNull() );
+
+        init();
+        connect( m_client.data(), &QtSnmpClient::responseReceived,
+                 [this, &result_count]( const qint32, const QtSnmpDataList& )
+        {
+            ++result_count;
+            m_client.reset();
+        });
+        m_client->requestSubValues( ".1.3.6.1.2.1.2.2.1.2" );
+        m_client->requestValue( ".1.3.6.1.2.1.1.3.0", nullptr, next );
+        QTRY_COMPARE( result_count, 3 );
+        QVERIFY( m_client.isNull() );
+
+        init();
+        AgentConfig config;
+        config.loss_rate = 1;
+        m_simulator.setConfig( config );
+        m_client->requestValue( ".1.3.6.1.2.1.1.3.0", nullptr, deleter );
+        m_client->requestValue( ".1.3.6.1.2.1.1.3.0", nullptr, next );
+        QTRY_COMPARE_WITH_TIMEOUT( result_count, 4, 5000 );
+        QVERIFY( m_client.isNull() );
+        QTest::qWait( 200 );
+    }
+
+    void testParallelDecode() {
+        QtSnmpClient::setDecodeThreadCount( 4 );
+        QCOMPARE( QtSnmpClient::decodeThreadCount(), 4 );
+        std::vector< std::unique_ptr< QtSnmpClient > > clients;
+        QVector< QList< QtSnmpResult > > results( AgentCount );
+        int result_count = 0;
+        for ( int i = 0; i < AgentCount; ++i ) {
+            auto callback = [&results, &result_count, i]( const QtSnmpResult& result ) {
+                results[ i ] << result;
+                ++result_count;
+            };
+            clients.emplace_back( new QtSnmpClient );
+            auto& client = *clients.back();
+            client.setAgentAddress( QHostAddress::LocalHost );
+            client.setAgentPort( m_simulator.agentPort( i ) );
+            client.requestTable( ".1.3.6.1.2.1.2.2.1", nullptr, callback );
+            client.requestValues( QStringList() << ".1.3.6.1.2.1.1.1.0" << ".1.3.6.1.2.1.1.3.0", nullptr, callback );
+        }
+        QTRY_COMPARE( result_count, 2 * AgentCount );
+        QtSnmpClient::setDecodeThreadCount( 0 );
+
+        // NOTE: the results of every client are in the order of its requests
+        for ( const auto& list : results ) {
+            QCOMPARE( list.size(), 2 );
+            QVERIFY( list.at( 0 ).is_ok );
+            QVERIFY( list.at( 0 ).table );
+            QCOMPARE( list.at( 0 ).table->rowCount(), 3 );
+            QVERIFY( list.at( 1 ).is_ok );
+            QVERIFY( 2 == list.at( 1 ).values->size() );
+            QCOMPARE( list.at( 1 ).values->at( 0 ).data(), QByteArray( "Simulated agent" ) );
+        }
+    }
+};
+
+QTEST_MAIN( TestQtSnmpResults )
+#include "tsta_qtsnmpclient_results.moc"
@@ -0,0 +1,111 @@
+#include <QTest>
+#include <QDebug>
+#include <QtSnmpClient.h>
+#include <Simulator.h>
+
+using namespace qtsnmpsimulator;
+
+namespace {
+    const quint16 TestPort = 65110;
+
+    const QByteArray walk =
+        ".1.3.6.1.2.1.1.4.0 = STRING: \"first line\n"
+        "second line\"\n"
+        ".1.3.6.1.2.1.2.2.1.2.1 = STRING: \"lo\"\n"
+        ".1.3.6.1.2.1.2.2.1.2.2 = STRING: \"eth0\"\n"
+        ".1.3.6.1.2.1.2.2.1.2.10 = STRING: \"eth1\"\n";
+}
+
+class TestQtSnmpSetValues : public QObject {
+    Q_OBJECT
+    Simulator m_simulator;
+    QScopedPointer< QtSnmpClient > m_client;
+    int m_response_count = 0;
+    int m_fail_count = 0;
+
+    void connectClient( QtSnmpClient*const client ) {
+        connect( client, &QtSnmpClient::responseReceived,
+                 [this]( const qint32, const QtSnmpDataList& ) { ++m_response_count; } );
+        connect( client, &QtSnmpClient::requestFailed,
+                 [this]( const qint32 ) { ++m_fail_count; } );
+    }
+
+private slots:
+    void initTestCase() {
+        QString error;
+        QVERIFY2( m_simulator.start( QHostAddress::LocalHost, TestPort, 1, &error ),
+                  qPrintable( error ) );
+    }
+
+    void init() {
+        // NOTE: the MIB changed by the SET requests of a test is not shared
+        //       with the next one
+        Mib mib;
+        mib.loadWalk( walk );
+        m_simulator.setMib( mib );
+        m_simulator.setConfig( AgentConfig() );
+        m_simulator.setSeed( 1 );
+        m_response_count = 0;
+        m_fail_count = 0;
+
+        m_client.reset( new QtSnmpClient );
+        m_client->setAgentAddress( QHostAddress::LocalHost );
+        m_client->setAgentPort( TestPort );
+        m_client->setReponseTimeout( 100 );
+        connectClient( m_client.data() );
+    }
+
+    void testSetValues() {
+        QList< QtSnmpResult > results;
+        auto callback = [&results]( const QtSnmpResult& result ) { results << result; };
+        auto makeValue = []( const QByteArray& oid, const QByteArray& text ) {
+            auto value = QtSnmpData::string( text );
+            value.setAddress( oid );
+            return value;
+        };
+        const QtSnmpDataList values = { makeValue( ".1.3.6.1.2.1.2.2.1.2.1", "lo0" ),
+                                        makeValue( ".1.3.6.1.2.1.2.2.1.2.2", "eth10" ),
+                                        makeValue( ".1.3.6.1.2.1.2.2.1.2.10", "eth11" ),
+                                        makeValue( ".1.3.6.1.2.1.1.4.0", "admin" ) };
+
+        // one PDU for all the values
+        const auto first = m_simulator.statistics().requests;
+        m_client->setValues( "public", values, nullptr, callback );
+        QTRY_COMPARE( results.size(), 1 );
+        QVERIFY( results.at( 0 ).is_ok );
+        QVERIFY( 4 == results.at( 0 ).values->size() );
+        QVERIFY( results.at( 0 ).set_status == std::vector< int >( 4, 0 ) );
+        QCOMPARE( m_simulator.statistics().requests - first, quint64( 1 ) );
+
+        // the PDUs over the size of a response are split
+        AgentConfig config;
+        config.too_big_threshold = 100;
+        m_simulator.setConfig( config );
+        m_client->setValues( "public", values, nullptr, callback );
+        QTRY_COMPARE( results.size(), 2 );
+        QVERIFY( results.at( 1 ).is_ok );
+        QVERIFY( 4 == results.at( 1 ).values->size() );
+        QCOMPARE( results.at( 1 ).values->at( 3 ).data(), QByteArray( "admin" ) );
+        QVERIFY( m_client->metrics().too_big > 0 );
+        m_simulator.setConfig( AgentConfig() );
+
+        // the error of a value fails only its PDU,
+        // the PDUs of SET are not limited by the GET request limit
+        m_client->setSetRequestLimit( 2 );
+        m_client->setGetRequestLimit( 1 );
+        auto wrong_values = values;
+        wrong_values[ 1 ].setAddress( ".1.3.6.1.2.1.2.2.1.2.3" );
+        m_client->setValues( "public", wrong_values, nullptr, callback );
+        m_client->setValues( "public", wrong_values );
+        QTRY_COMPARE( m_fail_count, 1 );
+        QCOMPARE( results.size(), 3 );
+        const auto& failed = results.at( 2 );
+        QVERIFY( ! failed.is_ok );
+        QCOMPARE( failed.error, int( QtSnmpResult::SetFailed ) );
+        QVERIFY( failed.set_status == std::vector< int >( { QtSnmpResult::SetNotApplied, 11, 0, 0 } ) );
+        QVERIFY( 2 == failed.values->size() );
+    }
+};
+
+QTEST_MAIN( TestQtSnmpSetValues )
+#include "tsta_qtsnmpclient_set.moc"
@@ -0,0 +1,226 @@
+#include <QTest>
+#include <QDebug>
+#include <QtSnmpClient.h>
+#include <QtSnmpMetrics.h>
+#include <Simulator.h>
+#include <chrono>
+
+using namespace std::chrono;
+using namespace qtsnmpsimulator;
+
+namespace {
+    const quint16 TestPort = 65010;
+    const int AgentCount = 8;
+    const milliseconds default_delay_ms{ 100 };
+
+    const QByteArray walk =
+        ".1.3.6.1.2.1.1.1.0 = STRING: \"Simulated agent\"\n"
+        ".1.3.6.1.2.1.1.2.0 = OID: .1.3.6.1.4.1.8072.3.2.10\n"
+        ".1.3.6.1.2.1.1.3.0 = Timeticks: (123456) 0:20:34.56\n"
+        ".1.3.6.1.2.1.1.4.0 = STRING: \"first line\n"
+        "second line\"\n"
+        ".1.3.6.1.2.1.2.1.0 = INTEGER: 3\n"
+        ".1.3.6.1.2.1.2.2.1.2.1 = STRING: \"lo\"\n"
+        ".1.3.6.1.2.1.2.2.1.2.2 = STRING: \"eth0\"\n"
+        ".1.3.6.1.2.1.2.2.1.2.10 = STRING: \"eth1\"\n"
+        ".1.3.6.1.2.1.2.2.1.6.2 = Hex-STRING: 52 54 00 12 34 56 \n"
+        ".1.3.6.1.2.1.2.2.1.8.2 = INTEGER: up(1)\n"
+        ".1.3.6.1.2.1.2.2.1.10.2 = Counter32: 4294967295\n"
+        ".1.3.6.1.2.1.2.2.1.5.2 = Gauge32: 1000000000\n"
+        ".1.3.6.1.2.1.4.20.1.1.127.0.0.1 = IpAddress: 127.0.0.1\n"
+        ".1.3.6.1.2.1.31.1.1.1.6.2 = Counter64: 18446744073709551615\n"
+        "SNMPv2-MIB::sysName.0 = STRING: unsupported\n";
+}
+
+class TestQtSnmpSimulator : public QObject {
+    Q_OBJECT
+    Simulator m_simulator;
+    QScopedPointer< QtSnmpClient > m_client;
+    int m_response_count = 0;
+    int m_fail_count = 0;
+    QtSnmpDataList m_response_list;
+
+    void connectClient( QtSnmpClient*const client ) {
+        connect( client, &QtSnmpClient::responseReceived,
+                 [this]( const qint32, const QtSnmpDataList& list )
+        {
+            ++m_response_count;
+            m_response_list = list;
+        });
+        connect( client, &QtSnmpClient::requestFailed,
+                 [this]( const qint32 ) { ++m_fail_count; } );
+    }
+
+private slots:
+    void initTestCase() {
+        QString error;
+        QVERIFY2( m_simulator.start( QHostAddress::LocalHost, TestPort, AgentCount, &error ),
+                  qPrintable( error ) );
+    }
+
+    void init() {
+        // NOTE: the MIB changed by the SET requests of a test is not shared
+        //       with the next one
+        Mib mib;
+        mib.loadWalk( walk );
+        m_simulator.setMib( mib );
+        m_simulator.setConfig( AgentConfig() );
+        m_simulator.setSeed( 1 );
+        m_response_count = 0;
+        m_fail_count = 0;
+        m_response_list.clear();
+
+        m_client.reset( new QtSnmpClient );
+        m_client->setAgentAddress( QHostAddress::LocalHost );
+        m_client->setAgentPort( TestPort );
+        m_client->setReponseTimeout( 100 );
+        connectClient( m_client.data() );
+    }
+
+    void testWalkParsing() {
+        Mib mib;
+        mib.loadWalk( walk );
+        QCOMPARE( mib.size(), size_t( 14 ) );
+        QCOMPARE( mib.skippedLineCount(), 1 );
+
+        QtSnmpData value;
+        QVERIFY( mib.find( ".1.3.6.1.2.1.1.4.0", &value ) );
+        QCOMPARE( value.data(), QByteArray( "first line\nsecond line" ) );
+        QVERIFY( mib.find( ".1.3.6.1.2.1.2.2.1.6.2", &value ) );
+        QCOMPARE( value.data(), QByteArray::fromHex( "525400123456" ) );
+        QVERIFY( mib.find( ".1.3.6.1.2.1.2.2.1.8.2", &value ) );
+        QCOMPARE( value.intValue(), 1 );
+        QVERIFY( mib.find( ".1.3.6.1.2.1.1.3.0", &value ) );
+        QCOMPARE( value.longLongValue(), qint64( 123456 ) );
+        QVERIFY( mib.find( ".1.3.6.1.2.1.4.20.1.1.127.0.0.1", &value ) );
+        QCOMPARE( value.data(), QByteArray::fromHex( "7f000001" ) );
+
+        // NOTE: the instances are ordered arc by arc
+        QVERIFY( mib.findNext( ".1.3.6.1.2.1.2.2.1.2.2", &value ) );
+        QCOMPARE( value.address(), QByteArray( ".1.3.6.1.2.1.2.2.1.2.10" ) );
+        QVERIFY( mib.findNext( ".1.3.6.1.2.1.2.2.1.2", &value ) );
+        QCOMPARE( value.address(), QByteArray( ".1.3.6.1.2.1.2.2.1.2.1" ) );
+        QVERIFY( ! mib.findNext( ".1.3.6.1.2.1.31.1.1.1.6.2", &value ) );
+    }
+
+    void testGetAndWalk() {
+        m_client->requestValue( ".1.3.6.1.2.1.1.1.0" );
+        QTRY_COMPARE( m_response_count, 1 );
+        QVERIFY( 1 == m_response_list.size() );
+        QCOMPARE( m_response_list.at( 0 ).data(), QByteArray( "Simulated agent" ) );
+
+        m_client->requestSubValues( ".1.3.6.1.2.1.2.2.1.2" );
+        QTRY_COMPARE( m_response_count, 2 );
+        QVERIFY( 3 == m_response_list.size() );
+        QCOMPARE( m_response_list.at( 0 ).data(), QByteArray( "lo" ) );
+        QCOMPARE( m_response_list.at( 1 ).data(), QByteArray( "eth0" ) );
+        QCOMPARE( m_response_list.at( 2 ).data(), QByteArray( "eth1" ) );
+    }
+
+    void testSetValue() {
+        const auto oid = QString( ".1.3.6.1.2.1.1.4.0" );
+        m_client->setValue( "public", oid, QtSnmpData::STRING_TYPE, "admin" );
+        QTRY_COMPARE( m_response_count, 1 );
+        m_client->requestValue( oid );
+        QTRY_COMPARE( m_response_count, 2 );
+        QCOMPARE( m_response_list.at( 0 ).data(), QByteArray( "admin" ) );
+
+        // NOTE: the other agents are not changed
+        QtSnmpClient client;
+        client.setAgentAddress( QHostAddress::LocalHost );
+        client.setAgentPort( TestPort + 1 );
+        connectClient( &client );
+        client.requestValue( oid );
+        QTRY_COMPARE( m_response_count, 3 );
+        QCOMPARE( m_response_list.at( 0 ).data(), QByteArray( "first line\nsecond line" ) );
+    }
+
+    void testLatency() {
+        AgentConfig config;
+        config.latency_ms = 50;
+        config.jitter_ms = 10;
+        m_simulator.setConfig( config );
+        m_client->setReponseTimeout( 1000 );
+
+        const int request_count = 5;
+        for ( int i = 0; i < request_count; ++i ) {
+            m_client->requestValue( ".1.3.6.1.2.1.1.1.0" );
+        }
+        QTRY_COMPARE_WITH_TIMEOUT( m_response_count, request_count, 5000 );
+
+        const auto metrics = m_client->metrics();
+        QVERIFY( metrics.rtt.count == request_count );
+        QVERIFY( metrics.rtt.sum >= request_count * 40000 );
+    }
+
+    void testLoss() {
+        AgentConfig config;
+        config.loss_rate = 1;
+        m_simulator.setConfig( config );
+        const auto before = m_simulator.statistics();
+
+        m_client->requestValue( ".1.3.6.1.2.1.1.1.0" );
+        QTRY_COMPARE_WITH_TIMEOUT( m_fail_count, 1, 5000 );
+        QCOMPARE( m_response_count, 0 );
+        QVERIFY( m_simulator.statistics().lost - before.lost == 6 );
+    }
+
+    void testDuplicates() {
+        AgentConfig config;
+        config.duplicate_rate = 1;
+        m_simulator.setConfig( config );
+
+        m_client->requestValue( ".1.3.6.1.2.1.1.1.0" );
+        QTRY_COMPARE( m_response_count, 1 );
+        QTest::qWait( default_delay_ms.count() );
+        QCOMPARE( m_response_count, 1 );
+        QCOMPARE( m_fail_count, 0 );
+        QVERIFY( m_client->metrics().pdus_received == 2 );
+        QVERIFY( m_client->metrics().duplicates == 1 );
+    }
+
+    void testTooBig() {
+        AgentConfig config;
+        config.too_big_threshold = 40;
+        m_simulator.setConfig( config );
+
+        m_client->requestValue( ".1.3.6.1.2.1.1.1.0" );
+        QTRY_COMPARE( m_fail_count, 1 );
+        QVERIFY( m_client->metrics().too_big == 1 );
+    }
+
+    void testLossyWalk() {
+        // NOTE: late and duplicated responses must not break a walk
+        AgentConfig config;
+        config.latency_ms = 20;
+        config.jitter_ms = 15;
+        config.loss_rate = 0.2;
+        config.duplicate_rate = 0.3;
+        config.reorder_rate = 0.2;
+        m_simulator.setConfig( config );
+        m_client->setReponseTimeout( 30 );
+
+        m_client->requestSubValues( ".1.3.6.1.2.1.2.2.1.2" );
+        QTRY_COMPARE_WITH_TIMEOUT( m_response_count + m_fail_count, 1, 10000 );
+        QCOMPARE( m_response_count, 1 );
+        QVERIFY( 3 == m_response_list.size() );
+        QCOMPARE( m_response_list.at( 2 ).data(), QByteArray( "eth1" ) );
+    }
+
+    void testManyAgents() {
+        std::vector< std::unique_ptr< QtSnmpClient > > clients;
+        for ( int i = 0; i < AgentCount; ++i ) {
+            clients.emplace_back( new QtSnmpClient );
+            auto& client = *clients.back();
+            client.setAgentAddress( QHostAddress::LocalHost );
+            client.setAgentPort( m_simulator.agentPort( i ) );
+            connectClient( &client );
+            client.requestSubValues( ".1.3.6.1.2.1.2.2.1.2" );
+        }
+        QTRY_COMPARE( m_response_count, AgentCount );
+        QCOMPARE( m_fail_count, 0 );
+    }
+};
+
+QTEST_MAIN( TestQtSnmpSimulator )
+#include "tsta_qtsnmpclient_simulator.moc"
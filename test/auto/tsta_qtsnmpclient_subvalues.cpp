@@ -0,0 +1,132 @@
+#include <QTest>
+#include <QDebug>
+#include <QtSnmpClient.h>
+#include <QtSnmpMetrics.h>
+#include <Simulator.h>
+
+using namespace qtsnmpsimulator;
+
+namespace {
+    const quint16 TestPort = 65090;
+
+    const QByteArray walk =
+        ".1.3.6.1.2.1.1.3.0 = Timeticks: (123456) 0:20:34.56\n"
+        ".1.3.6.1.2.1.2.1.0 = INTEGER: 3\n"
+        ".1.3.6.1.2.1.2.2.1.2.1 = STRING: \"lo\"\n"
+        ".1.3.6.1.2.1.2.2.1.2.2 = STRING: \"eth0\"\n"
+        ".1.3.6.1.2.1.2.2.1.2.10 = STRING: \"eth1\"\n";
+}
+
+class TestQtSnmpSubValues : public QObject {
+    Q_OBJECT
+    Simulator m_simulator;
+    QScopedPointer< QtSnmpClient > m_client;
+    int m_response_count = 0;
+    int m_fail_count = 0;
+
+    void connectClient( QtSnmpClient*const client ) {
+        connect( client, &QtSnmpClient::responseReceived,
+                 [this]( const qint32, const QtSnmpDataList& ) { ++m_response_count; } );
+        connect( client, &QtSnmpClient::requestFailed,
+                 [this]( const qint32 ) { ++m_fail_count; } );
+    }
+
+private slots:
+    void initTestCase() {
+        QString error;
+        QVERIFY2( m_simulator.start( QHostAddress::LocalHost, TestPort, 1, &error ),
+                  qPrintable( error ) );
+    }
+
+    void init() {
+        // NOTE: the MIB changed by the SET requests of a test is not shared
+        //       with the next one
+        Mib mib;
+        mib.loadWalk( walk );
+        m_simulator.setMib( mib );
+        m_simulator.setConfig( AgentConfig() );
+        m_simulator.setSeed( 1 );
+        m_response_count = 0;
+        m_fail_count = 0;
+
+        m_client.reset( new QtSnmpClient );
+        m_client->setAgentAddress( QHostAddress::LocalHost );
+        m_client->setAgentPort( TestPort );
+        m_client->setReponseTimeout( 100 );
+        connectClient( m_client.data() );
+    }
+
+    void testConditionalWalk() {
+        QList< QtSnmpDataListPtr > results;
+        connect( m_client.data(), &QtSnmpClient::resultReady,
+                 [&results]( const qint32, const QtSnmpDataListPtr& values ) { results << values; } );
+
+        const auto if_descr = QString( ".1.3.6.1.2.1.2.2.1.2" );
+        const auto if_number = QString( ".1.3.6.1.2.1.2.1.0" );
+        const auto first = m_simulator.statistics().requests;
+        m_client->requestSubValuesIfChanged( if_descr, if_number );
+        QTRY_COMPARE( results.size(), 1 );
+        QVERIFY( 3 == results.at( 0 )->size() );
+        QCOMPARE( results.at( 0 )->at( 1 ).data(), QByteArray( "eth0" ) );
+        const auto second = m_simulator.statistics().requests;
+        QCOMPARE( second - first, quint64( 5 ) );
+
+        // the unchanged guard costs one request, the result is the same
+        m_client->requestSubValuesIfChanged( if_descr, if_number );
+        QTRY_COMPARE( results.size(), 2 );
+        QVERIFY( results.at( 0 ) == results.at( 1 ) );
+        QCOMPARE( m_simulator.statistics().requests - second, quint64( 1 ) );
+
+        // a changed guard triggers the walk
+        m_client->setValue( "public", if_number, QtSnmpData::INTEGER_TYPE, QByteArray( 1, '\x5' ) );
+        m_client->requestSubValuesIfChanged( if_descr, if_number );
+        QTRY_COMPARE( results.size(), 4 );
+        QVERIFY( results.at( 3 ) != results.at( 1 ) );
+        QVERIFY( *results.at( 3 ) == *results.at( 1 ) );
+
+        // sysUpTime triggers the walk only when it goes back
+        const auto sys_up_time = QString( ".1.3.6.1.2.1.1.3.0" );
+        m_client->requestSubValuesIfChanged( if_descr, sys_up_time );
+        m_client->setValue( "public", sys_up_time, QtSnmpData::TIME_TICKS_TYPE, QByteArray::fromHex( "0f4240" ) );
+        m_client->requestSubValuesIfChanged( if_descr, sys_up_time );
+        m_client->setValue( "public", sys_up_time, QtSnmpData::TIME_TICKS_TYPE, QByteArray::fromHex( "01" ) );
+        m_client->requestSubValuesIfChanged( if_descr, sys_up_time );
+        QTRY_COMPARE( results.size(), 9 );
+        QVERIFY( results.at( 4 ) == results.at( 6 ) );
+        QVERIFY( results.at( 6 ) != results.at( 8 ) );
+        QCOMPARE( m_fail_count, 0 );
+    }
+
+    void testWalkLimits() {
+        QList< QtSnmpResult > results;
+        auto callback = [&results]( const QtSnmpResult& result ) { results << result; };
+        QList< int > errors;
+        connect( m_client.data(), &QtSnmpClient::walkAborted,
+                 [&errors]( const qint32, const int error ) { errors << error; } );
+
+        const auto if_descr = QString( ".1.3.6.1.2.1.2.2.1.2" );
+        m_client->setWalkLimits( 2, 0 );
+        QCOMPARE( m_client->walkRowLimit(), 2 );
+        m_client->requestSubValues( if_descr, nullptr, callback );
+        m_client->requestTable( ".1.3.6.1.2.1.2.2.1", nullptr, callback );
+        m_client->requestSubValues( if_descr );
+        QTRY_COMPARE( m_fail_count, 1 );
+        QCOMPARE( results.size(), 2 );
+        QVERIFY( ! results.at( 0 ).is_ok );
+        QCOMPARE( results.at( 0 ).error, int( QtSnmpResult::WalkLimitExceeded ) );
+        QCOMPARE( results.at( 1 ).error, int( QtSnmpResult::WalkLimitExceeded ) );
+        QCOMPARE( errors, QList< int >() << QtSnmpResult::WalkLimitExceeded );
+        QCOMPARE( m_client->metrics().aborted_walks, quint64( 3 ) );
+
+        // the walk of the limit size is complete
+        m_client->setWalkLimits( 3, 10000 );
+        m_client->requestSubValues( if_descr, nullptr, callback );
+        QTRY_COMPARE( results.size(), 3 );
+        QVERIFY( results.at( 2 ).is_ok );
+        QCOMPARE( results.at( 2 ).error, int( QtSnmpResult::NoError ) );
+        QVERIFY( 3 == results.at( 2 ).values->size() );
+    }
+};
+
+QTEST_MAIN( TestQtSnmpSubValues )
+#include "tsta_qtsnmpclient_subvalues.moc"
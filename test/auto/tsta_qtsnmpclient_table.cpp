@@ -0,0 +1,76 @@
+#include <QTest>
+#include <QDebug>
+#include <QtSnmpTable.h>
+
+namespace {
+    const QByteArray EntryOid = ".1.3.6.1.2.1.2.2.1";
+
+    QtSnmpData makeValue( const int type,
+                          const QByteArray& data,
+                          const QByteArray& suffix )
+    {
+        QtSnmpData value( type, data );
+        value.setAddress( EntryOid + suffix );
+        return value;
+    }
+}
+
+class TestQtSnmpTable : public QObject {
+    Q_OBJECT
+private slots:
+    void testColumns() {
+        QtSnmpDataList list;
+        list.push_back( makeValue( QtSnmpData::STRING_TYPE, "lo", ".2.1" ) );
+        list.push_back( makeValue( QtSnmpData::STRING_TYPE, "eth0", ".2.2" ) );
+        list.push_back( makeValue( QtSnmpData::STRING_TYPE, "", ".2.10" ) );
+        list.push_back( makeValue( QtSnmpData::INTEGER_TYPE, QByteArray::fromHex( "FC" ), ".8.1" ) );
+        list.push_back( makeValue( QtSnmpData::INTEGER_TYPE, QByteArray::fromHex( "00FC" ), ".8.10" ) );
+        list.push_back( makeValue( QtSnmpData::COUNTER_TYPE, QByteArray::fromHex( "00FFFFFFFF" ), ".10.2" ) );
+        list.push_back( makeValue( QtSnmpData::COUNTER64_TYPE, QByteArray::fromHex( "00FFFFFFFFFFFFFFFF" ), ".10.42" ) );
+
+        const auto table = QtSnmpTable::fromList( EntryOid, list );
+        QCOMPARE( table.rowCount(), 4 );
+        QCOMPARE( table.columnCount(), 3 );
+        QCOMPARE( table.rowIndex( 3 ), QByteArray( "42" ) );
+        QCOMPARE( table.findRow( "10" ), 2 );
+        QCOMPARE( table.findRow( "11" ), -1 );
+
+        const int names = table.findColumn( 2 );
+        QCOMPARE( table.columnKind( names ), QtSnmpTable::BYTES_COLUMN );
+        QCOMPARE( table.bytesValue( table.findRow( "2" ), names ), QByteArray( "eth0" ) );
+        QVERIFY( table.hasValue( table.findRow( "10" ), names ) );
+        QVERIFY( ! table.hasValue( table.findRow( "42" ), names ) );
+
+        const int states = table.findColumn( 8 );
+        QCOMPARE( table.columnKind( states ), QtSnmpTable::INT64_COLUMN );
+        const std::vector< qint64 > expected_states = { -4, 0, 252, 0 };
+        QVERIFY( table.int64Column( states ) == expected_states );
+
+        const int octets = table.findColumn( 10 );
+        QCOMPARE( table.columnKind( octets ), QtSnmpTable::UINT64_COLUMN );
+        const auto& octet_values = table.uint64Column( octets );
+        QVERIFY( 4 == octet_values.size() );
+        QCOMPARE( octet_values.at( 1 ), Q_UINT64_C( 0xFFFFFFFF ) );
+        QCOMPARE( octet_values.at( 3 ), Q_UINT64_C( 0xFFFFFFFFFFFFFFFF ) );
+
+        QCOMPARE( table.findColumn( 3 ), -1 );
+        QVERIFY( table.toList() == list );
+    }
+
+    void testRejectedValues() {
+        QtSnmpTable table( EntryOid );
+        QVERIFY( table.append( makeValue( QtSnmpData::INTEGER_TYPE, QByteArray::fromHex( "01" ), ".8.1" ) ) );
+        // a value of another type in the same column
+        QVERIFY( ! table.append( makeValue( QtSnmpData::STRING_TYPE, "up", ".8.2" ) ) );
+        // values outside of the entry
+        QVERIFY( ! table.append( makeValue( QtSnmpData::INTEGER_TYPE, QByteArray::fromHex( "01" ), "0.8.1" ) ) );
+        QVERIFY( ! table.append( makeValue( QtSnmpData::INTEGER_TYPE, QByteArray::fromHex( "01" ), ".8" ) ) );
+        // too long for 64 bits
+        QVERIFY( ! table.append( makeValue( QtSnmpData::INTEGER_TYPE, QByteArray( 9, 0x01 ), ".8.3" ) ) );
+        QCOMPARE( table.rowCount(), 1 );
+        QCOMPARE( table.columnCount(), 1 );
+    }
+};
+
+QTEST_MAIN( TestQtSnmpTable )
+#include "tsta_qtsnmpclient_table.moc"
@@ -0,0 +1,481 @@
+#include <QTest>
+#include <QDebug>
+#include <QtSnmpClient.h>
+#include <QUdpSocket>
+#include <QMessageAuthenticationCode>
+#include <chrono>
+#include "Aes128.h"
+#include "Usm.h"
+
+using namespace std::chrono;
+using namespace qtsnmpclient;
+
+namespace {
+    const quint16 TestPort = 65001;
+    const milliseconds default_delay_ms{ 100 };
+
+    const auto engine_id = QByteArray::fromHex( "80001f8804717473" ) + "nmpagent";
+    const auto user_name = QByteArray( "collector" );
+    const auto auth_password = QByteArray( "auth-password" );
+    const auto priv_password = QByteArray( "priv-password" );
+    const qint32 engine_boots = 7;
+    const qint32 engine_time = 1000;
+    const auto unknown_engine_ids_oid = QByteArray( ".1.3.6.1.6.3.15.1.1.4.0" );
+    const auto not_in_time_window_oid = QByteArray( ".1.3.6.1.6.3.15.1.1.2.0" );
+    const auto agent_key = QByteArray( "127.0.0.1:" ) + QByteArray::number( TestPort );
+
+    struct Message {
+        int msg_id = 0;
+        int flags = 0;
+        QtSnmpDataList security_parameters;
+        QtSnmpData scoped_pdu;
+        bool authenticated = false;
+    };
+
+    int authOffset( const QByteArray& datagram ) {
+        const auto placeholder = QByteArray::fromHex( "040c" ) + QByteArray( 12, '\x0' );
+        const int pos = datagram.indexOf( placeholder );
+        return ( pos < 0 ) ? pos : pos + 2;
+    }
+
+    void writeIv( const qint32 boots,
+                  const qint32 time,
+                  const QByteArray& salt,
+                  quint8*const iv )
+    {
+        for ( int i = 0; i < 4; ++i ) {
+            iv[ i ] = static_cast< quint8 >( static_cast< quint32 >( boots ) >> ( 24 - 8*i ) );
+            iv[ 4 + i ] = static_cast< quint8 >( static_cast< quint32 >( time ) >> ( 24 - 8*i ) );
+        }
+        memcpy( iv + 8, salt.constData(), 8 );
+    }
+
+    Aes128 agentCipher() {
+        const auto key = UsmCache::localizedKey( priv_password, engine_id );
+        Aes128 cipher;
+        cipher.setKey( reinterpret_cast< const quint8* >( key.constData() ) );
+        return cipher;
+    }
+
+    bool parseMessage( const QByteArray& datagram,
+                       Message*const message )
+    {
+        QtSnmpDataList list;
+        QtSnmpData::parseData( datagram, &list );
+        if ( ( 1 != list.size() ) || ( 4 != list.at( 0 ).children().size() ) ) {
+            return false;
+        }
+
+        const auto& parts = list.at( 0 ).children();
+        if ( 3 != parts.at( 0 ).intValue() ) {
+            return false;
+        }
+        const auto& global_data = parts.at( 1 ).children();
+        if ( 4 != global_data.size() ) {
+            return false;
+        }
+        message->msg_id = global_data.at( 0 ).intValue();
+        message->flags = static_cast< quint8 >( global_data.at( 2 ).data().at( 0 ) );
+
+        QtSnmpDataList security_list;
+        QtSnmpData::parseData( parts.at( 2 ).data(), &security_list );
+        if ( ( 1 != security_list.size() ) || ( 6 != security_list.at( 0 ).children().size() ) ) {
+            return false;
+        }
+        message->security_parameters = security_list.at( 0 ).children();
+
+        if ( message->flags & Usm::FLAG_AUTH ) {
+            const auto received_digest = message->security_parameters.at( 4 ).data();
+            const int offset = datagram.indexOf( QByteArray::fromHex( "040c" ) + received_digest ) + 2;
+            auto zeroed = datagram;
+            zeroed.replace( offset, 12, QByteArray( 12, '\x0' ) );
+            const auto key = UsmCache::localizedKey( auth_password, engine_id );
+            const auto digest = QMessageAuthenticationCode::hash( zeroed, key, QCryptographicHash::Sha1 );
+            message->authenticated = ( digest.left( 12 ) == received_digest );
+        }
+
+        if ( message->flags & Usm::FLAG_PRIV ) {
+            quint8 iv[ Aes128::BLOCK_SIZE ];
+            writeIv( message->security_parameters.at( 1 ).intValue(),
+                     message->security_parameters.at( 2 ).intValue(),
+                     message->security_parameters.at( 5 ).data(),
+                     iv );
+            auto text = parts.at( 3 ).data();
+            agentCipher().cfbDecrypt( iv,
+                                      reinterpret_cast< const quint8* >( text.constData() ),
+                                      text.size(),
+                                      reinterpret_cast< quint8* >( text.data() ) );
+            QtSnmpDataList scoped_list;
+            QtSnmpData::parseData( text, &scoped_list );
+            if ( scoped_list.empty() ) {
+                return false;
+            }
+            message->scoped_pdu = scoped_list.at( 0 );
+        } else {
+            message->scoped_pdu = parts.at( 3 );
+        }
+        return 3 == message->scoped_pdu.children().size();
+    }
+
+    QByteArray makeAgentMessage( const int msg_id,
+                                 const int flags,
+                                 const QtSnmpData& pdu,
+                                 const qint32 boots = engine_boots,
+                                 const qint32 time = engine_time,
+                                 const QByteArray& agent_engine_id = engine_id )
+    {
+        auto scoped_pdu = QtSnmpData::sequence();
+        scoped_pdu.addChild( QtSnmpData::string( agent_engine_id ) );
+        scoped_pdu.addChild( QtSnmpData::string( QByteArray() ) );
+        scoped_pdu.addChild( pdu );
+
+        const auto salt = QByteArray::fromHex( "0102030405060708" );
+        QtSnmpData message_data = scoped_pdu;
+        if ( flags & Usm::FLAG_PRIV ) {
+            quint8 iv[ Aes128::BLOCK_SIZE ];
+            writeIv( boots, time, salt, iv );
+            auto text = scoped_pdu.makeSnmpChunk();
+            agentCipher().cfbEncrypt( iv,
+                                      reinterpret_cast< const quint8* >( text.constData() ),
+                                      text.size(),
+                                      reinterpret_cast< quint8* >( text.data() ) );
+            message_data = QtSnmpData::string( text );
+        }
+
+        auto security_parameters = QtSnmpData::sequence();
+        security_parameters.addChild( QtSnmpData::string( agent_engine_id ) );
+        security_parameters.addChild( QtSnmpData::integer( boots ) );
+        security_parameters.addChild( QtSnmpData::integer( time ) );
+        security_parameters.addChild( QtSnmpData::string( ( flags & Usm::FLAG_AUTH ) ? user_name : QByteArray() ) );
+        security_parameters.addChild( QtSnmpData::string( ( flags & Usm::FLAG_AUTH ) ? QByteArray( 12, '\x0' )
+                                                                                     : QByteArray() ) );
+        security_parameters.addChild( QtSnmpData::string( ( flags & Usm::FLAG_PRIV ) ? salt : QByteArray() ) );
+
+        auto global_data = QtSnmpData::sequence();
+        global_data.addChild( QtSnmpData::integer( msg_id ) );
+        global_data.addChild( QtSnmpData::integer( 65507 ) );
+        global_data.addChild( QtSnmpData::string( QByteArray( 1, static_cast< char >( flags ) ) ) );
+        global_data.addChild( QtSnmpData::integer( 3 ) );
+
+        auto message = QtSnmpData::sequence();
+        message.addChild( QtSnmpData::integer( 3 ) );
+        message.addChild( global_data );
+        message.addChild( QtSnmpData::string( security_parameters.makeSnmpChunk() ) );
+        message.addChild( message_data );
+        auto datagram = message.makeSnmpChunk();
+
+        if ( flags & Usm::FLAG_AUTH ) {
+            const auto key = UsmCache::localizedKey( auth_password, engine_id );
+            const auto digest = QMessageAuthenticationCode::hash( datagram, key, QCryptographicHash::Sha1 );
+            datagram.replace( authOffset( datagram ), 12, digest.left( 12 ) );
+        }
+        return datagram;
+    }
+
+    QtSnmpData makePdu( const int type,
+                        const int request_id,
+                        const QtSnmpDataList& values )
+    {
+        auto var_bind_list = QtSnmpData::sequence();
+        for ( const auto& value : values ) {
+            auto var_bind = QtSnmpData::sequence();
+            var_bind.addChild( QtSnmpData::oid( value.address() ) );
+            var_bind.addChild( value );
+            var_bind_list.addChild( var_bind );
+        }
+
+        auto pdu = QtSnmpData( type );
+        pdu.addChild( QtSnmpData::integer( request_id ) );
+        pdu.addChild( QtSnmpData::integer( 0 ) );
+        pdu.addChild( QtSnmpData::integer( 0 ) );
+        pdu.addChild( var_bind_list );
+        return pdu;
+    }
+
+    QtSnmpData makeReport( const int request_id,
+                           const QByteArray& counter_oid )
+    {
+        auto counter = QtSnmpData::integer( 1 );
+        counter.setAddress( counter_oid );
+        return makePdu( QtSnmpData::REPORT_TYPE, request_id, { counter } );
+    }
+
+    int requestIdOf( const Message& message ) {
+        return message.scoped_pdu.children().at( 2 ).children().at( 0 ).intValue();
+    }
+}
+
+class TestQtSnmpUsm : public QObject {
+    Q_OBJECT
+    QScopedPointer< QUdpSocket > m_socket{ new QUdpSocket };
+    QHostAddress m_client_address;
+    quint16 m_client_port = 0;
+    QList< QByteArray > m_datagrams;
+
+public slots:
+    void onReadyRead() {
+        while ( m_socket->hasPendingDatagrams() ) {
+            QByteArray datagram;
+            datagram.resize( static_cast< int >( m_socket->pendingDatagramSize() ) );
+            m_socket->readDatagram( datagram.data(), datagram.size(), &m_client_address, &m_client_port );
+            m_datagrams << datagram;
+        }
+    }
+
+    bool waitForDatagram( const int count ) {
+        const auto timestamp = steady_clock::now();
+        while ( ( m_datagrams.size() < count ) && ( steady_clock::now() - timestamp < seconds{2} ) ) {
+            QTest::qWait( default_delay_ms.count() );
+        }
+        return m_datagrams.size() == count;
+    }
+
+    void configure( QtSnmpClient*const client ) {
+        client->setAgentAddress( QHostAddress::LocalHost );
+        client->setAgentPort( TestPort );
+        client->setProtocolVersion( QtSnmpClient::SNMPv3 );
+        client->setUserName( user_name );
+        client->setSecurityLevel( QtSnmpClient::AuthPriv );
+        client->setAuthPassword( auth_password );
+        client->setPrivPassword( priv_password );
+    }
+
+private slots:
+    void initTestCase() {
+        QVERIFY( connect( m_socket.data(), SIGNAL(readyRead()), SLOT(onReadyRead()) ) );
+        QVERIFY( m_socket->bind( QHostAddress::LocalHost, TestPort ) );
+    }
+
+    void cleanup() {
+        m_datagrams.clear();
+    }
+
+    void testKeyLocalization() {
+        // NOTE: RFC 3414 A.3.2
+        const auto engine = QByteArray::fromHex( "000000000000000000000002" );
+        const auto expected = QByteArray::fromHex( "6695febc9288e36282235fc7151f128497b38f3f" );
+        QCOMPARE( UsmCache::localizedKey( "maplesyrup", engine ), expected );
+        QCOMPARE( UsmCache::localizedKey( "maplesyrup", engine ), expected );
+        QVERIFY( UsmCache::localizedKey( "maplesyrup", engine_id ) != expected );
+    }
+
+    void testAesCipher() {
+        // NOTE: FIPS-197 C.1
+        quint8 key[ Aes128::KEY_SIZE ];
+        quint8 block[ Aes128::BLOCK_SIZE ];
+        for ( int i = 0; i < Aes128::BLOCK_SIZE; ++i ) {
+            key[ i ] = static_cast< quint8 >( i );
+            block[ i ] = static_cast< quint8 >( ( i << 4 ) | i );
+        }
+        Aes128 cipher;
+        cipher.setKey( key );
+        cipher.encryptBlock( block, block );
+        QCOMPARE( QByteArray( reinterpret_cast< const char* >( block ), Aes128::BLOCK_SIZE ),
+                  QByteArray::fromHex( "69c4e0d86a7b0430d8cdb78070b4c55a" ) );
+
+        // NOTE: SP 800-38A F.3.13 (the partial last block is the CFB-128 stream cipher case)
+        const auto cfb_key = QByteArray::fromHex( "2b7e151628aed2a6abf7158809cf4f3c" );
+        const auto iv = QByteArray::fromHex( "000102030405060708090a0b0c0d0e0f" );
+        const auto plain_text = QByteArray::fromHex( "6bc1bee22e409f96e93d7e117393172aae2d8a57" );
+        cipher.setKey( reinterpret_cast< const quint8* >( cfb_key.constData() ) );
+        QByteArray cipher_text( plain_text.size(), '\x0' );
+        cipher.cfbEncrypt( reinterpret_cast< const quint8* >( iv.constData() ),
+                           reinterpret_cast< const quint8* >( plain_text.constData() ),
+                           plain_text.size(),
+                           reinterpret_cast< quint8* >( cipher_text.data() ) );
+        QCOMPARE( cipher_text, QByteArray::fromHex( "3b3fd92eb72dad20333449f8e83cfb4ac8a64537" ) );
+        cipher.cfbDecrypt( reinterpret_cast< const quint8* >( iv.constData() ),
+                           reinterpret_cast< const quint8* >( cipher_text.constData() ),
+                           cipher_text.size(),
+                           reinterpret_cast< quint8* >( cipher_text.data() ) );
+        QCOMPARE( cipher_text, plain_text );
+    }
+
+    void testAuthPrivRequest() {
+        QtSnmpClient client;
+        configure( &client );
+
+        int response_count = 0;
+        QtSnmpDataList response_list;
+        connect( &client,
+                 &QtSnmpClient::responseReceived,
+                 [&]( const qint32, const QtSnmpDataList& list )
+        {
+            ++response_count;
+            response_list = list;
+        });
+
+        const auto oid = QByteArray( ".1.3.6.1.2.1.1.5.0" );
+        client.requestValue( oid );
+
+        // engine discovery
+        QVERIFY( waitForDatagram( 1 ) );
+        Message discovery;
+        QVERIFY( parseMessage( m_datagrams.at( 0 ), &discovery ) );
+        QCOMPARE( discovery.flags, static_cast< int >( Usm::FLAG_REPORTABLE ) );
+        QVERIFY( discovery.security_parameters.at( 0 ).data().isEmpty() );
+        const auto discovery_pdu = discovery.scoped_pdu.children().at( 2 );
+        QVERIFY( discovery_pdu.children().at( 3 ).children().empty() );
+
+        const auto report = makeReport( requestIdOf( discovery ), unknown_engine_ids_oid );
+        m_socket->writeDatagram( makeAgentMessage( discovery.msg_id, 0, report ),
+                                 m_client_address,
+                                 m_client_port );
+
+        // time synchronization: the unauthenticated discovery gives only the engine id
+        QVERIFY( waitForDatagram( 2 ) );
+        Message synchronization;
+        QVERIFY( parseMessage( m_datagrams.at( 1 ), &synchronization ) );
+        QVERIFY( synchronization.authenticated );
+        QCOMPARE( synchronization.security_parameters.at( 0 ).data(), engine_id );
+        QCOMPARE( synchronization.security_parameters.at( 1 ).intValue(), 0 );
+        const auto time_report = makeReport( requestIdOf( synchronization ), not_in_time_window_oid );
+        m_socket->writeDatagram( makeAgentMessage( synchronization.msg_id, Usm::FLAG_AUTH, time_report ),
+                                 m_client_address,
+                                 m_client_port );
+
+        // the actual request
+        QVERIFY( waitForDatagram( 3 ) );
+        Message request;
+        QVERIFY( parseMessage( m_datagrams.at( 2 ), &request ) );
+        QCOMPARE( request.flags, static_cast< int >( Usm::FLAG_AUTH | Usm::FLAG_PRIV | Usm::FLAG_REPORTABLE ) );
+        QVERIFY( request.authenticated );
+        QCOMPARE( request.security_parameters.at( 0 ).data(), engine_id );
+        QCOMPARE( request.security_parameters.at( 1 ).intValue(), engine_boots );
+        QVERIFY( request.security_parameters.at( 2 ).intValue() >= engine_time );
+        QCOMPARE( request.security_parameters.at( 3 ).data(), user_name );
+        const auto get_pdu = request.scoped_pdu.children().at( 2 );
+        QCOMPARE( get_pdu.type(), static_cast< int >( QtSnmpData::GET_REQUEST_TYPE ) );
+        const auto var_bind = get_pdu.children().at( 3 ).children().at( 0 );
+        QCOMPARE( var_bind.children().at( 0 ).data(), oid );
+
+        auto value = QtSnmpData::string( "agent-name" );
+        value.setAddress( oid );
+        const auto response = makePdu( QtSnmpData::GET_RESPONSE_TYPE,
+                                       get_pdu.children().at( 0 ).intValue(),
+                                       { value } );
+        m_socket->writeDatagram( makeAgentMessage( request.msg_id,
+                                                   Usm::FLAG_AUTH | Usm::FLAG_PRIV,
+                                                   response ),
+                                 m_client_address,
+                                 m_client_port );
+
+        const auto timestamp = steady_clock::now();
+        while ( !response_count && ( steady_clock::now() - timestamp < seconds{2} ) ) {
+            QTest::qWait( default_delay_ms.count() );
+        }
+        QCOMPARE( response_count, 1 );
+        QVERIFY( response_list.size() == 1 );
+        QCOMPARE( response_list.at( 0 ).address(), oid );
+        QCOMPARE( response_list.at( 0 ).data(), QByteArray( "agent-name" ) );
+        QCOMPARE( client.isBusy(), false );
+    }
+
+    void testKnownEngineSkipsDiscovery() {
+        // NOTE: the engine of the agent is known since the previous test
+        QtSnmpClient client;
+        configure( &client );
+        client.requestValue( ".1.3.6.1.2.1.1.3.0" );
+
+        QVERIFY( waitForDatagram( 1 ) );
+        Message request;
+        QVERIFY( parseMessage( m_datagrams.at( 0 ), &request ) );
+        QVERIFY( request.authenticated );
+        QCOMPARE( request.security_parameters.at( 0 ).data(), engine_id );
+    }
+
+    void testSpoofedReport() {
+        QtSnmpClient client;
+        configure( &client );
+        client.setReponseTimeout( 500 );
+        client.requestValue( ".1.3.6.1.2.1.1.3.0" );
+
+        QVERIFY( waitForDatagram( 1 ) );
+        Message request;
+        QVERIFY( parseMessage( m_datagrams.at( 0 ), &request ) );
+
+        // NOTE: the unauthenticated reports match the request, but they
+        //       neither replace the known engine nor move its clock
+        const auto spoofed_engine_id = QByteArray::fromHex( "80001f8804" ) + "spoofed";
+        const auto unknown_engine = makeReport( requestIdOf( request ), unknown_engine_ids_oid );
+        m_socket->writeDatagram( makeAgentMessage( request.msg_id, 0, unknown_engine,
+                                                   0, 0, spoofed_engine_id ),
+                                 m_client_address,
+                                 m_client_port );
+        const auto time_report = makeReport( requestIdOf( request ), not_in_time_window_oid );
+        m_socket->writeDatagram( makeAgentMessage( request.msg_id, 0, time_report,
+                                                   engine_boots + 1, 0 ),
+                                 m_client_address,
+                                 m_client_port );
+
+        // the request is retransmitted after its timeout, not sent again at once
+        QTest::qWait( 200 );
+        QCOMPARE( m_datagrams.size(), 1 );
+        QVERIFY( waitForDatagram( 2 ) );
+        Message retransmission;
+        QVERIFY( parseMessage( m_datagrams.at( 1 ), &retransmission ) );
+        QVERIFY( retransmission.authenticated );
+        QCOMPARE( retransmission.security_parameters.at( 0 ).data(), engine_id );
+        QCOMPARE( retransmission.security_parameters.at( 1 ).intValue(), engine_boots );
+
+        UsmCache::EngineState state;
+        QVERIFY( UsmCache::findEngine( agent_key, &state ) );
+        QCOMPARE( state.engine_id, engine_id );
+        QCOMPARE( state.boots, engine_boots );
+    }
+
+    void testReplayedResponse() {
+        QtSnmpClient client;
+        configure( &client );
+        client.setReponseTimeout( 500 );
+
+        int response_count = 0;
+        connect( &client,
+                 &QtSnmpClient::responseReceived,
+                 [&]( const qint32, const QtSnmpDataList& ) { ++response_count; } );
+
+        const auto oid = QByteArray( ".1.3.6.1.2.1.1.5.0" );
+        client.requestValue( oid );
+        QVERIFY( waitForDatagram( 1 ) );
+        Message request;
+        QVERIFY( parseMessage( m_datagrams.at( 0 ), &request ) );
+
+        auto value = QtSnmpData::string( "agent-name" );
+        value.setAddress( oid );
+        const auto response = makePdu( QtSnmpData::GET_RESPONSE_TYPE, requestIdOf( request ), { value } );
+
+        // NOTE: a recorded response of the same request id is authenticated,
+        //       but it is behind the time window of the engine (RFC 3414 3.2.7.b)
+        const int flags = Usm::FLAG_AUTH | Usm::FLAG_PRIV;
+        m_socket->writeDatagram( makeAgentMessage( request.msg_id, flags, response,
+                                                   engine_boots, engine_time - 151 ),
+                                 m_client_address,
+                                 m_client_port );
+        m_socket->writeDatagram( makeAgentMessage( request.msg_id, flags, response,
+                                                   engine_boots - 1, engine_time ),
+                                 m_client_address,
+                                 m_client_port );
+        QTest::qWait( 200 );
+        QCOMPARE( response_count, 0 );
+        QVERIFY( client.isBusy() );
+
+        // the actual response is still accepted
+        m_socket->writeDatagram( makeAgentMessage( request.msg_id, flags, response ),
+                                 m_client_address,
+                                 m_client_port );
+        QTRY_COMPARE( response_count, 1 );
+        QCOMPARE( client.isBusy(), false );
+
+        // and its replay is not a response to the next request
+        const auto replay = makeAgentMessage( request.msg_id, flags, response );
+        client.requestValue( oid );
+        QVERIFY( waitForDatagram( 2 ) );
+        m_socket->writeDatagram( replay, m_client_address, m_client_port );
+        QTest::qWait( 200 );
+        QCOMPARE( response_count, 1 );
+        QVERIFY( client.isBusy() );
+    }
+};
+
+QTEST_MAIN( TestQtSnmpUsm )
+#include "tsta_qtsnmpclient_usm.moc"
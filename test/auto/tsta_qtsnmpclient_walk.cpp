@@ -0,0 +1,54 @@
+#include <QTest>
+#include <QDebug>
+#include "WalkCursor.h"
+
+using namespace qtsnmpclient;
+
+namespace {
+    QtSnmpData makeValue( const QByteArray& oid,
+                          const int type = QtSnmpData::INTEGER_TYPE )
+    {
+        QtSnmpData value( type );
+        value.setAddress( oid );
+        return value;
+    }
+}
+
+class TestWalkCursor : public QObject {
+    Q_OBJECT
+private slots:
+    void testOrder() {
+        WalkCursor cursor( ".1.3.6.1.2.1.2.2.1.2" );
+        cursor.start( 0, 0, 0 );
+        QCOMPARE( cursor.step( makeValue( ".1.3.6.1.2.1.2.2.1.2.2" ), 0 ), WalkCursor::NEXT );
+        // NOTE: the arcs are compared as numbers, not as strings
+        QCOMPARE( cursor.step( makeValue( ".1.3.6.1.2.1.2.2.1.2.10" ), 0 ), WalkCursor::NEXT );
+        QCOMPARE( cursor.step( makeValue( ".1.3.6.1.2.1.2.2.1.2.10.1" ), 0 ), WalkCursor::NEXT );
+        QCOMPARE( cursor.step( makeValue( ".1.3.6.1.2.1.2.2.1.2.10.1" ), 0 ), WalkCursor::NOT_INCREASING );
+        QCOMPARE( cursor.step( makeValue( ".1.3.6.1.2.1.2.2.1.2.9" ), 0 ), WalkCursor::NOT_INCREASING );
+        QCOMPARE( cursor.step( makeValue( ".1.3.6.1.2.1.2.2.1.20.1" ), 0 ), WalkCursor::END );
+        QCOMPARE( cursor.step( makeValue( ".1.3.6.1.2.1.2.2.1.2.11", 0x82 ), 0 ), WalkCursor::END );
+
+        std::vector< quint32 > arcs;
+        QVERIFY( WalkCursor::parseOid( "1.3.4294967295", &arcs ) );
+        QCOMPARE( arcs.back(), quint32( 4294967295u ) );
+        QVERIFY( ! WalkCursor::parseOid( "1.3.4294967296", &arcs ) );
+        QVERIFY( ! WalkCursor::parseOid( "1..3", &arcs ) );
+        QVERIFY( ! WalkCursor::parseOid( "1.3.", &arcs ) );
+    }
+
+    void testLimits() {
+        WalkCursor cursor( ".1.3" );
+        cursor.start( 2, 1000, 5000 );
+        QCOMPARE( cursor.step( makeValue( ".1.3.1" ), 5000 ), WalkCursor::NEXT );
+        QCOMPARE( cursor.step( makeValue( ".1.3.2" ), 5000 ), WalkCursor::NEXT );
+        QCOMPARE( cursor.step( makeValue( ".1.3.3" ), 5000 ), WalkCursor::LIMIT_EXCEEDED );
+
+        cursor.start( 0, 1000, 5000 );
+        QCOMPARE( cursor.step( makeValue( ".1.3.1" ), 6000 ), WalkCursor::NEXT );
+        QCOMPARE( cursor.step( makeValue( ".1.3.2" ), 6001 ), WalkCursor::LIMIT_EXCEEDED );
+    }
+};
+
+QTEST_MAIN( TestWalkCursor )
+#include "tsta_qtsnmpclient_walk.moc"
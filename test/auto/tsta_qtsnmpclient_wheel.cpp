@@ -0,0 +1,109 @@
+#include <QTest>
+#include <QDebug>
+#include <random>
+#include "TimerWheel.h"
+
+using namespace qtsnmpclient;
+
+class TestTimerWheel : public QObject {
+    Q_OBJECT
+private slots:
+    void testFireOrder() {
+        TimerWheel wheel( 1000 );
+        std::vector< qint64 > fired;
+        std::vector< qint64 > deadlines;
+        std::mt19937 random( 1 );
+        std::uniform_int_distribution< qint64 > distribution( 0, 20000000 );
+        for ( int i = 0; i < 2000; ++i ) {
+            const qint64 deadline = 1000 + distribution( random );
+            deadlines.push_back( deadline );
+            wheel.add( deadline, [&wheel, &fired, deadline]() {
+                QVERIFY( wheel.currentTime() == deadline + 1 );
+                fired.push_back( deadline );
+            } );
+        }
+        QCOMPARE( wheel.count(), 2000 );
+
+        qint64 now = 1000;
+        while ( wheel.count() > 0 ) {
+            now += 1 + distribution( random ) % 100000;
+            wheel.advance( now );
+            for ( const auto deadline : fired ) {
+                QVERIFY( deadline <= now );
+            }
+        }
+        std::sort( deadlines.begin(), deadlines.end() );
+        QVERIFY( fired == deadlines );
+    }
+
+    void testCancelAndReschedule() {
+        TimerWheel wheel;
+        int fired = 0;
+        const auto first = wheel.add( 10, [&fired]() { ++fired; } );
+        const auto second = wheel.add( 5000, [&fired]() { fired += 10; } );
+        QVERIFY( wheel.cancel( first ) );
+        QVERIFY( ! wheel.cancel( first ) );
+        QVERIFY( wheel.isActive( second ) );
+
+        // a timer added by a callback for the past fires in the same advance
+        wheel.add( 20, [&wheel, &fired]() {
+            ++fired;
+            wheel.add( 0, [&fired]() { fired += 100; } );
+        } );
+        // NOTE: the cancelled timer may still wake up the owner earlier
+        QVERIFY( wheel.nextWakeUp() <= 20 );
+        wheel.advance( 100 );
+        QCOMPARE( fired, 101 );
+        QVERIFY( wheel.nextWakeUp() > 100 );
+        QVERIFY( wheel.nextWakeUp() <= 5000 );
+
+        wheel.advance( 4999 );
+        QCOMPARE( fired, 101 );
+        wheel.advance( 5000 );
+        QCOMPARE( fired, 111 );
+        QCOMPARE( wheel.nextWakeUp(), qint64( -1 ) );
+    }
+
+    void testFarDeadline() {
+        TimerWheel wheel;
+        bool is_fired = false;
+        const qint64 deadline = 3 * TimerWheel::MAX_DELTA + 7;
+        wheel.add( deadline, [&is_fired]() { is_fired = true; } );
+        wheel.advance( deadline - 1 );
+        QVERIFY( ! is_fired );
+        wheel.advance( deadline );
+        QVERIFY( is_fired );
+    }
+
+    void testManyTimeouts() {
+        // NOTE: the response timeouts of 100k requests in flight,
+        //       most of them are cancelled by the responses
+        TimerWheel wheel;
+        std::minstd_rand random( 1 );
+        const int request_count = 100000;
+        const qint64 timeout = 10000;
+        std::vector< TimerWheel::TimerId > timers;
+        timers.reserve( request_count );
+        int fired = 0;
+        for ( int i = 0; i < request_count; ++i ) {
+            const qint64 now = i / 10;
+            wheel.advance( now );
+            timers.push_back( wheel.add( now + timeout, [&fired]() { ++fired; } ) );
+        }
+        QCOMPARE( wheel.count(), request_count );
+
+        int cancelled = 0;
+        for ( size_t i = 0; i < timers.size(); ++i ) {
+            if ( 0 != ( random() % 10 ) ) {
+                QVERIFY( wheel.cancel( timers.at( i ) ) );
+                ++cancelled;
+            }
+        }
+        wheel.advance( request_count / 10 + timeout );
+        QCOMPARE( fired, request_count - cancelled );
+        QCOMPARE( wheel.count(), 0 );
+    }
+};
+
+QTEST_MAIN( TestTimerWheel )
+#include "tsta_qtsnmpclient_wheel.moc"
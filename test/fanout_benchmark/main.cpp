@@ -0,0 +1,91 @@
+#include <QtSnmpFanOut.h>
+#include <Simulator.h>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QDebug>
+#include <functional>
+
+using namespace qtsnmpsimulator;
+
+namespace {
+
+    const QByteArray walk =
+        ".1.3.6.1.2.1.1.1.0 = STRING: \"Simulated agent\"\n"
+        ".1.3.6.1.2.1.1.3.0 = Timeticks: (123456) 0:20:34.56\n";
+
+} // anonymous namespace
+
+// NOTE: Measures how many agents per second are queried by one fan-out
+//       request of sysUpTime.0. The agents are simulated on the loopback,
+//       every one of them listens to its own port.
+int main( int argc, char** argv ) {
+    QCoreApplication app( argc, argv );
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription( "Measures the fan-out of a request to many simulated agents." );
+    parser.addHelpOption();
+    const QCommandLineOption agents_option( "agents", "The count of simulated agents.", "count", "2000" );
+    const QCommandLineOption port_option( "port", "The first UDP port of the agents.", "port", "40000" );
+    const QCommandLineOption rounds_option( "rounds", "The count of requests to all agents.", "count", "5" );
+    const QCommandLineOption concurrency_option( "concurrency", "The agents with a request in flight.", "count", "256" );
+    parser.addOptions( { agents_option, port_option, rounds_option, concurrency_option } );
+    parser.process( app );
+
+    const int agent_count = parser.value( agents_option ).toInt();
+    const auto first_port = static_cast< quint16 >( parser.value( port_option ).toUInt() );
+    const int round_count = parser.value( rounds_option ).toInt();
+
+    Mib mib;
+    mib.loadWalk( walk );
+    Simulator simulator;
+    simulator.setMib( mib );
+    QString error;
+    if ( ! simulator.start( QHostAddress::LocalHost, first_port, agent_count, &error ) ) {
+        qDebug() << "Unable to start the simulator:" << error;
+        return 1;
+    }
+
+    QtSnmpAgentConfigList configs;
+    for ( int i = 0; i < agent_count; ++i ) {
+        QtSnmpAgentConfig config;
+        config.address = QHostAddress::LocalHost;
+        config.port = simulator.agentPort( i );
+        config.response_timeout = 1000;
+        configs << config;
+    }
+
+    QtSnmpFanOut fan_out;
+    fan_out.setAgents( configs );
+    fan_out.setConcurrency( parser.value( concurrency_option ).toInt() );
+
+    const QtSnmpPreparedRequest request( QStringList( ".1.3.6.1.2.1.1.3.0" ) );
+    QElapsedTimer timer;
+    int round = 0;
+    int batch_count = 0;
+    quint64 total_failed = 0;
+    std::function< void() > startRound;
+    startRound = [&]() {
+        timer.start();
+        batch_count = 0;
+        fan_out.requestValues( request,
+            [&batch_count]( const QtSnmpFanOut::ReplyList&, const int, const int ) { ++batch_count; },
+            [&]( const int succeeded, const int failed ) {
+                const auto elapsed = timer.nsecsElapsed();
+                total_failed += static_cast< quint64 >( failed );
+                qDebug() << "round" << round + 1 << ":"
+                         << succeeded << "succeeded," << failed << "failed,"
+                         << batch_count << "batches,"
+                         << elapsed / 1000000.0 << "ms,"
+                         << ( elapsed > 0 ? agent_count * 1e9 / elapsed : 0.0 ) << "agents/s";
+                if ( ++round < round_count ) {
+                    QTimer::singleShot( 0, &fan_out, startRound );
+                } else {
+                    app.exit( total_failed ? 2 : 0 );
+                }
+            } );
+    };
+    startRound();
+    return app.exec();
+}
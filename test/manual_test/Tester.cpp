@@ -35,24 +35,32 @@ void Tester::start() {
     m_snmp_client->setAgentAddress( m_address );
     m_snmp_client->setCommunity( "public" );
 
-    connect( m_snmp_client.data(),
-             SIGNAL(responseReceived(qint32,QtSnmpDataList)),
-             SLOT(onResponseReceived(qint32,QtSnmpDataList)) );
-    connect( m_snmp_client.data(),
-             SIGNAL(requestFailed(qint32)),
-             SLOT(onRequestFailed(qint32)) );
+    assert( m_scheduler.isNull() );
+    m_scheduler.reset( new QtSnmpPollScheduler );
+    connect( m_scheduler.data(),
+             SIGNAL(pollResultReady(int,QtSnmpDataListPtr)),
+             SLOT(onPollResultReady(int,QtSnmpDataListPtr)) );
+    connect( m_scheduler.data(),
+             SIGNAL(pollFailed(int)),
+             SLOT(onPollFailed(int)) );
+    connect( m_scheduler.data(),
+             SIGNAL(cycleOverrun(int)),
+             SLOT(onCycleOverrun(int)) );
 
-    assert( m_timer.isNull() );
-    m_timer.reset( new QTimer );
-    connect( m_timer.data(), SIGNAL(timeout()), SLOT(makeRequest()) );
-    m_timer->start( 500 + ( rand() % 1000 ) );
+    const int interval = 1000;
+    m_scheduler->addPoll( m_snmp_client.data(), { sysDescr_OID }, interval );
+    m_scheduler->addPoll( m_snmp_client.data(), { sysUpTimeInstance_OID, sysName_OID }, interval );
+    m_scheduler->addPoll( m_snmp_client.data(),
+                          { ifIndex_OID, ifName_OID, ifDescr_OID, ifPhysAddress_OID },
+                          interval,
+                          QtSnmpPollScheduler::WalkPoll );
 }
 
-void Tester::onResponseReceived( const qint32,
-                                 const QtSnmpDataList& values )
+void Tester::onPollResultReady( const int,
+                                const QtSnmpDataListPtr& values )
 {
     assert( QThread::currentThread() == thread() );
-    for ( const auto& value : values ) {
+    for ( const auto& value : *values ) {
         printf( "%s | %s : %s\n",
                 qPrintable( m_address.toString() ),
                 qPrintable( value.address() ),
@@ -60,21 +68,13 @@ void Tester::onResponseReceived( const qint32,
     }
 }
 
-void Tester::onRequestFailed( const qint32 request_id ) {
+void Tester::onPollFailed( const int poll_id ) {
     assert( QThread::currentThread() == thread() );
-    qDebug() << m_address << request_id;
-    assert( !request_id );
+    qDebug() << m_address << "poll" << poll_id << "failed";
 }
 
-void Tester::makeRequest() {
+void Tester::onCycleOverrun( const int poll_id ) {
     assert( QThread::currentThread() == thread() );
-    if ( ! m_snmp_client->isBusy() ) {
-        m_snmp_client->requestValue( sysDescr_OID );
-        m_snmp_client->requestValues( QStringList() << sysUpTimeInstance_OID << sysName_OID );
-        m_snmp_client->requestSubValues( ifIndex_OID );
-        m_snmp_client->requestSubValues( ifName_OID );
-        m_snmp_client->requestSubValues( ifDescr_OID );
-        m_snmp_client->requestSubValues( ifPhysAddress_OID );
-    }
+    qDebug() << m_address << "poll" << poll_id << "overrun";
 }
 
@@ -4,7 +4,7 @@
 #include <QScopedPointer>
 #include <QMap>
 #include <QtSnmpClient.h>
-#include <QTimer>
+#include <QtSnmpPollScheduler.h>
 
 class Tester : public QObject {
     Q_OBJECT
@@ -15,14 +15,14 @@ public:
     Q_SLOT void start();
 
 private:
-    Q_SLOT void onResponseReceived( const qint32 request_id,
-                                    const QtSnmpDataList& );
-    Q_SLOT void onRequestFailed( const qint32 request_id );
-    Q_SLOT void makeRequest();
+    Q_SLOT void onPollResultReady( const int poll_id,
+                                   const QtSnmpDataListPtr& );
+    Q_SLOT void onPollFailed( const int poll_id );
+    Q_SLOT void onCycleOverrun( const int poll_id );
 
 private:
     const QHostAddress m_address;
     QScopedPointer< QtSnmpClient > m_snmp_client;
-    QScopedPointer< QTimer > m_timer;
+    QScopedPointer< QtSnmpPollScheduler > m_scheduler;
 
 };
@@ -0,0 +1,314 @@
+#include "Mib.h"
+#include <QFile>
+#include <QHostAddress>
+#include <QList>
+
+namespace qtsnmpsimulator {
+
+namespace {
+    QByteArray unsignedData( quint64 value ) {
+        QByteArray data;
+        do {
+            data.prepend( static_cast< char >( value & 0xFF ) );
+            value >>= 8;
+        } while ( value );
+        return data;
+    }
+
+    QByteArray firstToken( const QByteArray& text ) {
+        const auto trimmed = text.trimmed();
+        const int end = trimmed.indexOf( ' ' );
+        return ( -1 == end ) ? trimmed : trimmed.left( end );
+    }
+
+    QByteArray parenthesized( const QByteArray& text ) {
+        const int begin = text.indexOf( '(' );
+        const int end = text.indexOf( ')', begin + 1 );
+        if ( ( -1 == begin ) || ( -1 == end ) ) {
+            return {};
+        }
+        return text.mid( begin + 1, end - begin - 1 );
+    }
+
+    QByteArray unquoted( const QByteArray& text ) {
+        if ( ( text.size() < 2 ) || ! text.startsWith( '"' ) || ! text.endsWith( '"' ) ) {
+            return text;
+        }
+
+        QByteArray result;
+        result.reserve( text.size() );
+        for ( int i = 1; i < text.size() - 1; ++i ) {
+            if ( ( '\\' == text.at( i ) ) && ( i + 1 < text.size() - 1 ) ) {
+                ++i;
+            }
+            result.append( text.at( i ) );
+        }
+        return result;
+    }
+
+    QByteArray normalizedOid( const QByteArray& oid ) {
+        if ( oid.startsWith( "iso." ) ) {
+            return ".1" + oid.mid( 3 );
+        }
+        if ( oid.startsWith( "1." ) ) {
+            return "." + oid;
+        }
+        return oid;
+    }
+
+    bool isRecordBegin( const QByteArray& line ) {
+        return ( line.startsWith( '.' ) || line.startsWith( "iso." ) ) && line.contains( " = " );
+    }
+
+    bool hasOpenQuote( const QByteArray& record ) {
+        const int value_begin = record.indexOf( " = " );
+        bool is_open = false;
+        for ( int i = value_begin + 3; i < record.size(); ++i ) {
+            if ( '\\' == record.at( i ) ) {
+                ++i;
+            } else if ( '"' == record.at( i ) ) {
+                is_open = ! is_open;
+            }
+        }
+        return is_open;
+    }
+}
+
+bool Mib::loadWalkFile( const QString& file_name,
+                        QString*const error )
+{
+    QFile file( file_name );
+    if ( ! file.open( QIODevice::ReadOnly ) ) {
+        if ( error ) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    loadWalk( file.readAll() );
+    return true;
+}
+
+void Mib::loadWalk( const QByteArray& text ) {
+    // NOTE: a quoted string value may occupy several lines
+    QByteArray record;
+    auto flush = [this, &record]() {
+        if ( record.isEmpty() ) {
+            return;
+        }
+        QByteArray oid;
+        QtSnmpData value;
+        if ( parseWalkLine( record, &oid, &value ) ) {
+            insert( oid, value );
+        } else {
+            ++m_skipped_line_count;
+        }
+        record.clear();
+    };
+
+    for ( const auto& raw_line : text.split( '\n' ) ) {
+        const auto line = raw_line.endsWith( '\r' ) ? raw_line.left( raw_line.size() - 1 ) : raw_line;
+        if ( ! record.isEmpty() && hasOpenQuote( record ) ) {
+            record += '\n' + line;
+        } else if ( isRecordBegin( line ) ) {
+            flush();
+            record = line;
+        } else {
+            flush();
+            if ( ! line.trimmed().isEmpty() ) {
+                ++m_skipped_line_count;
+            }
+        }
+    }
+    flush();
+}
+
+void Mib::insert( const QByteArray& oid,
+                  const QtSnmpData& value )
+{
+    OidArcs arcs;
+    if ( parseOid( oid, &arcs ) ) {
+        auto item = value;
+        item.setAddress( oidText( arcs ) );
+        m_values[ arcs ] = item;
+    }
+}
+
+void Mib::clear() {
+    m_values.clear();
+    m_skipped_line_count = 0;
+}
+
+size_t Mib::size() const {
+    return m_values.size();
+}
+
+int Mib::skippedLineCount() const {
+    return m_skipped_line_count;
+}
+
+bool Mib::find( const QByteArray& oid,
+                QtSnmpData*const value ) const
+{
+    Q_ASSERT( value );
+    OidArcs arcs;
+    if ( ! parseOid( oid, &arcs ) ) {
+        return false;
+    }
+
+    const auto iter = m_values.find( arcs );
+    if ( m_values.end() == iter ) {
+        return false;
+    }
+    *value = iter->second;
+    return true;
+}
+
+bool Mib::findNext( const QByteArray& oid,
+                    QtSnmpData*const value ) const
+{
+    Q_ASSERT( value );
+    OidArcs arcs;
+    if ( ! parseOid( oid, &arcs ) ) {
+        return false;
+    }
+
+    const auto iter = m_values.upper_bound( arcs );
+    if ( m_values.end() == iter ) {
+        return false;
+    }
+    *value = iter->second;
+    return true;
+}
+
+bool Mib::update( const QByteArray& oid,
+                  const QtSnmpData& value )
+{
+    OidArcs arcs;
+    if ( ! parseOid( oid, &arcs ) ) {
+        return false;
+    }
+
+    const auto iter = m_values.find( arcs );
+    if ( m_values.end() == iter ) {
+        return false;
+    }
+    auto item = value;
+    item.setAddress( iter->second.address() );
+    iter->second = item;
+    return true;
+}
+
+bool Mib::parseOid( const QByteArray& oid,
+                    OidArcs*const arcs ) // static
+{
+    Q_ASSERT( arcs );
+    arcs->clear();
+    const auto text = normalizedOid( oid.trimmed() );
+    if ( ! text.startsWith( '.' ) ) {
+        return false;
+    }
+
+    arcs->reserve( static_cast< size_t >( text.count( '.' ) ) );
+    for ( const auto& part : text.mid( 1 ).split( '.' ) ) {
+        bool ok = false;
+        const auto arc = part.toUInt( &ok );
+        if ( ! ok ) {
+            return false;
+        }
+        arcs->push_back( arc );
+    }
+    return arcs->size() >= 2;
+}
+
+QByteArray Mib::oidText( const OidArcs& arcs ) { // static
+    QByteArray text;
+    text.reserve( static_cast< int >( 4 * arcs.size() ) );
+    for ( const auto arc : arcs ) {
+        text += '.' + QByteArray::number( arc );
+    }
+    return text;
+}
+
+bool Mib::parseWalkLine( const QByteArray& line,
+                         QByteArray*const oid,
+                         QtSnmpData*const value ) // static
+{
+    Q_ASSERT( oid && value );
+    const int separator = line.indexOf( " = " );
+    if ( -1 == separator ) {
+        return false;
+    }
+
+    *oid = normalizedOid( line.left( separator ).trimmed() );
+    const auto content = line.mid( separator + 3 ).trimmed();
+    if ( content.startsWith( '"' ) ) {
+        *value = QtSnmpData::string( unquoted( content ) );
+        return true;
+    }
+
+    if ( "NULL" == content ) {
+        *value = QtSnmpData::null();
+        return true;
+    }
+
+    const int type_end = content.indexOf( ':' );
+    if ( -1 == type_end ) {
+        return false;
+    }
+
+    const auto type = content.left( type_end );
+    const auto text = content.mid( type_end + 1 ).trimmed();
+    bool ok = false;
+    if ( "STRING" == type ) {
+        *value = QtSnmpData::string( unquoted( text ) );
+        return true;
+    } else if ( ( "Hex-STRING" == type ) || ( "BITS" == type ) ) {
+        QByteArray hex;
+        for ( const auto& item : text.split( ' ' ) ) {
+            if ( 2 != item.size() ) {
+                break; // for
+            }
+            hex += item;
+        }
+        *value = QtSnmpData::string( QByteArray::fromHex( hex ) );
+        return true;
+    } else if ( "INTEGER" == type ) {
+        const auto number = text.contains( '(' ) ? parenthesized( text ) : firstToken( text );
+        const auto result = number.toInt( &ok );
+        *value = QtSnmpData::integer( result );
+    } else if ( ( "Counter32" == type ) || ( "Gauge32" == type ) || ( "Unsigned32" == type ) ) {
+        const auto result = firstToken( text ).toUInt( &ok );
+        *value = QtSnmpData( ( "Counter32" == type ) ? QtSnmpData::COUNTER_TYPE
+                                                     : QtSnmpData::GAUGE_TYPE,
+                             unsignedData( result ) );
+    } else if ( "Counter64" == type ) {
+        const auto result = firstToken( text ).toULongLong( &ok );
+        auto data = unsignedData( result );
+        if ( data.at( 0 ) & 0x80 ) {
+            data.prepend( '\x0' ); // NOTE: it is written as is, so BER needs it
+        }
+        *value = QtSnmpData( QtSnmpData::COUNTER64_TYPE, data );
+    } else if ( "Timeticks" == type ) {
+        const auto result = parenthesized( text ).toUInt( &ok );
+        *value = QtSnmpData( QtSnmpData::TIME_TICKS_TYPE, unsignedData( result ) );
+    } else if ( "OID" == type ) {
+        const auto value_oid = normalizedOid( text );
+        OidArcs arcs;
+        ok = parseOid( value_oid, &arcs );
+        *value = QtSnmpData::oid( value_oid );
+    } else if ( "IpAddress" == type ) {
+        const QHostAddress address( QString::fromLatin1( text ) );
+        ok = ( QAbstractSocket::IPv4Protocol == address.protocol() );
+        const quint32 ip = address.toIPv4Address();
+        QByteArray data;
+        data.append( static_cast< char >( ( ip >> 24 ) & 0xFF ) );
+        data.append( static_cast< char >( ( ip >> 16 ) & 0xFF ) );
+        data.append( static_cast< char >( ( ip >> 8 ) & 0xFF ) );
+        data.append( static_cast< char >( ip & 0xFF ) );
+        *value = QtSnmpData( QtSnmpData::IP_ADDR_TYPE, data );
+    }
+
+    return ok;
+}
+
+} // namespace qtsnmpsimulator
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QtSnmpData.h>
+#include <QByteArray>
+#include <QString>
+#include <map>
+#include <vector>
+
+namespace qtsnmpsimulator {
+
+typedef std::vector< quint32 > OidArcs;
+
+// NOTE: An ordered set of object instances of a simulated agent.
+//       The instances are ordered arc by arc as an agent does it
+//       for the GetNext request, but not as strings.
+class Mib {
+public:
+    bool loadWalkFile( const QString& file_name,
+                       QString*const error = nullptr );
+
+    // NOTE: The text is expected in the numeric snmpwalk format (snmpwalk -On),
+    //       the 'iso.' prefix is accepted too. Unsupported lines are skipped.
+    void loadWalk( const QByteArray& text );
+
+    void insert( const QByteArray& oid,
+                 const QtSnmpData& value );
+    void clear();
+
+    size_t size() const;
+    int skippedLineCount() const;
+
+    bool find( const QByteArray& oid,
+               QtSnmpData*const value ) const;
+    bool findNext( const QByteArray& oid,
+                   QtSnmpData*const value ) const;
+    bool update( const QByteArray& oid,
+                 const QtSnmpData& value );
+
+    static bool parseOid( const QByteArray& oid,
+                          OidArcs*const arcs );
+    static QByteArray oidText( const OidArcs& arcs );
+    static bool parseWalkLine( const QByteArray& line,
+                               QByteArray*const oid,
+                               QtSnmpData*const value );
+
+private:
+    std::map< OidArcs, QtSnmpData > m_values;
+    int m_skipped_line_count = 0;
+};
+
+} // namespace qtsnmpsimulator
@@ -0,0 +1,417 @@
+#include "Simulator.h"
+
+namespace qtsnmpsimulator {
+
+namespace {
+    const int GET_BULK_REQUEST_TYPE = 0xA5;
+    const int NO_SUCH_OBJECT_TYPE = 0x80;
+    const int NO_SUCH_INSTANCE_TYPE = 0x81;
+    const int END_OF_MIB_VIEW_TYPE = 0x82;
+
+    enum ErrorStatus {
+        NO_ERROR = 0,
+        TOO_BIG = 1,
+        NO_SUCH_NAME = 2,
+        NO_CREATION = 11,
+    };
+
+    const int SNMP_V1 = 0;
+
+    QtSnmpDataList pduChildren( const QtSnmpData& pdu ) {
+        // NOTE: QtSnmpData doesn't know GetBulk as a container
+        if ( pdu.children().empty() ) {
+            QtSnmpDataList children;
+            QtSnmpData::parseData( pdu.data(), &children );
+            return children;
+        }
+        return pdu.children();
+    }
+
+    QtSnmpData varBind( const QByteArray& oid,
+                        const QtSnmpData& value )
+    {
+        auto var_bind = QtSnmpData::sequence();
+        var_bind.addChild( QtSnmpData::oid( oid ) );
+        var_bind.addChild( value );
+        return var_bind;
+    }
+
+    QByteArray packResponse( const int version,
+                             const QByteArray& community,
+                             const int request_id,
+                             const int error_status,
+                             const int error_index,
+                             const QtSnmpData& var_bind_list )
+    {
+        auto pdu = QtSnmpData( QtSnmpData::GET_RESPONSE_TYPE );
+        pdu.addChild( QtSnmpData::integer( request_id ) );
+        pdu.addChild( QtSnmpData::integer( error_status ) );
+        pdu.addChild( QtSnmpData::integer( error_index ) );
+        pdu.addChild( var_bind_list );
+
+        auto message = QtSnmpData::sequence();
+        message.addChild( QtSnmpData::integer( version ) );
+        message.addChild( QtSnmpData::string( community ) );
+        message.addChild( pdu );
+        return message.makeSnmpChunk();
+    }
+}
+
+Simulator::Simulator( QObject*const parent )
+    : QObject( parent )
+    , m_mib( std::make_shared< Mib >() )
+{
+    m_timer.setSingleShot( true );
+    m_timer.setTimerType( Qt::PreciseTimer );
+    connect( &m_timer, SIGNAL(timeout()), SLOT(sendDueResponses()) );
+    m_clock.start();
+}
+
+Simulator::~Simulator() {
+    stop();
+}
+
+void Simulator::setMib( const Mib& mib ) {
+    m_mib = std::make_shared< Mib >( mib );
+    for ( auto& agent : m_agents ) {
+        agent.mib = m_mib;
+    }
+}
+
+bool Simulator::loadWalkFile( const QString& file_name,
+                              QString*const error )
+{
+    Mib mib;
+    if ( ! mib.loadWalkFile( file_name, error ) ) {
+        return false;
+    }
+    setMib( mib );
+    return true;
+}
+
+AgentConfig Simulator::config() const {
+    return m_config;
+}
+
+void Simulator::setConfig( const AgentConfig& config ) {
+    m_config = config;
+    for ( auto& agent : m_agents ) {
+        agent.config = config;
+    }
+}
+
+void Simulator::setAgentConfig( const int agent,
+                                const AgentConfig& config )
+{
+    Q_ASSERT( ( agent >= 0 ) && ( agent < agentCount() ) );
+    m_agents.at( static_cast< size_t >( agent ) ).config = config;
+}
+
+void Simulator::setSeed( const quint32 seed ) {
+    m_random.seed( seed );
+}
+
+bool Simulator::start( const QHostAddress& address,
+                       const quint16 first_port,
+                       const int agent_count,
+                       QString*const error )
+{
+    Q_ASSERT( agent_count > 0 );
+    stop();
+    m_agents.reserve( static_cast< size_t >( agent_count ) );
+    for ( int i = 0; i < agent_count; ++i ) {
+        Agent agent;
+        agent.socket.reset( new QUdpSocket );
+        agent.mib = m_mib;
+        agent.config = m_config;
+        const auto port = static_cast< quint16 >( first_port + i );
+        if ( ! agent.socket->bind( address, port ) ) {
+            if ( error ) {
+                *error = QString( "Unable to bind %1:%2. Cause: %3" )
+                            .arg( address.toString() )
+                            .arg( port )
+                            .arg( agent.socket->errorString() );
+            }
+            stop();
+            return false;
+        }
+        connect( agent.socket.get(), &QUdpSocket::readyRead,
+                 this, [this, i]() { readDatagrams( i ); } );
+        m_agents.push_back( std::move( agent ) );
+    }
+    return true;
+}
+
+void Simulator::stop() {
+    m_timer.stop();
+    m_pending_responses.clear();
+    m_agents.clear();
+}
+
+int Simulator::agentCount() const {
+    return static_cast< int >( m_agents.size() );
+}
+
+quint16 Simulator::agentPort( const int agent ) const {
+    Q_ASSERT( ( agent >= 0 ) && ( agent < agentCount() ) );
+    return m_agents.at( static_cast< size_t >( agent ) ).socket->localPort();
+}
+
+SimulatorStatistics Simulator::statistics() const {
+    SimulatorStatistics result;
+    result.requests = m_counters[ REQUESTS ];
+    result.responses = m_counters[ RESPONSES ];
+    result.lost = m_counters[ LOST ];
+    result.duplicates = m_counters[ DUPLICATES ];
+    result.reordered = m_counters[ REORDERED ];
+    result.too_big = m_counters[ TOO_BIG ];
+    result.invalid_requests = m_counters[ INVALID_REQUESTS ];
+    return result;
+}
+
+void Simulator::readDatagrams( const int index ) {
+    auto& agent = m_agents.at( static_cast< size_t >( index ) );
+    auto& socket = *agent.socket;
+    while ( socket.hasPendingDatagrams() ) {
+        const int size = static_cast< int >( socket.pendingDatagramSize() );
+        if ( size <= 0 ) {
+            socket.readDatagram( nullptr, 0 );
+            continue;
+        }
+
+        PendingResponse pending;
+        pending.agent = index;
+        QByteArray request( size, '\x0' );
+        if ( size != socket.readDatagram( request.data(), size, &pending.address, &pending.port ) ) {
+            continue;
+        }
+
+        ++m_counters[ REQUESTS ];
+        if ( happens( agent.config.loss_rate ) ) {
+            ++m_counters[ LOST ];
+            continue;
+        }
+
+        if ( ! makeResponse( &agent, request, &pending.datagram ) ) {
+            ++m_counters[ INVALID_REQUESTS ];
+            continue;
+        }
+
+        const auto& config = agent.config;
+        qint64 delay_ms = config.latency_ms;
+        if ( config.jitter_ms > 0 ) {
+            std::uniform_int_distribution< int > jitter( -config.jitter_ms, config.jitter_ms );
+            delay_ms = qMax( qint64( 0 ), delay_ms + jitter( m_random ) );
+        }
+        if ( happens( config.reorder_rate ) ) {
+            ++m_counters[ REORDERED ];
+            delay_ms += config.reorder_delay_ms;
+        }
+        schedule( pending, 1000 * delay_ms );
+        if ( happens( config.duplicate_rate ) ) {
+            ++m_counters[ DUPLICATES ];
+            schedule( pending, 1000 * ( delay_ms + 1 ) );
+        }
+    }
+}
+
+bool Simulator::makeResponse( Agent*const agent,
+                              const QByteArray& request,
+                              QByteArray*const response )
+{
+    QtSnmpDataList message_list;
+    QtSnmpData::parseData( request, &message_list );
+    if ( 1 != message_list.size() ) {
+        return false;
+    }
+
+    const auto& message = message_list.front().children();
+    if ( ( 3 != message.size() ) ||
+         ( QtSnmpData::INTEGER_TYPE != message.at( 0 ).type() ) ||
+         ( QtSnmpData::STRING_TYPE != message.at( 1 ).type() ) )
+    {
+        return false;
+    }
+
+    const int version = message.at( 0 ).intValue();
+    const auto community = message.at( 1 ).data();
+    if ( community != agent->config.community ) {
+        return false;
+    }
+
+    const auto& pdu = message.at( 2 );
+    const auto children = pduChildren( pdu );
+    if ( ( 4 != children.size() ) || ( QtSnmpData::SEQUENCE_TYPE != children.at( 3 ).type() ) ) {
+        return false;
+    }
+
+    const int request_id = children.at( 0 ).intValue();
+    const auto& request_list = children.at( 3 );
+    QtSnmpDataList names;
+    names.reserve( request_list.children().size() );
+    for ( const auto& var_bind : request_list.children() ) {
+        if ( ( 2 != var_bind.children().size() ) ||
+             ( QtSnmpData::OBJECT_TYPE != var_bind.children().at( 0 ).type() ) )
+        {
+            return false;
+        }
+        names.push_back( var_bind.children().at( 0 ) );
+    }
+
+    const bool is_v1 = ( SNMP_V1 == version );
+    auto response_list = QtSnmpData::sequence();
+    auto reply = [&]( const int error_status,
+                      const int error_index,
+                      const QtSnmpData& var_bind_list )
+    {
+        *response = packResponse( version, community, request_id, error_status, error_index, var_bind_list );
+        const int threshold = agent->config.too_big_threshold;
+        if ( ( threshold > 0 ) && ( response->size() > threshold ) ) {
+            ++m_counters[ TOO_BIG ];
+            *response = packResponse( version, community, request_id, TOO_BIG, 0, request_list );
+        }
+        return true;
+    };
+
+    QtSnmpData value;
+    switch ( pdu.type() ) {
+    case QtSnmpData::GET_REQUEST_TYPE:
+        for ( size_t i = 0; i < names.size(); ++i ) {
+            const auto oid = names.at( i ).data();
+            if ( agent->mib->find( oid, &value ) ) {
+                response_list.addChild( varBind( oid, value ) );
+            } else if ( is_v1 ) {
+                return reply( NO_SUCH_NAME, static_cast< int >( i + 1 ), request_list );
+            } else {
+                // NOTE: the instance of a known object would be noSuchInstance
+                const bool is_known = agent->mib->findNext( oid, &value ) &&
+                                      value.address().startsWith( oid.left( oid.lastIndexOf( '.' ) ) + '.' );
+                response_list.addChild( varBind( oid, QtSnmpData( is_known ? NO_SUCH_INSTANCE_TYPE
+                                                                           : NO_SUCH_OBJECT_TYPE ) ) );
+            }
+        }
+        return reply( NO_ERROR, 0, response_list );
+    case QtSnmpData::GET_NEXT_REQUEST_TYPE:
+        for ( size_t i = 0; i < names.size(); ++i ) {
+            const auto oid = names.at( i ).data();
+            if ( agent->mib->findNext( oid, &value ) ) {
+                response_list.addChild( varBind( value.address(), value ) );
+            } else if ( is_v1 ) {
+                return reply( NO_SUCH_NAME, static_cast< int >( i + 1 ), request_list );
+            } else {
+                response_list.addChild( varBind( oid, QtSnmpData( END_OF_MIB_VIEW_TYPE ) ) );
+            }
+        }
+        return reply( NO_ERROR, 0, response_list );
+    case GET_BULK_REQUEST_TYPE: {
+            if ( is_v1 ) {
+                return false;
+            }
+            const int non_repeaters = qBound( 0, children.at( 1 ).intValue(), static_cast< int >( names.size() ) );
+            const int max_repetitions = qMax( 0, children.at( 2 ).intValue() );
+            for ( int i = 0; i < non_repeaters; ++i ) {
+                const auto oid = names.at( static_cast< size_t >( i ) ).data();
+                if ( agent->mib->findNext( oid, &value ) ) {
+                    response_list.addChild( varBind( value.address(), value ) );
+                } else {
+                    response_list.addChild( varBind( oid, QtSnmpData( END_OF_MIB_VIEW_TYPE ) ) );
+                }
+            }
+
+            std::vector< QByteArray > cursors;
+            for ( size_t i = static_cast< size_t >( non_repeaters ); i < names.size(); ++i ) {
+                cursors.push_back( names.at( i ).data() );
+            }
+            for ( int repetition = 0; ( repetition < max_repetitions ) && ! cursors.empty(); ++repetition ) {
+                bool is_finished = true;
+                for ( auto& cursor : cursors ) {
+                    if ( agent->mib->findNext( cursor, &value ) ) {
+                        cursor = value.address();
+                        response_list.addChild( varBind( cursor, value ) );
+                        is_finished = false;
+                    } else {
+                        response_list.addChild( varBind( cursor, QtSnmpData( END_OF_MIB_VIEW_TYPE ) ) );
+                    }
+                }
+                if ( is_finished ) {
+                    break; // for
+                }
+            }
+            return reply( NO_ERROR, 0, response_list );
+        }
+    case QtSnmpData::SET_REQUEST_TYPE:
+        for ( size_t i = 0; i < names.size(); ++i ) {
+            if ( ! agent->mib->find( names.at( i ).data(), &value ) ) {
+                return reply( is_v1 ? NO_SUCH_NAME : NO_CREATION, static_cast< int >( i + 1 ), request_list );
+            }
+        }
+
+        // NOTE: the agent gets its own copy of the MIB on the first change
+        if ( agent->mib.use_count() > 1 ) {
+            agent->mib = std::make_shared< Mib >( *agent->mib );
+        }
+        for ( const auto& var_bind : request_list.children() ) {
+            agent->mib->update( var_bind.children().at( 0 ).data(), var_bind.children().at( 1 ) );
+        }
+        return reply( NO_ERROR, 0, request_list );
+    default: break;
+    }
+    return false;
+}
+
+void Simulator::schedule( const PendingResponse& pending,
+                          const qint64 delay_usecs )
+{
+    if ( delay_usecs <= 0 ) {
+        auto& socket = *m_agents.at( static_cast< size_t >( pending.agent ) ).socket;
+        socket.writeDatagram( pending.datagram, pending.address, pending.port );
+        ++m_counters[ RESPONSES ];
+        return;
+    }
+
+    m_pending_responses.emplace( now() + delay_usecs, pending );
+    updateTimer();
+}
+
+void Simulator::sendDueResponses() {
+    const auto current_time = now();
+    while ( ! m_pending_responses.empty() ) {
+        const auto iter = m_pending_responses.begin();
+        if ( iter->first > current_time ) {
+            break; // while
+        }
+        const auto& pending = iter->second;
+        auto& socket = *m_agents.at( static_cast< size_t >( pending.agent ) ).socket;
+        socket.writeDatagram( pending.datagram, pending.address, pending.port );
+        ++m_counters[ RESPONSES ];
+        m_pending_responses.erase( iter );
+    }
+    updateTimer();
+}
+
+void Simulator::updateTimer() {
+    if ( m_pending_responses.empty() ) {
+        m_timer.stop();
+        return;
+    }
+
+    const auto delay_usecs = m_pending_responses.begin()->first - now();
+    const int delay_ms = static_cast< int >( qMax( qint64( 0 ), ( delay_usecs + 999 ) / 1000 ) );
+    if ( ! m_timer.isActive() || ( m_timer.remainingTime() > delay_ms ) ) {
+        m_timer.start( delay_ms );
+    }
+}
+
+bool Simulator::happens( const double rate ) {
+    if ( rate <= 0 ) {
+        return false;
+    }
+    std::uniform_real_distribution< double > distribution( 0, 1 );
+    return distribution( m_random ) < rate;
+}
+
+qint64 Simulator::now() const {
+    return m_clock.nsecsElapsed() / 1000;
+}
+
+} // namespace qtsnmpsimulator
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Mib.h"
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QTimer>
+#include <QUdpSocket>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace qtsnmpsimulator {
+
+// NOTE: All rates are probabilities from 0 to 1 of an event for a single request.
+struct AgentConfig {
+    QByteArray community = "public";
+    int latency_ms = 0;
+    int jitter_ms = 0;          // the latency is uniformly distributed in [latency - jitter, latency + jitter]
+    double loss_rate = 0;       // a request is silently ignored
+    double reorder_rate = 0;    // a response is delayed by reorder_delay_ms more
+    int reorder_delay_ms = 20;
+    double duplicate_rate = 0;  // a response is sent twice
+    int too_big_threshold = 0;  // the maximal size of a response in bytes, 0 is unlimited
+};
+
+struct SimulatorStatistics {
+    quint64 requests = 0;
+    quint64 responses = 0;
+    quint64 lost = 0;
+    quint64 duplicates = 0;
+    quint64 reordered = 0;
+    quint64 too_big = 0;
+    quint64 invalid_requests = 0;
+};
+
+// NOTE: A set of simulated SNMP (v1/v2c) agents which listen to the successive
+//       UDP ports. All of them serve the same MIB till a SET request changes it
+//       for the particular agent. The simulator works in the thread it belongs to,
+//       its methods (but statistics()) have to be called from that thread.
+class Simulator : public QObject {
+    Q_OBJECT
+    Q_DISABLE_COPY( Simulator )
+public:
+    explicit Simulator( QObject*const parent = nullptr );
+    ~Simulator() override;
+
+    void setMib( const Mib& );
+    bool loadWalkFile( const QString& file_name,
+                       QString*const error = nullptr );
+
+    AgentConfig config() const;
+    void setConfig( const AgentConfig& );
+    void setAgentConfig( const int agent,
+                         const AgentConfig& );
+    void setSeed( const quint32 );
+
+    bool start( const QHostAddress& address,
+                const quint16 first_port,
+                const int agent_count = 1,
+                QString*const error = nullptr );
+    void stop();
+
+    int agentCount() const;
+    quint16 agentPort( const int agent ) const;
+
+    SimulatorStatistics statistics() const;
+
+private:
+    struct Agent {
+        std::unique_ptr< QUdpSocket > socket;
+        std::shared_ptr< Mib > mib;
+        AgentConfig config;
+    };
+
+    struct PendingResponse {
+        int agent = 0;
+        QByteArray datagram;
+        QHostAddress address;
+        quint16 port = 0;
+    };
+
+    enum Counter {
+        REQUESTS,
+        RESPONSES,
+        LOST,
+        DUPLICATES,
+        REORDERED,
+        TOO_BIG,
+        INVALID_REQUESTS,
+        COUNTER_COUNT
+    };
+
+private:
+    void readDatagrams( const int agent );
+    bool makeResponse( Agent*const,
+                       const QByteArray& request,
+                       QByteArray*const response );
+    void schedule( const PendingResponse&,
+                   const qint64 delay_usecs );
+    Q_SLOT void sendDueResponses();
+    void updateTimer();
+    bool happens( const double rate );
+    qint64 now() const;
+
+private:
+    std::shared_ptr< Mib > m_mib;
+    AgentConfig m_config;
+    std::vector< Agent > m_agents;
+    std::multimap< qint64, PendingResponse > m_pending_responses;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    std::mt19937 m_random;
+    std::atomic< quint64 > m_counters[ COUNTER_COUNT ] = {};
+};
+
+} // namespace qtsnmpsimulator
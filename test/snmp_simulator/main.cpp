@@ -0,0 +1,60 @@
+#include <Simulator.h>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+
+int main( int argc, char** argv ) {
+    QCoreApplication app( argc, argv );
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription( "Simulates SNMP (v1/v2c) agents serving a MIB from a snmpwalk dump." );
+    parser.addHelpOption();
+    parser.addPositionalArgument( "walk", "The snmpwalk -On output to serve." );
+    const QCommandLineOption address_option( "address", "The address to listen to.", "address", "127.0.0.1" );
+    const QCommandLineOption port_option( "port", "The port of the first agent.", "port", "16100" );
+    const QCommandLineOption agents_option( "agents", "The count of agents on successive ports.", "count", "1" );
+    const QCommandLineOption community_option( "community", "The community.", "community", "public" );
+    const QCommandLineOption latency_option( "latency", "The response latency in ms.", "ms", "0" );
+    const QCommandLineOption jitter_option( "jitter", "The latency jitter in ms.", "ms", "0" );
+    const QCommandLineOption loss_option( "loss", "The request loss rate [0..1].", "rate", "0" );
+    const QCommandLineOption reorder_option( "reorder", "The response reorder rate [0..1].", "rate", "0" );
+    const QCommandLineOption duplicate_option( "duplicate", "The response duplicate rate [0..1].", "rate", "0" );
+    const QCommandLineOption too_big_option( "too-big", "The maximal response size in bytes.", "bytes", "0" );
+    const QCommandLineOption seed_option( "seed", "The seed of the random generator.", "seed", "1" );
+    parser.addOptions( { address_option, port_option, agents_option, community_option,
+                         latency_option, jitter_option, loss_option, reorder_option,
+                         duplicate_option, too_big_option, seed_option } );
+    parser.process( app );
+
+    if ( 1 != parser.positionalArguments().size() ) {
+        parser.showHelp( 1 );
+    }
+
+    qtsnmpsimulator::Simulator simulator;
+    QString error;
+    if ( ! simulator.loadWalkFile( parser.positionalArguments().first(), &error ) ) {
+        qDebug() << "Unable to load the walk:" << error;
+        return 1;
+    }
+
+    qtsnmpsimulator::AgentConfig config;
+    config.community = parser.value( community_option ).toLatin1();
+    config.latency_ms = parser.value( latency_option ).toInt();
+    config.jitter_ms = parser.value( jitter_option ).toInt();
+    config.loss_rate = parser.value( loss_option ).toDouble();
+    config.reorder_rate = parser.value( reorder_option ).toDouble();
+    config.duplicate_rate = parser.value( duplicate_option ).toDouble();
+    config.too_big_threshold = parser.value( too_big_option ).toInt();
+    simulator.setConfig( config );
+    simulator.setSeed( parser.value( seed_option ).toUInt() );
+
+    const auto port = static_cast< quint16 >( parser.value( port_option ).toUInt() );
+    const int agent_count = parser.value( agents_option ).toInt();
+    if ( ! simulator.start( QHostAddress( parser.value( address_option ) ), port, agent_count, &error ) ) {
+        qDebug() << error;
+        return 1;
+    }
+
+    qDebug() << "Serving" << agent_count << "agents on ports" << port << "-" << ( port + agent_count - 1 );
+    return app.exec();
+}
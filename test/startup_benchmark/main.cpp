@@ -0,0 +1,85 @@
+#include <QtSnmpClient.h>
+#include <QtSnmpAgentConfig.h>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QDebug>
+
+namespace {
+
+    QByteArray makeConfig( const int agent_count ) {
+        QByteArray json = "[";
+        for ( int i = 0; i < agent_count; ++i ) {
+            const auto address = QHostAddress( 0x0A000000u + static_cast< quint32 >( i ) + 1 );
+            if ( i > 0 ) {
+                json += ",\n";
+            }
+            json += "{\"address\": \"" + address.toString().toLatin1() + "\", "
+                    "\"port\": 161, \"version\": \"v2c\", \"community\": \"public\", "
+                    "\"timeout\": 2000, \"get_limit\": 32, \"rate_limit\": 10}";
+        }
+        json += "]";
+        return json;
+    }
+
+} // anonymous namespace
+
+int main( int argc, char** argv ) {
+    QCoreApplication app( argc, argv );
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription( "Measures the startup of many SNMP clients configured in bulk." );
+    parser.addHelpOption();
+    const QCommandLineOption agents_option( "agents", "The count of generated agents.", "count", "20000" );
+    const QCommandLineOption file_option( "file", "The JSON file of agents to load instead.", "file" );
+    const QCommandLineOption limit_option( "limit", "The startup time limit in ms, 0 is no limit.", "ms", "1000" );
+    parser.addOptions( { agents_option, file_option, limit_option } );
+    parser.process( app );
+
+    QByteArray json;
+    if ( parser.isSet( file_option ) ) {
+        QFile file( parser.value( file_option ) );
+        if ( ! file.open( QIODevice::ReadOnly ) ) {
+            qDebug() << "Unable to read the agents:" << file.errorString();
+            return 1;
+        }
+        json = file.readAll();
+    } else {
+        json = makeConfig( parser.value( agents_option ).toInt() );
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QStringList errors;
+    const auto configs = QtSnmpAgentConfig::fromJson( json, &errors );
+    const auto load_time = timer.nsecsElapsed();
+    for ( const auto& error : errors ) {
+        qDebug() << "Skipped agent" << error;
+    }
+
+    QObject clients_parent;
+    const auto clients = QtSnmpClient::createClients( configs, &clients_parent );
+    const auto startup_time = timer.nsecsElapsed();
+
+    // NOTE: the first request of the thread creates the shared socket
+    if ( ! clients.isEmpty() ) {
+        clients.first()->requestValue( ".1.3.6.1.2.1.1.3.0" );
+    }
+    const auto first_request_time = timer.nsecsElapsed();
+
+    qDebug() << "agents:" << clients.size();
+    qDebug() << "load:" << load_time / 1000000.0 << "ms";
+    qDebug() << "create:" << ( startup_time - load_time ) / 1000000.0 << "ms";
+    qDebug() << "first request:" << ( first_request_time - startup_time ) / 1000000.0 << "ms";
+    qDebug() << "startup:" << startup_time / 1000000.0 << "ms,"
+             << ( clients.isEmpty() ? 0.0 : startup_time / 1000.0 / clients.size() ) << "us per agent";
+
+    const qint64 limit = parser.value( limit_option ).toLongLong();
+    if ( ( limit > 0 ) && ( startup_time > limit * 1000000 ) ) {
+        qDebug() << "The startup is longer than" << limit << "ms";
+        return 2;
+    }
+    return 0;
+}